@@ -1346,6 +1346,62 @@ gdbarch_register (enum bfd_architecture bfd_architecture,
   (*curr)->next = NULL;
 }
 
+/* A function registered by gdbarch_register_lazy_init, that has not
+   been called yet.  */
+
+struct gdbarch_lazy_init
+{
+  enum bfd_architecture bfd_architecture;
+  void (*init) ();
+};
+
+static std::vector<gdbarch_lazy_init> gdbarch_lazy_inits;
+
+/* See gdbarch.h.  */
+
+void
+gdbarch_register_lazy_init (enum bfd_architecture bfd_architecture,
+			    void (*init) ())
+{
+  gdbarch_lazy_inits.push_back ({ bfd_architecture, init });
+}
+
+/* See gdbarch.h.  */
+
+void
+gdbarch_run_lazy_init (enum bfd_architecture bfd_architecture)
+{
+  std::vector<void (*) ()> to_run;
+
+  for (const gdbarch_lazy_init &lazy : gdbarch_lazy_inits)
+    if (lazy.bfd_architecture == bfd_architecture)
+      to_run.push_back (lazy.init);
+
+  if (to_run.empty ())
+    return;
+
+  /* Forget about the functions before calling them, so that they are
+     not called again, even if they are registered for other
+     architectures too, or if one of them looks up an
+     architecture.  */
+  auto it = std::remove_if (gdbarch_lazy_inits.begin (),
+			    gdbarch_lazy_inits.end (),
+			    [&] (const gdbarch_lazy_init &lazy)
+    {
+      return (std::find (to_run.begin (), to_run.end (), lazy.init)
+	      != to_run.end ());
+    });
+  gdbarch_lazy_inits.erase (it, gdbarch_lazy_inits.end ());
+
+  if (gdbarch_debug)
+    gdb_printf (gdb_stdlog, "gdbarch_run_lazy_init (%s): %zu functions\n",
+		bfd_lookup_arch (bfd_architecture, 0)->printable_name,
+		to_run.size ());
+
+  for (void (*init) () : to_run)
+    init ();
+}
+
 /* Look for an architecture using gdbarch_info.  */
 
 struct gdbarch_list *
@@ -1420,6 +1476,10 @@ gdbarch_find_by_info (struct gdbarch_info info)
       return nullptr;
     }
 
+  /* Do any setup that the tdep code deferred until the architecture
+     is needed.  */
+  gdbarch_run_lazy_init (rego->bfd_architecture);
+
   /* Ask the tdep code for an architecture that matches "info".  */
   new_gdbarch = rego->init (info, rego->arches);
 
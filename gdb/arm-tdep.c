@@ -61,6 +61,7 @@
 #include "record.h"
 #include "record-full.h"
 #include <algorithm>
+#include <unordered_map>
 
 #include "producer.h"
 
@@ -11012,9 +11013,15 @@ namespace selftests
 {
 static void arm_record_test (void);
 static void arm_analyze_prologue_test ();
+static void arm_record_cache_test ();
 }
 #endif
 
+static void arm_record_memory_changed (inferior *inf, CORE_ADDR addr,
+				       ssize_t len, const bfd_byte *data);
+static void arm_record_target_resumed (ptid_t ptid);
+static void arm_record_objfile_changed (struct objfile *objfile);
+
 void _initialize_arm_tdep ();
 void
 _initialize_arm_tdep ()
@@ -11029,6 +11036,16 @@ _initialize_arm_tdep ()
   /* Add ourselves to objfile event chain.  */
   gdb::observers::new_objfile.attach (arm_exidx_new_objfile, "arm-tdep");
 
+  /* Keep the record decode cache in sync with the inferior's code.  */
+  gdb::observers::memory_changed.attach (arm_record_memory_changed,
+					 "arm-tdep");
+  gdb::observers::new_objfile.attach (arm_record_objfile_changed,
+				      "arm-tdep-record");
+  gdb::observers::free_objfile.attach (arm_record_objfile_changed,
+				       "arm-tdep-record");
+  gdb::observers::target_resumed.attach (arm_record_target_resumed,
+					 "arm-tdep");
+
   /* Register an ELF OS ABI sniffer for ARM binaries.  */
   gdbarch_register_osabi_sniffer (bfd_arch_arm,
 				  bfd_target_elf_flavour,
@@ -11147,6 +11164,8 @@ vfp - VFP co-processor."),
 #if GDB_SELF_TEST
   selftests::register_test ("arm-record", selftests::arm_record_test);
   selftests::register_test ("arm_analyze_prologue", selftests::arm_analyze_prologue_test);
+  selftests::register_test ("arm-record-cache",
+			    selftests::arm_record_cache_test);
 #endif
 
 }
@@ -14849,6 +14868,176 @@ arm_analyze_prologue_test ()
 } /* namespace selftests */
 #endif /* GDB_SELF_TEST */
 
+/* Recording an instruction decodes it to find out which registers and
+   memory it changes.  In a loop, the same instructions are recorded
+   over and over, so remember the outcome of decoding each instruction
+   that only changes registers: for those, it only depends on the
+   instruction.  Instructions that change memory, whose addresses
+   depend on register values, and system calls, are decoded every
+   time.
+
+   The cache is per inferior, and is flushed when the inferior's code
+   may have changed: when GDB writes to its memory, when objfiles come
+   and go, when the inferior makes a system call, and when it runs
+   without being recorded.  Entries covering memory the inferior writes
+   to are removed as the stores are recorded.  */
+
+struct arm_record_cache_entry
+{
+  /* The registers changed by the instruction, besides the PC.  */
+  std::vector<uint32_t> regs;
+};
+
+struct arm_record_cache
+{
+  /* The architecture the entries were decoded for.  */
+  struct gdbarch *gdbarch = nullptr;
+
+  /* The entries, by instruction address, with bit 0 set for Thumb
+     instructions.  */
+  std::unordered_map<CORE_ADDR, arm_record_cache_entry> entries;
+};
+
+static const registry<inferior>::key<arm_record_cache> arm_record_cache_key;
+
+/* Return the decode cache of the current inferior, for GDBARCH.  */
+
+static arm_record_cache *
+arm_record_get_cache (struct gdbarch *gdbarch)
+{
+  inferior *inf = current_inferior ();
+  arm_record_cache *cache = arm_record_cache_key.get (inf);
+
+  if (cache == nullptr)
+    cache = arm_record_cache_key.emplace (inf);
+
+  if (cache->gdbarch != gdbarch)
+    {
+      cache->entries.clear ();
+      cache->gdbarch = gdbarch;
+    }
+
+  return cache;
+}
+
+/* Forget the decoded instructions of INF.  */
+
+static void
+arm_record_flush_cache (inferior *inf)
+{
+  arm_record_cache *cache = arm_record_cache_key.get (inf);
+
+  if (cache != nullptr)
+    cache->entries.clear ();
+}
+
+/* Forget the decoded instructions in the LEN bytes at ADDR.  */
+
+static void
+arm_record_invalidate_cache (arm_record_cache *cache, CORE_ADDR addr,
+			     ULONGEST len)
+{
+  if (cache->entries.empty ())
+    return;
+
+  /* Large writes are rare; don't bother finding the entries.  */
+  if (len > 64)
+    {
+      cache->entries.clear ();
+      return;
+    }
+
+  /* A 32-bit instruction at ADDR - 2 overlaps ADDR.  Don't wrap
+     around below address 0.  */
+  CORE_ADDR start = align_down (addr, 2);
+  start = start >= 2 ? start - 2 : 0;
+  for (CORE_ADDR a = start; a < addr + len; a += 2)
+    {
+      cache->entries.erase (a);
+      cache->entries.erase (a | 1);
+    }
+}
+
+#if GDB_SELF_TEST
+namespace selftests {
+
+static void
+arm_record_cache_test ()
+{
+  arm_record_cache cache;
+
+  /* Writes cover the entries of the instructions they overlap, in
+     both states, down to address 0.  */
+  for (CORE_ADDR addr : { 0, 1, 2 })
+    {
+      for (CORE_ADDR key : { 0, 1, 2, 3, 4, 5 })
+	cache.entries[key] = {};
+
+      arm_record_invalidate_cache (&cache, addr, 1);
+
+      SELF_CHECK (cache.entries.count (0) == 0);
+      SELF_CHECK (cache.entries.count (1) == 0);
+      SELF_CHECK (cache.entries.count (4) == 1);
+      SELF_CHECK (cache.entries.count (5) == 1);
+    }
+
+  /* A write at 4 also covers a 32-bit instruction at 2.  */
+  cache.entries.clear ();
+  for (CORE_ADDR key : { 0, 1, 2, 3, 4, 5, 6 })
+    cache.entries[key] = {};
+  arm_record_invalidate_cache (&cache, 4, 2);
+  SELF_CHECK (cache.entries.count (0) == 1);
+  SELF_CHECK (cache.entries.count (1) == 1);
+  SELF_CHECK (cache.entries.count (2) == 0);
+  SELF_CHECK (cache.entries.count (5) == 0);
+  SELF_CHECK (cache.entries.count (6) == 1);
+}
+
+} /* namespace selftests */
+#endif /* GDB_SELF_TEST */
+
+/* Observer for the memory_changed event.  */
+
+static void
+arm_record_memory_changed (inferior *inf, CORE_ADDR addr, ssize_t len,
+			   const bfd_byte *data)
+{
+  arm_record_flush_cache (inf);
+}
+
+/* Observer for the target_resumed event.  */
+
+static void
+arm_record_target_resumed (ptid_t ptid)
+{
+  if (!record_full_is_used ())
+    for (inferior *inf : all_inferiors ())
+      arm_record_flush_cache (inf);
+}
+
+/* Observer for the new_objfile and free_objfile events.  */
+
+static void
+arm_record_objfile_changed (struct objfile *objfile)
+{
+  for (inferior *inf : all_inferiors ())
+    if (inf->pspace == objfile->pspace ())
+      arm_record_flush_cache (inf);
+}
+
+/* Return true if INSN, an ARM or 16-bit Thumb instruction, is a
+   system call.  */
+
+static bool
+arm_record_is_syscall (uint32_t insn, record_type_t record_type)
+{
+  if (record_type == ARM_RECORD)
+    return bits (insn, 28, 31) != 0xf && bits (insn, 24, 27) == 0xf;
+  if (record_type == THUMB_RECORD)
+    return bits (insn, 8, 15) == 0xdf;
+  return false;
+}
+
 /* Cleans up local record registers and memory allocations.  */
 
 static void 
@@ -14873,6 +15062,8 @@ arm_process_record (struct gdbarch *gdbarch, struct regcache *regcache,
   ULONGEST t_bit = 0, insn_id = 0;
 
   ULONGEST u_regval = 0;
+  record_type_t record_type;
+  uint32_t insn_size;
 
   arm_insn_decode_record arm_record;
 
@@ -14889,22 +15080,38 @@ arm_process_record (struct gdbarch *gdbarch, struct regcache *regcache,
 		  paddress (gdbarch, arm_record.this_addr));
     }
 
-  instruction_reader reader;
-  enum bfd_endian code_endian
-    = gdbarch_byte_order_for_code (arm_record.gdbarch);
-  arm_record.arm_insn
-    = reader.read (arm_record.this_addr, 2, code_endian);
-
   /* Check the insn, whether it is thumb or arm one.  */
 
   t_bit = arm_psr_thumb_bit (arm_record.gdbarch);
   regcache_raw_read_unsigned (arm_record.regcache, ARM_PS_REGNUM, &u_regval);
 
+  arm_record_cache *cache = arm_record_get_cache (gdbarch);
+  CORE_ADDR cache_key = insn_addr | ((u_regval & t_bit) ? 1 : 0);
+  auto it = cache->entries.find (cache_key);
+
+  if (it != cache->entries.end ())
+    {
+      /* Seen before: no need to read and decode the instruction.  */
+      record_full_arch_list_add_reg (arm_record.regcache, ARM_PC_REGNUM);
+      for (uint32_t regnum : it->second.regs)
+	if (record_full_arch_list_add_reg (arm_record.regcache, regnum))
+	  return -1;
+      if (record_full_arch_list_add_end ())
+	return -1;
+      return 0;
+    }
+
+  instruction_reader reader;
+  enum bfd_endian code_endian
+    = gdbarch_byte_order_for_code (arm_record.gdbarch);
+  arm_record.arm_insn
+    = reader.read (arm_record.this_addr, 2, code_endian);
 
   if (!(u_regval & t_bit))
     {
       /* We are decoding arm insn.  */
-      ret = decode_insn (reader, &arm_record, ARM_RECORD, ARM_INSN_SIZE_BYTES);
+      record_type = ARM_RECORD;
+      insn_size = ARM_INSN_SIZE_BYTES;
     }
   else
     {
@@ -14912,17 +15119,19 @@ arm_process_record (struct gdbarch *gdbarch, struct regcache *regcache,
       /* is it thumb2 insn?  */
       if ((0x1D == insn_id) || (0x1E == insn_id) || (0x1F == insn_id))
 	{
-	  ret = decode_insn (reader, &arm_record, THUMB2_RECORD,
-			     THUMB2_INSN_SIZE_BYTES);
+	  record_type = THUMB2_RECORD;
+	  insn_size = THUMB2_INSN_SIZE_BYTES;
 	}
       else
 	{
 	  /* We are decoding thumb insn.  */
-	  ret = decode_insn (reader, &arm_record, THUMB_RECORD,
-			     THUMB_INSN_SIZE_BYTES);
+	  record_type = THUMB_RECORD;
+	  insn_size = THUMB_INSN_SIZE_BYTES;
 	}
     }
 
+  ret = decode_insn (reader, &arm_record, record_type, insn_size);
+
   if (0 == ret)
     {
       /* Record registers.  */
@@ -14952,6 +15161,25 @@ arm_process_record (struct gdbarch *gdbarch, struct regcache *regcache,
 	ret = -1;
     }
 
+  if (0 == ret)
+    {
+      if (arm_record_is_syscall (arm_record.arm_insn, record_type))
+	cache->entries.clear ();
+      else if (arm_record.mem_rec_count != 0)
+	{
+	  for (no_of_rec = 0; no_of_rec < arm_record.mem_rec_count; no_of_rec++)
+	    arm_record_invalidate_cache (cache,
+					 arm_record.arm_mems[no_of_rec].addr,
+					 arm_record.arm_mems[no_of_rec].len);
+	}
+      else
+	{
+	  arm_record_cache_entry &entry = cache->entries[cache_key];
+
+	  entry.regs.assign (arm_record.arm_regs,
+			     arm_record.arm_regs + arm_record.reg_rec_count);
+	}
+    }
 
   deallocate_reg_mem (&arm_record);
 
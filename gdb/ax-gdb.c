@@ -924,6 +924,7 @@ gen_cast (struct agent_expr *ax, struct axs_value *value, struct type *type)
       break;
 
     case TYPE_CODE_INT:
+    case TYPE_CODE_CHAR:
       gen_conversion (ax, value->type, type);
       break;
 
@@ -1344,7 +1345,22 @@ gen_struct_ref_recursive (struct agent_expr *ax, struct axs_value *value,
     {
       const char *this_name = type->field (i).name ();
 
-      if (this_name)
+      if (this_name != nullptr && this_name[0] == '\0')
+	{
+	  /* An anonymous structure or union; its members are
+	     accessed as if they were members of TYPE.  */
+	  struct type *field_type = check_typedef (type->field (i).type ());
+
+	  if ((field_type->code () == TYPE_CODE_STRUCT
+	       || field_type->code () == TYPE_CODE_UNION)
+	      && gen_struct_ref_recursive (ax, value, field,
+					   offset
+					   + (type->field (i).loc_bitpos ()
+					      / TARGET_CHAR_BIT),
+					   field_type))
+	    return 1;
+	}
+      else if (this_name)
 	{
 	  if (strcmp (field, this_name) == 0)
 	    {
@@ -1365,10 +1381,6 @@ gen_struct_ref_recursive (struct agent_expr *ax, struct axs_value *value,
 	      gen_primitive_field (ax, value, offset, i, type);
 	      return 1;
 	    }
-#if 0 /* is this right? */
-	  if (this_name[0] == '\0')
-	    internal_error (_("find_field: anonymous unions not supported"));
-#endif
 	}
     }
 
@@ -1389,6 +1401,103 @@ gen_struct_ref_recursive (struct agent_expr *ax, struct axs_value *value,
   return 0;
 }
 
+/* Look for the non-static data member named FIELD in TYPE, its base
+   classes, and its anonymous structure and union members.  BITPOS is
+   the bit offset of TYPE within the outermost object.  If found,
+   return the member's type and set *FIELD_BITPOS and *FIELD_BITSIZE
+   to its position and size in bits within the outermost object;
+   otherwise return nullptr.  */
+
+static struct type *
+find_field_bits (struct type *type, const char *field, LONGEST bitpos,
+		 LONGEST *field_bitpos, LONGEST *field_bitsize)
+{
+  type = check_typedef (type);
+
+  for (int i = TYPE_N_BASECLASSES (type); i < type->num_fields (); i++)
+    {
+      const char *this_name = type->field (i).name ();
+
+      if (this_name == nullptr || type->field (i).is_static ())
+	continue;
+
+      LONGEST this_bitpos = bitpos + type->field (i).loc_bitpos ();
+      struct type *field_type = type->field (i).type ();
+
+      if (strcmp (field, this_name) == 0)
+	{
+	  *field_bitpos = this_bitpos;
+	  if (type->field (i).is_packed ())
+	    *field_bitsize = type->field (i).bitsize ();
+	  else
+	    *field_bitsize = (check_typedef (field_type)->length ()
+			      * TARGET_CHAR_BIT);
+	  return field_type;
+	}
+
+      if (this_name[0] == '\0')
+	{
+	  struct type *found = find_field_bits (field_type, field,
+						this_bitpos, field_bitpos,
+						field_bitsize);
+	  if (found != nullptr)
+	    return found;
+	}
+    }
+
+  for (int i = 0; i < TYPE_N_BASECLASSES (type); i++)
+    {
+      struct type *found
+	= find_field_bits (TYPE_BASECLASS (type, i), field,
+			   bitpos + TYPE_BASECLASS_BITPOS (type, i),
+			   field_bitpos, field_bitsize);
+      if (found != nullptr)
+	return found;
+    }
+
+  return nullptr;
+}
+
+/* Generate code to extract the member named FIELD from the structure
+   or union of type TYPE described by VALUE, which does not live in
+   memory.  This happens for small structures held in a register, or
+   assembled from pieces (DW_OP_piece) into a single stack entry,
+   which is common for structures passed or returned in registers,
+   for instance on ARM.  */
+
+static void
+gen_struct_ref_in_word (struct agent_expr *ax, struct axs_value *value,
+			const char *field, struct type *type)
+{
+  /* The object must fit in a stack entry, and we only know how bytes
+     map to bits for little-endian targets.  */
+  if (type->length () > sizeof (LONGEST)
+      || gdbarch_byte_order (ax->gdbarch) != BFD_ENDIAN_LITTLE
+      || (value->kind == axs_lvalue_register
+	  && type->length () > register_size (ax->gdbarch, value->u.reg)))
+    error (_("Structure does not live in memory."));
+
+  LONGEST bitpos, bitsize;
+  struct type *field_type = find_field_bits (type, field, 0, &bitpos,
+					     &bitsize);
+  if (field_type == nullptr)
+    error (_("Couldn't find member named `%s' in struct/union/class `%s'"),
+	   field, type->name ());
+
+  field_type = check_typedef (field_type);
+  if (!is_integral_type (field_type)
+      && !field_type->is_pointer_or_reference ())
+    error (_("Structure does not live in memory."));
+
+  if (value->kind == axs_lvalue_register)
+    ax_reg (ax, value->u.reg);
+  gen_left_shift (ax, -bitpos);
+  ((field_type->is_unsigned () ? ax_zero_ext : ax_ext) (ax, bitsize));
+
+  value->kind = axs_rvalue;
+  value->type = field_type;
+}
+
 /* Generate code to reference the member named FIELD of a structure or
    union.  The top of the stack, as described by VALUE, should have
    type (pointer to a)* struct/union.  OPERATOR_NAME is the name of
@@ -1418,10 +1527,13 @@ gen_struct_ref (struct agent_expr *ax, struct axs_value *value,
     error (_("The left operand of `%s' is not a %s."),
 	   operator_name, operand_name);
 
-  /* And it must be in memory; we don't deal with structure rvalues,
-     or structures living in registers.  */
+  /* Structures that don't live in memory can only be handled if
+     they fit in a single stack entry.  */
   if (value->kind != axs_lvalue_memory)
-    error (_("Structure does not live in memory."));
+    {
+      gen_struct_ref_in_word (ax, value, field, type);
+      return;
+    }
 
   /* Search through fields and base classes recursively.  */
   found = gen_struct_ref_recursive (ax, value, field, 0, type);
@@ -1993,6 +2105,31 @@ unop_cast_type_operation::do_generate_ax (struct expression *exp,
   std::get<1> (m_storage)->generate_ax (exp, ax, value, val->type ());
 }
 
+void
+func_static_var_operation::do_generate_ax (struct expression *exp,
+					   struct agent_expr *ax,
+					   struct axs_value *value,
+					   struct type *cast_type)
+{
+  /* Find the function's block the same way the evaluator does; only
+     the function's address is needed, not its contents.  */
+  struct value *func
+    = std::get<0> (m_storage)->evaluate (nullptr, exp,
+					 EVAL_AVOID_SIDE_EFFECTS);
+  const char *var = std::get<1> (m_storage).c_str ();
+  const block *blk = block_for_pc (func->address ());
+  struct block_symbol sym = lookup_symbol (var, blk, SEARCH_VAR_DOMAIN,
+					   nullptr);
+  if (sym.symbol == nullptr)
+    error (_("No symbol \"%s\" in specified context."), var);
+
+  gen_var_ref (ax, value, sym.symbol);
+
+  if (value->optimized_out)
+    error (_("`%s' has been optimized out, cannot use"),
+	   sym.symbol->print_name ());
+}
+
 void
 var_value_operation::do_generate_ax (struct expression *exp,
 				     struct agent_expr *ax,
@@ -2165,6 +2302,12 @@ gen_expr_binop_rest (struct expression *exp,
 	  error (_("Argument to arithmetic operation "
 		   "not a number or boolean."));
 
+	/* Indices of character, boolean or enumeration type are
+	   already fully extended on the stack; treat them as plain
+	   integers for the address computation.  */
+	if (strip_range_type (value2->type)->code () != TYPE_CODE_INT)
+	  value2->type = builtin_type (ax->gdbarch)->builtin_long;
+
 	gen_ptradd (ax, value, value1, value2);
 	gen_deref (value);
 	break;
@@ -0,0 +1,601 @@
+/* Host-side evaluation of agent expressions for GDB.
+   Copyright (C) 2025 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "ax-host.h"
+#include "ax-gdb.h"
+#include "extract-store-integer.h"
+#include "gdbarch.h"
+#include "regcache.h"
+#include "target.h"
+#include "memattr.h"
+#include "inferior.h"
+#include "gdbsupport/selftest.h"
+#include "test-target.h"
+#include "scoped-mock-context.h"
+
+/* Extract an N-byte big-endian unsigned integer from the bytecode of
+   AX at offset O.  */
+
+static ULONGEST
+read_operand (const agent_expr *ax, size_t o, int n)
+{
+  ULONGEST accum = 0;
+
+  for (int i = 0; i < n; i++)
+    accum = (accum << 8) | ax->buf[o + i];
+
+  return accum;
+}
+
+/* Return the size of the operand that follows opcode OP in the
+   bytecode stream, or -1 if OP is not supported by the host
+   evaluator.  */
+
+static int
+host_operand_size (enum agent_op op)
+{
+  switch (op)
+    {
+    case aop_add:
+    case aop_sub:
+    case aop_mul:
+    case aop_div_signed:
+    case aop_div_unsigned:
+    case aop_rem_signed:
+    case aop_rem_unsigned:
+    case aop_lsh:
+    case aop_rsh_signed:
+    case aop_rsh_unsigned:
+    case aop_log_not:
+    case aop_bit_and:
+    case aop_bit_or:
+    case aop_bit_xor:
+    case aop_bit_not:
+    case aop_equal:
+    case aop_less_signed:
+    case aop_less_unsigned:
+    case aop_ref8:
+    case aop_ref16:
+    case aop_ref32:
+    case aop_ref64:
+    case aop_end:
+    case aop_dup:
+    case aop_pop:
+    case aop_swap:
+    case aop_rot:
+      return 0;
+
+    case aop_ext:
+    case aop_zero_ext:
+    case aop_const8:
+    case aop_pick:
+      return 1;
+
+    case aop_const16:
+    case aop_reg:
+    case aop_goto:
+    case aop_if_goto:
+      return 2;
+
+    case aop_const32:
+      return 4;
+
+    case aop_const64:
+      return 8;
+
+    default:
+      /* Tracing, trace state variables, printf and floating point
+	 are only meaningful to an agent.  */
+      return -1;
+    }
+}
+
+/* Map the remote register number REMOTE_REGNUM back to a GDB raw
+   register number of GDBARCH.  Return -1 if there is none.  */
+
+static int
+gdb_regnum_from_remote (struct gdbarch *gdbarch, int remote_regnum)
+{
+  for (int regnum = 0; regnum < gdbarch_num_regs (gdbarch); regnum++)
+    if (gdbarch_remote_register_number (gdbarch, regnum) == remote_regnum)
+      return regnum;
+
+  return -1;
+}
+
+/* See ax-host.h.  */
+
+ax_host_program_up
+ax_host_program::lower (agent_expr *ax)
+{
+  ax_reqs (ax);
+  if (ax->flaw != agent_flaw_none
+      || ax->min_height < 0
+      || ax->max_height >= max_stack)
+    return nullptr;
+
+  ax_host_program_up prog (new ax_host_program (ax->gdbarch));
+
+  /* Map from bytecode offsets to instruction indices, used to
+     resolve jump targets once all instructions are known.  */
+  std::vector<int> index_of (ax->buf.size (), -1);
+
+  for (size_t i = 0; i < ax->buf.size ();)
+    {
+      enum agent_op op = (enum agent_op) ax->buf[i];
+      int operand_size = host_operand_size (op);
+
+      if (operand_size < 0 || i + 1 + operand_size > ax->buf.size ())
+	return nullptr;
+
+      insn in { op, read_operand (ax, i + 1, operand_size) };
+
+      if (op == aop_reg)
+	{
+	  int regnum = gdb_regnum_from_remote (ax->gdbarch, in.arg);
+
+	  if (regnum < 0 || register_size (ax->gdbarch, regnum) > 8)
+	    return nullptr;
+	  in.arg = regnum;
+	}
+      else if ((op == aop_ext || op == aop_zero_ext)
+	       && (in.arg == 0 || in.arg > 64))
+	return nullptr;
+
+      index_of[i] = prog->m_insns.size ();
+      prog->m_insns.push_back (in);
+      i += 1 + operand_size;
+    }
+
+  if (prog->m_insns.empty () || prog->m_insns.back ().op != aop_end)
+    return nullptr;
+
+  for (insn &in : prog->m_insns)
+    if (in.op == aop_goto || in.op == aop_if_goto)
+      {
+	/* ax_reqs already checked that jump targets are on
+	   instruction boundaries.  */
+	gdb_assert (in.arg < index_of.size () && index_of[in.arg] >= 0);
+	in.arg = index_of[in.arg];
+      }
+
+  return prog;
+}
+
+namespace {
+
+/* A tiny, fixed-size read cache used during a single evaluation.
+   Memory is fetched a line at a time, so that consecutive field
+   accesses through the same pointer only cost one target read.  */
+
+class ax_host_memory
+{
+public:
+  /* Read LEN bytes at ADDR into BUF.  Return true on success.  */
+  bool read (CORE_ADDR addr, gdb_byte *buf, int len);
+
+private:
+  static constexpr int line_size = 32;
+  static constexpr int num_lines = 4;
+
+  struct line
+  {
+    CORE_ADDR addr;
+    bool valid = false;
+    gdb_byte data[line_size];
+  };
+
+  /* Return true if the whole line starting at LINE_ADDR may be read
+     even though only part of it was asked for.  */
+  static bool can_read_line (CORE_ADDR line_addr);
+
+  line m_lines[num_lines];
+
+  /* The next line to evict.  */
+  int m_next = 0;
+};
+
+bool
+ax_host_memory::can_read_line (CORE_ADDR line_addr)
+{
+  mem_region *region = lookup_mem_region (line_addr);
+
+  if (region->attrib.mode == MEM_NONE
+      || region->attrib.mode == MEM_WO
+      || region->attrib.width != MEM_WIDTH_UNSPECIFIED)
+    return false;
+
+  return (line_addr >= region->lo
+	  && (region->hi == 0 || line_addr + line_size <= region->hi));
+}
+
+bool
+ax_host_memory::read (CORE_ADDR addr, gdb_byte *buf, int len)
+{
+  CORE_ADDR line_addr = addr & ~(CORE_ADDR) (line_size - 1);
+
+  /* Accesses that straddle a line are rare; just read them
+     directly.  */
+  if (addr + len > line_addr + line_size)
+    return target_read_memory (addr, buf, len) == 0;
+
+  for (line &l : m_lines)
+    if (l.valid && l.addr == line_addr)
+      {
+	memcpy (buf, l.data + (addr - line_addr), len);
+	return true;
+      }
+
+  if (can_read_line (line_addr))
+    {
+      line &l = m_lines[m_next];
+
+      if (target_read_memory (line_addr, l.data, line_size) == 0)
+	{
+	  l.addr = line_addr;
+	  l.valid = true;
+	  m_next = (m_next + 1) % num_lines;
+	  memcpy (buf, l.data + (addr - line_addr), len);
+	  return true;
+	}
+    }
+
+  /* Either the line can't be read as a whole, or part of it is
+     inaccessible.  Fall back to reading exactly what was asked
+     for.  */
+  return target_read_memory (addr, buf, len) == 0;
+}
+
+} /* anonymous namespace */
+
+/* See ax-host.h.  */
+
+bool
+ax_host_program::evaluate (regcache *regcache, ULONGEST *result) const
+{
+  enum bfd_endian byte_order = gdbarch_byte_order (m_gdbarch);
+  ULONGEST stack[max_stack];
+  int sp = 0;
+  ax_host_memory memory;
+  gdb_byte buf[8];
+
+  if (regcache->arch () != m_gdbarch)
+    return false;
+
+  for (size_t pc = 0; pc < m_insns.size (); pc++)
+    {
+      const insn &in = m_insns[pc];
+
+      switch (in.op)
+	{
+	case aop_add:
+	  sp--;
+	  stack[sp - 1] += stack[sp];
+	  break;
+
+	case aop_sub:
+	  sp--;
+	  stack[sp - 1] -= stack[sp];
+	  break;
+
+	case aop_mul:
+	  sp--;
+	  stack[sp - 1] *= stack[sp];
+	  break;
+
+	case aop_div_signed:
+	  sp--;
+	  if (stack[sp] == 0
+	      || ((LONGEST) stack[sp] == -1
+		  && stack[sp - 1] == (ULONGEST) 1 << 63))
+	    return false;
+	  stack[sp - 1] = (LONGEST) stack[sp - 1] / (LONGEST) stack[sp];
+	  break;
+
+	case aop_div_unsigned:
+	  sp--;
+	  if (stack[sp] == 0)
+	    return false;
+	  stack[sp - 1] /= stack[sp];
+	  break;
+
+	case aop_rem_signed:
+	  sp--;
+	  if (stack[sp] == 0
+	      || ((LONGEST) stack[sp] == -1
+		  && stack[sp - 1] == (ULONGEST) 1 << 63))
+	    return false;
+	  stack[sp - 1] = (LONGEST) stack[sp - 1] % (LONGEST) stack[sp];
+	  break;
+
+	case aop_rem_unsigned:
+	  sp--;
+	  if (stack[sp] == 0)
+	    return false;
+	  stack[sp - 1] %= stack[sp];
+	  break;
+
+	case aop_lsh:
+	  sp--;
+	  stack[sp - 1] = stack[sp] >= 64 ? 0 : stack[sp - 1] << stack[sp];
+	  break;
+
+	case aop_rsh_signed:
+	  sp--;
+	  stack[sp - 1] = ((LONGEST) stack[sp - 1]
+			   >> (stack[sp] >= 64 ? 63 : stack[sp]));
+	  break;
+
+	case aop_rsh_unsigned:
+	  sp--;
+	  stack[sp - 1] = stack[sp] >= 64 ? 0 : stack[sp - 1] >> stack[sp];
+	  break;
+
+	case aop_log_not:
+	  stack[sp - 1] = !stack[sp - 1];
+	  break;
+
+	case aop_bit_and:
+	  sp--;
+	  stack[sp - 1] &= stack[sp];
+	  break;
+
+	case aop_bit_or:
+	  sp--;
+	  stack[sp - 1] |= stack[sp];
+	  break;
+
+	case aop_bit_xor:
+	  sp--;
+	  stack[sp - 1] ^= stack[sp];
+	  break;
+
+	case aop_bit_not:
+	  stack[sp - 1] = ~stack[sp - 1];
+	  break;
+
+	case aop_equal:
+	  sp--;
+	  stack[sp - 1] = stack[sp - 1] == stack[sp];
+	  break;
+
+	case aop_less_signed:
+	  sp--;
+	  stack[sp - 1] = (LONGEST) stack[sp - 1] < (LONGEST) stack[sp];
+	  break;
+
+	case aop_less_unsigned:
+	  sp--;
+	  stack[sp - 1] = stack[sp - 1] < stack[sp];
+	  break;
+
+	case aop_ext:
+	  if (in.arg < 64)
+	    {
+	      ULONGEST mask = (ULONGEST) 1 << (in.arg - 1);
+
+	      stack[sp - 1] &= ((ULONGEST) 1 << in.arg) - 1;
+	      stack[sp - 1] = (stack[sp - 1] ^ mask) - mask;
+	    }
+	  break;
+
+	case aop_zero_ext:
+	  if (in.arg < 64)
+	    stack[sp - 1] &= ((ULONGEST) 1 << in.arg) - 1;
+	  break;
+
+	case aop_ref8:
+	case aop_ref16:
+	case aop_ref32:
+	case aop_ref64:
+	  {
+	    int len = (in.op == aop_ref8 ? 1
+		       : in.op == aop_ref16 ? 2
+		       : in.op == aop_ref32 ? 4 : 8);
+
+	    if (!memory.read (stack[sp - 1], buf, len))
+	      return false;
+	    stack[sp - 1] = extract_unsigned_integer (buf, len, byte_order);
+	  }
+	  break;
+
+	case aop_if_goto:
+	  sp--;
+	  if (stack[sp] != 0)
+	    pc = in.arg - 1;
+	  break;
+
+	case aop_goto:
+	  pc = in.arg - 1;
+	  break;
+
+	case aop_const8:
+	case aop_const16:
+	case aop_const32:
+	case aop_const64:
+	  stack[sp++] = in.arg;
+	  break;
+
+	case aop_reg:
+	  {
+	    int regnum = in.arg;
+	    int len = register_size (m_gdbarch, regnum);
+
+	    if (regcache->raw_read (regnum, buf) != REG_VALID)
+	      return false;
+	    stack[sp++] = extract_unsigned_integer (buf, len, byte_order);
+	  }
+	  break;
+
+	case aop_end:
+	  if (sp <= 0)
+	    return false;
+	  *result = stack[sp - 1];
+	  return true;
+
+	case aop_dup:
+	  stack[sp] = stack[sp - 1];
+	  sp++;
+	  break;
+
+	case aop_pop:
+	  sp--;
+	  break;
+
+	case aop_pick:
+	  /* ax_reqs does not check PICK's depth, so a malformed
+	     expression could reach below the bottom of the stack.  */
+	  if (in.arg >= (ULONGEST) sp)
+	    return false;
+	  stack[sp] = stack[sp - 1 - in.arg];
+	  sp++;
+	  break;
+
+	case aop_rot:
+	  {
+	    ULONGEST tem = stack[sp - 3];
+
+	    stack[sp - 3] = stack[sp - 2];
+	    stack[sp - 2] = stack[sp - 1];
+	    stack[sp - 1] = tem;
+	  }
+	  break;
+
+	case aop_swap:
+	  std::swap (stack[sp - 1], stack[sp - 2]);
+	  break;
+
+	default:
+	  gdb_assert_not_reached ("unexpected opcode in host program");
+	}
+
+      /* ax_reqs has proved the stack height statically, but be
+	 defensive.  */
+      if (sp < 0 || sp >= max_stack)
+	return false;
+    }
+
+  return false;
+}
+
+/* See ax-host.h.  */
+
+ax_host_program_up
+ax_host_compile (CORE_ADDR scope, struct expression *expr)
+{
+  try
+    {
+      agent_expr_up ax = gen_eval_for_expr (scope, expr);
+
+      return ax_host_program::lower (ax.get ());
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      /* The expression uses something that can't be expressed as
+	 bytecode.  */
+      return nullptr;
+    }
+}
+
+#if GDB_SELF_TEST
+namespace selftests {
+namespace ax_host {
+
+/* Build an agent expression for the architecture of MOCK from the
+   bytes in CODE, lower it and evaluate it.  */
+
+static std::optional<ULONGEST>
+run (scoped_mock_context<test_target_ops> &mock,
+     const std::vector<gdb_byte> &code)
+{
+  agent_expr ax (mock.mock_inferior.arch (), 0);
+
+  ax.buf.assign (code.begin (), code.end ());
+
+  ax_host_program_up prog = ax_host_program::lower (&ax);
+  if (prog == nullptr)
+    return {};
+
+  ULONGEST result;
+  if (!prog->evaluate (get_thread_regcache (&mock.mock_thread), &result))
+    return {};
+
+  return result;
+}
+
+static void
+test_ax_host ()
+{
+  scoped_restore_current_pspace_and_thread restore;
+  scoped_mock_context<test_target_ops> mock (current_inferior ()->arch ());
+
+  /* 7 - 3 == 4.  */
+  SELF_CHECK (run (mock, { aop_const8, 7, aop_const8, 3, aop_sub,
+			   aop_const8, 4, aop_equal, aop_end }) == 1);
+
+  /* Signed comparison after sign extension: (int8) 0xff < 1.  */
+  SELF_CHECK (run (mock, { aop_const8, 0xff, aop_ext, 8, aop_const8, 1,
+			   aop_less_signed, aop_end }) == 1);
+  SELF_CHECK (run (mock, { aop_const8, 0xff, aop_const8, 1,
+			   aop_less_unsigned, aop_end }) == 0);
+
+  /* A conditional, as generated for "0 ? 1 : 0": the jump skips
+     over the else branch.  */
+  SELF_CHECK (run (mock, { aop_const8, 0, aop_if_goto, 0, 10,
+			   aop_const8, 0, aop_goto, 0, 12,
+			   aop_const8, 1, aop_end }) == 0);
+
+  /* Division by zero makes evaluation fail, so the caller falls
+     back to the regular evaluator.  */
+  SELF_CHECK (!run (mock, { aop_const8, 1, aop_const8, 0,
+			    aop_div_signed, aop_end }).has_value ());
+
+  /* Stack manipulation.  */
+  SELF_CHECK (run (mock, { aop_const8, 1, aop_const8, 2, aop_swap,
+			   aop_sub, aop_end }) == 1);
+  SELF_CHECK (run (mock, { aop_const8, 5, aop_dup, aop_mul,
+			   aop_end }) == 25);
+  SELF_CHECK (run (mock, { aop_const8, 7, aop_const8, 2, aop_pick, 1,
+			   aop_swap, aop_pop, aop_swap, aop_pop,
+			   aop_end }) == 7);
+
+  /* A PICK deeper than the stack makes evaluation fail instead of
+     reading past the stack.  */
+  SELF_CHECK (!run (mock, { aop_const8, 1, aop_pick, 1,
+			    aop_end }).has_value ());
+  SELF_CHECK (!run (mock, { aop_const8, 1, aop_pick, 200,
+			    aop_end }).has_value ());
+
+  /* Operations that need an agent are rejected.  */
+  SELF_CHECK (!run (mock, { aop_getv, 0, 1, aop_end }).has_value ());
+  SELF_CHECK (!run (mock, { aop_const8, 1, aop_trace_quick, 4,
+			    aop_end }).has_value ());
+}
+
+} /* namespace ax_host */
+} /* namespace selftests */
+#endif /* GDB_SELF_TEST */
+
+void _initialize_ax_host ();
+void
+_initialize_ax_host ()
+{
+#if GDB_SELF_TEST
+  selftests::register_test ("ax-host", selftests::ax_host::test_ax_host);
+#endif
+}
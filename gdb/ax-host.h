@@ -0,0 +1,104 @@
+/* Host-side evaluation of agent expressions for GDB.
+   Copyright (C) 2025 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef GDB_AX_HOST_H
+#define GDB_AX_HOST_H
+
+#include "ax.h"
+
+struct expression;
+class regcache;
+
+/* Evaluating a parsed expression walks the tree of expr::operation
+   objects and creates a struct value for every intermediate result.
+   For breakpoint conditions that are hit very frequently, that cost
+   dominates.
+
+   An ax_host_program is an agent expression (see ax.h), as generated
+   by gen_eval_for_expr, lowered into a flat array of pre-decoded
+   instructions: constants are decoded, jump offsets are turned into
+   instruction indices, and remote register numbers are mapped back
+   to GDB register numbers.  Evaluating it does not allocate, and
+   only touches the registers and memory that the expression
+   actually reads.
+
+   Only the subset of the bytecode that is meaningful without a
+   tracing agent is supported: arithmetic, comparisons, memory
+   references and register reads.  Expressions using anything else
+   (trace state variables, tracing ops, printf, floating point) are
+   rejected when compiling, and callers are expected to fall back to
+   the regular evaluator.  */
+
+class ax_host_program
+{
+public:
+  /* The largest stack height a program may need.  Expressions that
+     need more are not compiled.  */
+  static constexpr int max_stack = 64;
+
+  /* One lowered bytecode instruction.  */
+  struct insn
+  {
+    /* The operation.  */
+    enum agent_op op;
+
+    /* The decoded operand: the value for constants, the width for
+       ext/zero_ext, the depth for pick, the GDB register number for
+       reg, and the target instruction index for goto/if_goto.  */
+    ULONGEST arg;
+  };
+
+  /* Lower AX.  Return nullptr if AX uses operations the host
+     evaluator does not support.  */
+  static std::unique_ptr<ax_host_program> lower (agent_expr *ax);
+
+  /* Evaluate this program using the registers in REGCACHE and the
+     memory of the current inferior.  On success, store the value
+     left on top of the stack in *RESULT and return true.  Return
+     false if evaluation failed (for example because memory could not
+     be read, or because of a division by zero); the caller should
+     then evaluate the original expression, which will report the
+     problem in the usual way.  */
+  bool evaluate (regcache *regcache, ULONGEST *result) const;
+
+  /* Return the number of lowered instructions.  */
+  size_t size () const
+  { return m_insns.size (); }
+
+private:
+  explicit ax_host_program (struct gdbarch *gdbarch)
+    : m_gdbarch (gdbarch)
+  {}
+
+  /* The architecture the program was compiled for.  */
+  struct gdbarch *m_gdbarch;
+
+  /* The instructions.  The last one is always aop_end.  */
+  std::vector<insn> m_insns;
+};
+
+using ax_host_program_up = std::unique_ptr<ax_host_program>;
+
+/* Translate EXPR, which is to be evaluated at address SCOPE, into a
+   host program.  Return nullptr if EXPR cannot be compiled.  This
+   never throws a gdb_exception_error.  */
+
+extern ax_host_program_up ax_host_compile (CORE_ADDR scope,
+					   struct expression *expr);
+
+#endif /* GDB_AX_HOST_H */
@@ -62,6 +62,7 @@
 #include "cli/cli-utils.h"
 #include "stack.h"
 #include "ax-gdb.h"
+#include "ax-host.h"
 #include "dummy-frame.h"
 #include "interps.h"
 #include "gdbsupport/format.h"
@@ -84,6 +85,7 @@
 #include "gdbsupport/array-view.h"
 #include <optional>
 #include "gdbsupport/common-utils.h"
+#include "gdbsupport/scope-exit.h"
 
 /* Prototypes for local functions.  */
 
@@ -1051,6 +1053,16 @@ show_condition_evaluation_mode (struct ui_file *file, int from_tty,
 		value);
 }
 
+/* Discard the compiled form of LOC's condition, if any.  This must
+   be called whenever LOC->cond changes.  */
+
+static void
+clear_host_cond (bp_location *loc)
+{
+  loc->host_cond_program.reset ();
+  loc->host_cond_compiled = false;
+}
+
 /* Parse COND_STRING in the context of LOC and set as the condition
    expression of LOC.  BP_NUM is the number of LOC's owner, LOC_NUM is
    the number of LOC within its owner.  In case of parsing error, mark
@@ -1070,6 +1082,7 @@ set_breakpoint_location_condition (const char *cond_string, bp_location *loc,
       else
 	{
 	  loc->cond = std::move (new_exp);
+	  clear_host_cond (loc);
 	  if (loc->disabled_by_cond && loc->enabled)
 	    gdb_printf (_("Breakpoint %d's condition is now valid at "
 			  "location %d, enabling.\n"),
@@ -1126,6 +1139,7 @@ set_breakpoint_condition (struct breakpoint *b, const char *exp,
 	  for (bp_location &loc : b->locations ())
 	    {
 	      loc.cond.reset ();
+	      clear_host_cond (&loc);
 	      if (loc.disabled_by_cond && loc.enabled)
 		gdb_printf (_("Breakpoint %d's condition is now valid at "
 			      "location %d, enabling.\n"),
@@ -1200,6 +1214,12 @@ set_breakpoint_condition (struct breakpoint *b, const char *exp,
       b->cond_string = make_unique_xstrdup (exp);
       b->condition_not_parsed = 0;
     }
+
+  /* Condition statistics are only meaningful for one condition.  */
+  b->cond_eval_count = 0;
+  b->cond_eval_compiled_count = 0;
+  b->cond_eval_time = {};
+
   mark_breakpoint_modified (b);
 
   notify_breakpoint_modified (b);
@@ -5212,6 +5232,49 @@ breakpoint_cond_eval (expression *exp)
   return value_true (exp->evaluate ());
 }
 
+/* True if GDB should try to compile breakpoint conditions before
+   evaluating them on the host.  */
+
+static bool compile_breakpoint_conditions = true;
+
+/* Evaluate the condition of location BL for THREAD using its compiled
+   form, compiling it first if needed.  Return an empty optional if
+   the condition can't be compiled or the compiled form could not be
+   evaluated; the caller must then evaluate the expression itself.  */
+
+static std::optional<bool>
+breakpoint_cond_eval_compiled (bp_location *bl, thread_info *thread)
+{
+  if (!compile_breakpoint_conditions)
+    return {};
+
+  /* The compiled program reads registers of the innermost frame, so
+     it's only valid when the thread is actually stopped at the
+     location.  That excludes things like ranged breakpoints.  */
+  if (bl->loc_type != bp_loc_software_breakpoint
+      && bl->loc_type != bp_loc_hardware_breakpoint)
+    return {};
+
+  if (!bl->host_cond_compiled)
+    {
+      bl->host_cond_program = ax_host_compile (bl->address, bl->cond.get ());
+      bl->host_cond_compiled = true;
+    }
+
+  if (bl->host_cond_program == nullptr)
+    return {};
+
+  regcache *regcache = get_thread_regcache (thread);
+  if (regcache_read_pc (regcache) != bl->address)
+    return {};
+
+  ULONGEST result;
+  if (!bl->host_cond_program->evaluate (regcache, &result))
+    return {};
+
+  return result != 0;
+}
+
 /* Allocate a new bpstat.  Link it to the FIFO list by BS_LINK_POINTER.  */
 
 bpstat::bpstat (struct bp_location *bl, bpstat ***bs_link_pointer)
@@ -5770,11 +5833,31 @@ bpstat_check_breakpoint_conditions (bpstat *bs, thread_info *thread)
 	}
       if (within_current_scope)
 	{
+	  auto start = std::chrono::steady_clock::now ();
+	  SCOPE_EXIT
+	    {
+	      b->cond_eval_count++;
+	      b->cond_eval_time += std::chrono::steady_clock::now () - start;
+	    };
+
 	  try
 	    {
 	      scoped_restore reset_in_cond_eval
 		= make_scoped_restore (&thread->control.in_cond_eval, true);
-	      condition_result = breakpoint_cond_eval (cond);
+
+	      std::optional<bool> compiled_result;
+	      if (w == nullptr)
+		compiled_result
+		  = breakpoint_cond_eval_compiled (bs->bp_location_at.get (),
+						   thread);
+
+	      if (compiled_result.has_value ())
+		{
+		  condition_result = *compiled_result;
+		  b->cond_eval_compiled_count++;
+		}
+	      else
+		condition_result = breakpoint_cond_eval (cond);
 	    }
 	  catch (const gdb_exception_error &ex)
 	    {
@@ -7274,6 +7357,45 @@ maintenance_info_breakpoints (const char *args, int from_tty)
   default_collect_info ();
 }
 
+/* Implement the "maintenance info breakpoint-conditions" command.  */
+
+static void
+maintenance_info_breakpoint_conditions (const char *args, int from_tty)
+{
+  ui_out *uiout = current_uiout;
+
+  ui_out_emit_table table_emitter (uiout, 5, -1, "BreakpointConditions");
+  uiout->table_header (7, ui_left, "number", "Num");
+  uiout->table_header (11, ui_right, "evaluations", "Evaluations");
+  uiout->table_header (9, ui_right, "compiled", "Compiled");
+  uiout->table_header (12, ui_right, "total-time", "Total (s)");
+  uiout->table_header (12, ui_right, "average-time", "Average (us)");
+  uiout->table_body ();
+
+  for (breakpoint &b : all_breakpoints ())
+    {
+      if (b.cond_string == nullptr)
+	continue;
+
+      if (args != nullptr && *args != '\0'
+	  && !number_is_in_list (args, b.number))
+	continue;
+
+      using namespace std::chrono;
+      double total = duration<double> (b.cond_eval_time).count ();
+      double average = (b.cond_eval_count == 0 ? 0
+			: total * 1e6 / b.cond_eval_count);
+
+      ui_out_emit_tuple tuple_emitter (uiout, "condition");
+      uiout->field_signed ("number", b.number);
+      uiout->field_unsigned ("evaluations", b.cond_eval_count);
+      uiout->field_unsigned ("compiled", b.cond_eval_compiled_count);
+      uiout->field_fmt ("total-time", "%.6f", total);
+      uiout->field_fmt ("average-time", "%.3f", average);
+      uiout->text ("\n");
+    }
+}
+
 static bool
 breakpoint_has_pc (struct breakpoint *b,
 		   struct program_space *pspace,
@@ -8288,6 +8410,7 @@ catchpoint::re_set (program_space *filter_pspace)
      will be no (possibly invalid) expression cached.  */
   bl.disabled_by_cond = true;
   bl.cond = nullptr;
+  clear_host_cond (&bl);
 
   const char *s = cond_string.get ();
   try
@@ -15001,6 +15124,30 @@ Convenience variable \"$bpnum\" contains the number of the last\n\
 breakpoint set."),
 	   &maintenanceinfolist);
 
+  add_cmd ("breakpoint-conditions", class_maintenance,
+	   maintenance_info_breakpoint_conditions, _("\
+Show statistics about breakpoint condition evaluation.\n\
+Usage: maintenance info breakpoint-conditions [LIST]\n\
+For each breakpoint with a condition, or each breakpoint in LIST,\n\
+show how many times GDB evaluated the condition, how many of those\n\
+evaluations used the compiled form of the condition, and the time\n\
+spent evaluating it.  Conditions evaluated by the target are not\n\
+counted."),
+	   &maintenanceinfolist);
+
+  add_setshow_boolean_cmd ("compile-breakpoint-conditions", class_maintenance,
+			   &compile_breakpoint_conditions, _("\
+Set whether GDB compiles breakpoint conditions before evaluating them."), _("\
+Show whether GDB compiles breakpoint conditions before evaluating them."), _("\
+When on, simple breakpoint conditions evaluated by GDB are translated to a\n\
+compact bytecode the first time they are evaluated, which is much cheaper\n\
+to evaluate than the parsed expression.  Conditions that can't be\n\
+translated are evaluated as usual."),
+			   nullptr,
+			   nullptr,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+
   add_basic_prefix_cmd ("catch", class_breakpoint, _("\
 Set catchpoints to catch events."),
 			&catch_cmdlist,
@@ -22,11 +22,13 @@
 #include "frame.h"
 #include "value.h"
 #include "ax.h"
+#include "ax-host.h"
 #include "command.h"
 #include "gdbsupport/break-common.h"
 #include "probe.h"
 #include "location.h"
 #include <vector>
+#include <chrono>
 #include "gdbsupport/array-view.h"
 #include "gdbsupport/filtered-iterator.h"
 #include "gdbsupport/iterator-range.h"
@@ -364,6 +366,15 @@ class bp_location : public refcounted_object, public intrusive_list_node<bp_loca
      condition evaluation.  */
   agent_expr_up cond_bytecode;
 
+  /* COND lowered to a program that GDB can evaluate without walking
+     the expression tree, or nullptr if COND could not be compiled.
+     Only meaningful if HOST_COND_COMPILED is true.  */
+  ax_host_program_up host_cond_program;
+
+  /* True if compiling COND was already attempted.  This must be
+     reset whenever COND changes.  */
+  bool host_cond_compiled = false;
+
   /* Signals that the condition has changed since the last time
      we updated the global location list.  This means the condition
      needs to be sent to the target again.  This is used together
@@ -902,6 +913,14 @@ struct breakpoint : public intrusive_list_node<breakpoint>
      you can back up to just before the abort.  */
   int hit_count = 0;
 
+  /* Number of times GDB evaluated this breakpoint's condition, how
+     many of those evaluations used the compiled form of the
+     condition, and the total time they took.  Reported by "maint
+     info breakpoint-conditions".  */
+  unsigned int cond_eval_count = 0;
+  unsigned int cond_eval_compiled_count = 0;
+  std::chrono::steady_clock::duration cond_eval_time {};
+
   /* Is breakpoint's condition not yet parsed because we found no
      location initially so had no context to parse the condition
      in.  */
@@ -181,6 +181,19 @@ language_defn::printchar (int c, struct type *type,
   gdb_putc ('\'', stream);
 }
 
+/* See c-lang.h.  */
+
+bool
+c_printstr_prefix_p (struct type *type, const gdb_byte *string,
+		     unsigned int length,
+		     const struct value_print_options *options)
+{
+  const char *encoding;
+
+  classify_type (type, type->arch (), &encoding);
+  return generic_printstr_prefix_p (type, string, length, encoding, options);
+}
+
 /* Print the character string STRING, printing at most LENGTH
    characters.  LENGTH is -1 if the string is nul terminated.  Each
    character is WIDTH bytes long.  Printing stops early if the number
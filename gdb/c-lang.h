@@ -127,6 +127,14 @@ extern int cp_is_vtbl_member (struct type *);
 
 extern bool c_is_string_type_p (struct type *type);
 
+/* Return true if printing the first LENGTH characters of STRING, of
+   character type TYPE, prints the same as printing a longer string
+   that starts with them would, apart from the ellipsis.  */
+
+extern bool c_printstr_prefix_p (struct type *type, const gdb_byte *string,
+				 unsigned int length,
+				 const struct value_print_options *options);
+
 /* These are in c-valprint.c.  */
 
 extern int c_textual_element_type (struct type *, char);
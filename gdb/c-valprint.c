@@ -227,6 +227,77 @@ print_unpacked_pointer (struct type *type, struct type *elttype,
     }
 }
 
+/* Print VAL, a lazy array in memory of LEN characters of type
+   ELTTYPE, which has more characters than can be printed, as a string.
+   Only read as much of the start of the array as the output depends
+   on.  Return false without printing anything if that can't be
+   read.  */
+
+static bool
+c_value_print_string_prefix (struct value *val, struct type *elttype,
+			     unsigned int len, struct ui_file *stream,
+			     const struct value_print_options *options)
+{
+  CORE_ADDR address = val->address ();
+  int eltlen = check_typedef (elttype)->length ();
+  enum bfd_endian byte_order = type_byte_order (check_typedef (val->type ()));
+  unsigned int print_max_chars = get_print_max_chars (options);
+  gdb::byte_vector buf;
+
+  /* Start with the characters that can be printed, and the one after,
+     which decides whether there is an ellipsis.  Read more when the
+     characters are multi-byte, or the last ones repeat.  */
+  unsigned int want = std::min (len, print_max_chars + 1);
+  while (true)
+    {
+      unsigned int have = buf.size () / eltlen;
+      buf.resize (want * eltlen);
+      if (target_read_memory (address + have * eltlen,
+			      buf.data () + have * eltlen,
+			      (want - have) * eltlen) != 0)
+	return false;
+
+      if (options->stop_print_at_null)
+	{
+	  /* As in c_value_print_array.  */
+	  unsigned int temp_len;
+	  int force_ellipses = 0;
+
+	  for (temp_len = 0;
+	       (temp_len < print_max_chars
+		&& extract_unsigned_integer (buf.data () + temp_len * eltlen,
+					     eltlen, byte_order) != 0);
+	       ++temp_len)
+	    ;
+
+	  if (temp_len == print_max_chars
+	      && extract_unsigned_integer (buf.data () + temp_len * eltlen,
+					   eltlen, byte_order) != 0)
+	    force_ellipses = 1;
+
+	  current_language->printstr (stream, elttype, buf.data (), temp_len,
+				      NULL, force_ellipses, options);
+	  return true;
+	}
+
+      if (want == len)
+	{
+	  current_language->printstr (stream, elttype, buf.data (), len,
+				      NULL, 0, options);
+	  return true;
+	}
+
+      if (c_printstr_prefix_p (elttype, buf.data (), want, options))
+	{
+	  current_language->printstr (stream, elttype, buf.data (), want,
+				      NULL, 1, options);
+	  return true;
+	}
+
+      want = want > len / 2 ? len : want * 2;
+    }
+}
+
 /* c_value_print helper for TYPE_CODE_ARRAY.  */
 
 static void
@@ -236,7 +307,6 @@ c_value_print_array (struct value *val,
 {
   struct type *type = check_typedef (val->type ());
   CORE_ADDR address = val->address ();
-  const gdb_byte *valaddr = val->contents_for_printing ().data ();
   struct type *unresolved_elttype = type->target_type ();
   struct type *elttype = check_typedef (unresolved_elttype);
 
@@ -253,13 +323,31 @@ c_value_print_array (struct value *val,
       len = high_bound - low_bound + 1;
 
       /* Print arrays of textual chars with a string syntax, as
-	 long as the entire array is valid.  */
-      if (c_textual_element_type (unresolved_elttype,
-				  options->format)
+	 long as the entire array is valid.  Large arrays are only read
+	 as far as the string printed, and are printed element by
+	 element, as arrays that are not entirely available are, if
+	 that fails.  Other arrays may not have been fetched yet, in
+	 which case value_print_array_elements reads the elements as it
+	 prints them.  */
+      bool textual = c_textual_element_type (unresolved_elttype,
+					     options->format);
+      if (textual && val_print_array_lazily_p (val, options,
+					       current_language))
+	{
+	  if (c_value_print_string_prefix (val, unresolved_elttype, len,
+					   stream, options))
+	    return;
+	  textual = false;
+	}
+      else if (textual && val->lazy ())
+	val->fetch_lazy ();
+
+      if (textual
 	  && val->bytes_available (0, type->length ())
 	  && !val->bits_any_optimized_out (0,
 					   TARGET_CHAR_BIT * type->length ()))
 	{
+	  const gdb_byte *valaddr = val->contents_for_printing ().data ();
 	  int force_ellipses = 0;
 
 	  /* If requested, look for the first null char and only
@@ -315,7 +403,8 @@ c_value_print_array (struct value *val,
   else
     {
       /* Array of unspecified length: treat like pointer to first elt.  */
-      print_unpacked_pointer (type, elttype, unresolved_elttype, valaddr,
+      print_unpacked_pointer (type, elttype, unresolved_elttype,
+			      val->contents_for_printing ().data (),
 			      0, address, stream, recurse, options);
     }
 }
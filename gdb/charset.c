@@ -20,6 +20,7 @@
 #include "charset.h"
 #include "cli/cli-cmds.h"
 #include "gdbsupport/gdb_obstack.h"
+#include "gdbsupport/byte-vector.h"
 #include "gdbsupport/gdb_wait.h"
 #include "charset-list.h"
 #include "gdbsupport/environ.h"
@@ -591,6 +592,7 @@ wchar_iterator::wchar_iterator (const gdb_byte *input, size_t bytes,
 : m_input (input),
   m_bytes (bytes),
   m_width (width),
+  m_charset (charset),
   m_out (1)
 {
   m_desc = iconv_open (INTERMEDIATE_ENCODING, charset);
@@ -690,6 +692,67 @@ wchar_iterator::iterate (enum wchar_iterate_result *out_result,
   return -1;
 }
 
+/* Return true if converting two copies of BUF, of LEN bytes, from
+   CHARSET, starting in the initial conversion state, gives the
+   NUM_CHARS characters CHARS twice.  */
+
+static bool
+repeats_convert_alike (const char *charset, const gdb_byte *buf, size_t len,
+		       const gdb_wchar_t *chars, int num_chars)
+{
+  iconv_wrapper desc (INTERMEDIATE_ENCODING, charset);
+
+  gdb::byte_vector input (2 * len);
+  memcpy (input.data (), buf, len);
+  memcpy (input.data () + len, buf, len);
+
+  /* Leave room for one more character, to see if there is one.  */
+  gdb::def_vector<gdb_wchar_t> output (2 * num_chars + 1);
+
+  ICONV_CONST char *inp = (ICONV_CONST char *) input.data ();
+  size_t inleft = input.size ();
+  char *outp = (char *) output.data ();
+  size_t outleft = output.size () * sizeof (gdb_wchar_t);
+  if (desc.convert (&inp, &inleft, &outp, &outleft) == (size_t) -1
+      || inleft != 0)
+    return false;
+
+  size_t num = output.size () - outleft / sizeof (gdb_wchar_t);
+  size_t size = num_chars * sizeof (gdb_wchar_t);
+  return (num == 2 * num_chars
+	  && memcmp (output.data (), chars, size) == 0
+	  && memcmp (output.data () + num_chars, chars, size) == 0);
+}
+
+size_t
+wchar_iterator::skip_repeats (const gdb_byte *buf, size_t len,
+			      const gdb_wchar_t *chars, int num_chars)
+{
+  if (len == 0 || len % m_width != 0)
+    return 0;
+
+  size_t count = count_repeated_units (buf, len, m_input, m_bytes / len);
+  if (count == 0)
+    return 0;
+
+  /* In a stateful encoding, such as UTF-7, ISO-2022-JP or UTF-16 with
+     a byte order mark, the same bytes can convert to different
+     characters depending on what came before them.  Only skip the repetitions if
+     two copies of the bytes convert to the same characters twice from
+     the initial state, which is not the case for a byte order mark,
+     or for bytes that depend on the shift state left by earlier input.
+     Invalid input bytes leave the state alone, so their repetitions
+     are invalid too.  */
+  if (num_chars > 0
+      && !repeats_convert_alike (m_charset.c_str (), buf, len,
+				 chars, num_chars))
+    return 0;
+
+  m_input += count * len;
+  m_bytes -= count * len;
+  return count;
+}
+
 struct charset_vector
 {
   ~charset_vector ()
@@ -126,6 +126,15 @@ class wchar_iterator
   int iterate (enum wchar_iterate_result *out_result, gdb_wchar_t **out_chars,
 	       const gdb_byte **ptr, size_t *len);
 
+  /* BUF and LEN describe the input bytes of a character just returned
+     by iterate, and CHARS and NUM_CHARS what they converted to;
+     NUM_CHARS is zero for invalid input bytes.  If the following input
+     repeats those bytes, and the repetitions convert to the same
+     characters, skip them without converting them one by one, and
+     return how many were skipped.  */
+  size_t skip_repeats (const gdb_byte *buf, size_t len,
+		       const gdb_wchar_t *chars, int num_chars);
+
  private:
 
   /* The underlying iconv descriptor.  */
@@ -143,6 +152,9 @@ class wchar_iterator
   /* The width of an input character.  */
   size_t m_width;
 
+  /* The character set of the input.  */
+  std::string m_charset;
+
   /* The output buffer.  */
   gdb::def_vector<gdb_wchar_t> m_out;
 };
@@ -461,6 +461,9 @@ do_set_command (const char *arg, int from_tty, struct cmd_list_element *c)
 
   c->func (NULL, from_tty, c);
 
+  if (option_changed)
+    gdb::observers::setting_changed.notify ();
+
   if (notify_command_param_changed_p (option_changed, c))
     {
       char *name, *cp;
@@ -93,6 +93,7 @@
 #include "dwarf2/abbrev-table-cache.h"
 #include "cooked-index.h"
 #include "gdbsupport/thread-pool.h"
+#include "gdbsupport/trace-events.h"
 #include "run-on-main-thread.h"
 #include "dwarf2/parent-map.h"
 #include "dwarf2/error.h"
@@ -1671,6 +1672,13 @@ dw2_instantiate_symtab (dwarf2_per_cu *per_cu, dwarf2_per_objfile *per_objfile,
 {
   if (!per_objfile->symtab_set_p (per_cu))
     {
+      gdb::trace_events::scoped_event trace_event ("symtab",
+						   "DWARF expand symtab");
+      if (trace_event.active ())
+	trace_event.set_detail
+	  (string_printf ("%s+%s", objfile_name (per_objfile->objfile),
+			  sect_offset_str (per_cu->sect_off)));
+
       free_cached_comp_units freer (per_objfile);
       scoped_restore decrementer = increment_reading_symtab ();
       dw2_do_instantiate_symtab (per_cu, per_objfile, skip_partial);
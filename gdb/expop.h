@@ -802,6 +802,14 @@ class func_static_var_operation
 
   enum exp_opcode opcode () const override
   { return OP_FUNC_STATIC_VAR; }
+
+protected:
+
+  void do_generate_ax (struct expression *exp,
+		       struct agent_expr *ax,
+		       struct axs_value *value,
+		       struct type *cast_type)
+    override;
 };
 
 class last_operation
@@ -2083,6 +2091,25 @@ class cxx_cast_operation
 
   enum exp_opcode opcode () const override
   { return OP; }
+
+protected:
+
+  void do_generate_ax (struct expression *exp,
+		       struct agent_expr *ax,
+		       struct axs_value *value,
+		       struct type *cast_type)
+    override
+  {
+    /* A dynamic_cast needs run-time type information, which the
+       agent doesn't have.  */
+    if (OP == UNOP_DYNAMIC_CAST)
+      error (_("Cannot translate to agent expression"));
+
+    struct value *val
+      = std::get<0> (m_storage)->evaluate (nullptr, exp,
+					   EVAL_AVOID_SIDE_EFFECTS);
+    std::get<1> (m_storage)->generate_ax (exp, ax, value, val->type ());
+  }
 };
 
 using dynamic_cast_operation = cxx_cast_operation<UNOP_DYNAMIC_CAST,
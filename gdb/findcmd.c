@@ -49,18 +49,22 @@ put_bits (uint64_t data, gdb::byte_vector &buf, int bits, bfd_boolean big_p)
 }
 
 /* Subroutine of find_command to simplify it.
-   Parse the arguments of the "find" command.  */
+   Parse the arguments of the "find" command.  Return the patterns to
+   search for: one made of all the expressions, or with the "/m" flag,
+   one per expression.  */
 
-static gdb::byte_vector
+static std::vector<gdb::byte_vector>
 parse_find_args (const char *args, ULONGEST *max_countp,
 		 CORE_ADDR *start_addrp, ULONGEST *search_space_lenp,
-		 bfd_boolean big_p)
+		 ULONGEST *alignp, bfd_boolean big_p)
 {
   /* Default to using the specified type.  */
   char size = '\0';
   ULONGEST max_count = ~(ULONGEST) 0;
-  /* Buffer to hold the search pattern.  */
-  gdb::byte_vector pattern_buf;
+  ULONGEST align = 1;
+  bool multi = false;
+  /* Buffers to hold the search patterns.  */
+  std::vector<gdb::byte_vector> patterns (1);
   CORE_ADDR start_addr;
   ULONGEST search_space_len;
   const char *s = args;
@@ -94,6 +98,18 @@ parse_find_args (const char *args, ULONGEST *max_countp,
 	    case 'g':
 	      size = *s++;
 	      break;
+	    case 'm':
+	      multi = true;
+	      ++s;
+	      break;
+	    case 'a':
+	      ++s;
+	      if (!isdigit (*s))
+		error (_("Missing alignment."));
+	      align = strtoulst (s, &s, 10);
+	      if (align == 0)
+		error (_("Invalid alignment."));
+	      break;
 	    default:
 	      error (_("Invalid size granularity."));
 	    }
@@ -121,7 +137,7 @@ parse_find_args (const char *args, ULONGEST *max_countp,
       if (len == 0)
 	{
 	  gdb_printf (_("Empty search range.\n"));
-	  return pattern_buf;
+	  return {};
 	}
       if (len < 0)
 	error (_("Invalid length."));
@@ -160,6 +176,11 @@ parse_find_args (const char *args, ULONGEST *max_countp,
 
       s = skip_spaces (s);
 
+      /* With "/m", each expression is a pattern of its own.  */
+      if (multi && !patterns.back ().empty ())
+	patterns.emplace_back ();
+      gdb::byte_vector &pattern_buf = patterns.back ();
+
       v = parse_to_comma_and_eval (&s);
       t = v->type ();
 
@@ -194,17 +215,21 @@ parse_find_args (const char *args, ULONGEST *max_countp,
       s = skip_spaces (s);
     }
 
-  if (pattern_buf.empty ())
+  if (patterns.back ().empty ())
     error (_("Missing search pattern."));
 
-  if (search_space_len < pattern_buf.size ())
+  size_t min_len = patterns[0].size ();
+  for (const gdb::byte_vector &pattern : patterns)
+    min_len = std::min (min_len, pattern.size ());
+  if (search_space_len < min_len)
     error (_("Search space too small to contain pattern."));
 
   *max_countp = max_count;
   *start_addrp = start_addr;
   *search_space_lenp = search_space_len;
+  *alignp = align;
 
-  return pattern_buf;
+  return patterns;
 }
 
 static void
@@ -218,34 +243,53 @@ find_command (const char *args, int from_tty)
   CORE_ADDR start_addr = 0;
   ULONGEST search_space_len = 0;
   /* End of command line parameters.  */
+  ULONGEST align = 1;
   unsigned int found_count;
   CORE_ADDR last_found_addr;
 
-  gdb::byte_vector pattern_buf = parse_find_args (args, &max_count,
-						  &start_addr,
-						  &search_space_len,
-						  big_p);
+  std::vector<gdb::byte_vector> patterns
+    = parse_find_args (args, &max_count, &start_addr, &search_space_len,
+		       &align, big_p);
+  if (patterns.empty ())
+    return;
+
+  std::vector<search_pattern> pattern_views (patterns.begin (),
+					     patterns.end ());
+  size_t min_len = patterns[0].size ();
+  for (const gdb::byte_vector &pattern : patterns)
+    min_len = std::min (min_len, pattern.size ());
 
   /* Perform the search.  */
 
   found_count = 0;
   last_found_addr = 0;
 
-  while (search_space_len >= pattern_buf.size ()
+  while (search_space_len >= min_len
 	 && found_count < max_count)
     {
       /* Offset from start of this iteration to the next iteration.  */
       ULONGEST next_iter_incr;
       CORE_ADDR found_addr;
-      int found = target_search_memory (start_addr, search_space_len,
-					pattern_buf.data (),
-					pattern_buf.size (),
-					&found_addr);
+      size_t found_index = 0;
+      int found;
+
+      /* Plain searches keep using the older interface, which more
+	 remote stubs implement.  */
+      if (patterns.size () == 1 && align == 1)
+	found = target_search_memory (start_addr, search_space_len,
+				      patterns[0].data (), patterns[0].size (),
+				      &found_addr);
+      else
+	found = target_search_memory_multi (start_addr, search_space_len,
+					    pattern_views, align,
+					    &found_addr, &found_index);
 
       if (found <= 0)
 	break;
 
       print_address (gdbarch, found_addr, gdb_stdout);
+      if (patterns.size () > 1)
+	gdb_printf (_(" (pattern %s)"), pulongest (found_index + 1));
       gdb_printf ("\n");
       ++found_count;
       last_found_addr = found_addr;
@@ -285,12 +329,19 @@ _initialize_mem_search ()
 {
   add_cmd ("find", class_vars, find_command, _("\
 Search memory for a sequence of bytes.\n\
-Usage:\nfind \
-[/SIZE-CHAR] [/MAX-COUNT] START-ADDRESS, END-ADDRESS, EXPR1 [, EXPR2 ...]\n\
-find [/SIZE-CHAR] [/MAX-COUNT] START-ADDRESS, +LENGTH, EXPR1 [, EXPR2 ...]\n\
+Usage:\n\
+find [/SIZE-CHAR] [/MAX-COUNT] [/m] [/aALIGN]\n\
+     START-ADDRESS, END-ADDRESS, EXPR1 [, EXPR2 ...]\n\
+find [/SIZE-CHAR] [/MAX-COUNT] [/m] [/aALIGN]\n\
+     START-ADDRESS, +LENGTH, EXPR1 [, EXPR2 ...]\n\
 SIZE-CHAR is one of b,h,w,g for 8,16,32,64 bit values respectively,\n\
 and if not specified the size is taken from the type of the expression\n\
 in the current language.\n\
+With /m, each expression is a separate pattern, and memory is searched\n\
+for any of them in a single pass; each match is followed by the number\n\
+of the pattern.\n\
+With /aALIGN, only matches at addresses that are a multiple of ALIGN\n\
+are reported.\n\
 The two-address form specifies an inclusive range.\n\
 Note that this means for example that in the case of C-like languages\n\
 a search for an untyped 0x42 will search for \"(int) 0x42\"\n\
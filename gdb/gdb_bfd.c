@@ -35,6 +35,7 @@
 #include "cli/cli-style.h"
 #include "gdbsupport/unordered_map.h"
 #include "gdbsupport/unordered_set.h"
+#include "target-file-cache.h"
 
 #if CXX_STD_THREAD
 
@@ -372,9 +373,10 @@ gdb_bfd_open_from_target_memory (CORE_ADDR addr, ULONGEST size,
 
 struct target_fileio_stream : public gdb_bfd_iovec_base
 {
-  target_fileio_stream (bfd *nbfd, int fd)
+  target_fileio_stream (bfd *nbfd, int fd, scoped_fd local_fd)
     : m_bfd (nbfd),
-      m_fd (fd)
+      m_fd (fd),
+      m_local_fd (std::move (local_fd))
   {
   }
 
@@ -392,6 +394,10 @@ struct target_fileio_stream : public gdb_bfd_iovec_base
 
   /* The file descriptor.  */
   int m_fd;
+
+  /* If valid, a host file with the same contents, from the target file
+     cache, which is read instead.  */
+  scoped_fd m_local_fd;
 };
 
 /* Wrapper for target_fileio_open suitable for use as a helper
@@ -417,10 +423,17 @@ gdb_bfd_iovec_fileio_open (struct bfd *abfd, inferior *inf, bool warn_if_slow)
       return NULL;
     }
 
-  return new target_fileio_stream (abfd, fd);
+  scoped_fd local_fd;
+  std::string cached
+    = target_file_cache_lookup (fd, filename + strlen (TARGET_SYSROOT_PREFIX));
+  if (!cached.empty ())
+    local_fd = gdb_open_cloexec (cached, O_RDONLY | O_BINARY, 0);
+
+  return new target_fileio_stream (abfd, fd, std::move (local_fd));
 }
 
-/* Wrapper for target_fileio_pread.  */
+/* Wrapper for target_fileio_pread, or read from the cached copy of the
+   file if there is one.  */
 
 file_ptr
 target_fileio_stream::read (struct bfd *abfd, void *buf,
@@ -429,6 +442,30 @@ target_fileio_stream::read (struct bfd *abfd, void *buf,
   fileio_error target_errno;
   file_ptr pos, bytes;
 
+  if (m_local_fd.get () != -1)
+    {
+      if (lseek (m_local_fd.get (), offset, SEEK_SET) == -1)
+	{
+	  bfd_set_error (bfd_error_system_call);
+	  return -1;
+	}
+
+      for (pos = 0; nbytes > pos; pos += bytes)
+	{
+	  bytes = ::read (m_local_fd.get (), (gdb_byte *) buf + pos,
+			  nbytes - pos);
+	  if (bytes == 0)
+	    break;
+	  if (bytes == -1)
+	    {
+	      bfd_set_error (bfd_error_system_call);
+	      return -1;
+	    }
+	}
+
+      return pos;
+    }
+
   pos = 0;
   while (nbytes > pos)
     {
@@ -24,6 +24,7 @@
 #include "target-float.h"
 #include "gdbsupport/def-vector.h"
 #include "gdbarch.h"
+#include "arch-utils.h"
 #include "scoped-mock-context.h"
 #include "gdbsupport/unordered_map.h"
 
@@ -181,6 +182,41 @@ check_stack_growth (struct gdbarch *gdbarch)
   SELF_CHECK (stack_grows_up != stack_grows_down);
 }
 
+/* Number of calls to count_lazy_init.  */
+
+static int lazy_init_count;
+
+static void
+count_lazy_init ()
+{
+  lazy_init_count++;
+}
+
+/* Test gdbarch_register_lazy_init.  The function must only be called
+   once the architecture it is registered for is looked up, and only
+   once, even though it is registered for two architectures.  */
+
+static void
+gdbarch_lazy_init_test ()
+{
+  const bfd_arch_info *arch_info
+    = gdbarch_bfd_arch_info (get_current_arch ());
+
+  lazy_init_count = 0;
+  gdbarch_register_lazy_init (arch_info->arch, count_lazy_init);
+  gdbarch_register_lazy_init (bfd_arch_unknown, count_lazy_init);
+  SELF_CHECK (lazy_init_count == 0);
+
+  gdbarch_info info;
+  info.bfd_arch_info = arch_info;
+  SELF_CHECK (gdbarch_find_by_info (info) != nullptr);
+  SELF_CHECK (lazy_init_count == 1);
+
+  gdbarch_run_lazy_init (bfd_arch_unknown);
+  gdbarch_run_lazy_init (arch_info->arch);
+  SELF_CHECK (lazy_init_count == 1);
+}
+
 } /* namespace selftests */
 
 void _initialize_gdbarch_selftests ();
@@ -195,4 +231,7 @@ _initialize_gdbarch_selftests ()
 
   selftests::register_test_foreach_arch ("stack_growth",
 					 selftests::check_stack_growth);
+
+  selftests::register_test ("gdbarch_lazy_init",
+			    selftests::gdbarch_lazy_init_test);
 }
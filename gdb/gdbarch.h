@@ -259,6 +259,26 @@ extern void gdbarch_register (enum bfd_architecture architecture,
 			      gdbarch_dump_tdep_ftype *dump_tdep = nullptr,
 			      gdbarch_supports_arch_info_ftype *supports_arch_info = nullptr);
 
+/* Arrange for INIT to be called the first time an architecture of
+   kind ARCHITECTURE is looked up, instead of during GDB's startup.
+   This is for work that a tdep file would otherwise do in its
+   _initialize function but that is only needed once the architecture
+   is in use, such as creating its target descriptions.  The same INIT
+   may be registered for several architectures; it is called at most
+   once.  */
+
+extern void gdbarch_register_lazy_init (enum bfd_architecture architecture,
+					void (*init) ());
+
+/* Call the functions registered by gdbarch_register_lazy_init for
+   ARCHITECTURE that have not been called yet.  gdbarch_find_by_info
+   does this before asking the tdep code for a new architecture; code
+   that uses the results of those functions without going through it,
+   like a native target's read_description method, must call this
+   first.  */
+
+extern void gdbarch_run_lazy_init (enum bfd_architecture architecture);
+
 /* Return true if ARCH is initialized.  */
 
 bool gdbarch_initialized_p (gdbarch *arch);
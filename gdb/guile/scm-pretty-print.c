@@ -969,12 +969,17 @@ gdbscm_apply_val_pretty_printer (const struct extension_language_defn *extlang,
   enum ext_lang_rc result = EXT_LANG_RC_NOP;
   enum guile_string_repr_result print_result;
 
-  if (value->lazy ())
-    value->fetch_lazy ();
+  /* No pretty-printer support for unavailable values.  Large arrays
+     that are printed without being read as a whole are only checked
+     element by element.  */
+  if (!val_print_array_lazily_p (value, options, language))
+    {
+      if (value->lazy ())
+	value->fetch_lazy ();
 
-  /* No pretty-printer support for unavailable values.  */
-  if (!value->bytes_available (0, type->length ()))
-    return EXT_LANG_RC_NOP;
+      if (!value->bytes_available (0, type->length ()))
+	return EXT_LANG_RC_NOP;
+    }
 
   if (!gdb_scheme_initialized)
     return EXT_LANG_RC_NOP;
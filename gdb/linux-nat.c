@@ -799,6 +799,8 @@ linux_nat_target::pass_signals
 
 /* Prototypes for local functions.  */
 static int stop_wait_callback (struct lwp_info *lp);
+static void stop_and_wait_lwps (ptid_t filter);
+static void linux_nat_filter_event (int lwpid, int status);
 static int resume_stopped_resumed_lwps (struct lwp_info *lp, const ptid_t wait_ptid);
 static int check_ptrace_stopped_lwp_gone (struct lwp_info *lp);
 
@@ -1818,7 +1820,11 @@ linux_nat_target::resume (ptid_t scope_ptid, int step, enum gdb_signal signo)
       return;
     }
 
-  /* No use iterating unless we're resuming other threads.  */
+  /* No use iterating unless we're resuming other threads.  Unlike
+     stopping, where the stop events can be collected in bulk (see
+     stop_and_wait_lwps), resuming can't be batched: ptrace resumes
+     one LWP per call, and each LWP may need its own signal, debug
+     register update or single-step.  */
   if (scope_ptid != lp->ptid)
     iterate_over_lwps (scope_ptid, [=] (struct lwp_info *info)
       {
@@ -2224,6 +2230,9 @@ is_lwp_marked_dead (lwp_info *lp)
   return false;
 }
 
+static int wait_lwp_status (struct lwp_info *lp, int status,
+			    bool thread_dead, bool *wait_again);
+
 /* Wait for LP to stop.  Returns the wait status, or 0 if the LWP has
    exited.  */
 
@@ -2292,9 +2301,30 @@ wait_lwp (struct lwp_info *lp)
   restore_child_signals_mask (&prev_mask);
 
   if (!thread_dead)
-    {
-      gdb_assert (pid == lp->ptid.lwp ());
+    gdb_assert (pid == lp->ptid.lwp ());
+
+  bool wait_again;
+  status = wait_lwp_status (lp, status, thread_dead, &wait_again);
+  if (wait_again)
+    return wait_lwp (lp);
+  return status;
+}
+
+/* Process STATUS, the result of waiting for LP while stopping it.
+   THREAD_DEAD is true if LP was found to have vanished instead.
+   Returns the wait status, or 0 if the LWP has exited or the event was
+   handled internally.  Sets *WAIT_AGAIN to true if LP was resumed
+   while handling the event, and must be waited for again.  LP may
+   have been deleted when this returns 0 and *WAIT_AGAIN is false.  */
+
+static int
+wait_lwp_status (struct lwp_info *lp, int status, bool thread_dead,
+		 bool *wait_again)
+{
+  *wait_again = false;
 
+  if (!thread_dead)
+    {
       linux_nat_debug_printf ("waitpid %s received %s",
 			      lp->ptid.to_string ().c_str (),
 			      status_to_str (status).c_str ());
@@ -2346,7 +2376,10 @@ wait_lwp (struct lwp_info *lp)
 	 on.  */
       status = W_STOPCODE (SIGTRAP);
       if (linux_handle_syscall_trap (lp, 1))
-	return wait_lwp (lp);
+	{
+	  *wait_again = true;
+	  return 0;
+	}
     }
   else
     {
@@ -2404,12 +2437,7 @@ linux_stop_lwp (struct lwp_info *lwp)
 void
 linux_stop_and_wait_all_lwps (void)
 {
-  /* Stop all LWP's ...  */
-  iterate_over_lwps (minus_one_ptid, stop_callback);
-
-  /* ... and wait until all of them have reported back that
-     they're no longer running.  */
-  iterate_over_lwps (minus_one_ptid, stop_wait_callback);
+  stop_and_wait_lwps (minus_one_ptid);
 }
 
 /* See linux-nat.h  */
@@ -2539,6 +2567,77 @@ linux_nat_target::low_status_is_event (int status)
   return WIFSTOPPED (status) && WSTOPSIG (status) == SIGTRAP;
 }
 
+/* Get the inferior associated to LWP.  Must be called with an LWP that has
+   an associated inferior.  Always return non-nullptr.  */
+
+static inferior *
+lwp_inferior (const lwp_info *lwp)
+{
+  inferior *inf = find_inferior_ptid (linux_target, lwp->ptid);
+  gdb_assert (inf != nullptr);
+  return inf;
+}
+
+/* Record STATUS, the non-zero status LP reported while we were
+   waiting for it to stop.  Returns true if LP had to be resumed, and
+   must be waited for again.  */
+
+static bool
+stop_wait_status (struct lwp_info *lp, int status)
+{
+  if (lp->ignore_sigint && WIFSTOPPED (status)
+      && WSTOPSIG (status) == SIGINT)
+    {
+      lp->ignore_sigint = 0;
+
+      errno = 0;
+      ptrace (PTRACE_CONT, lp->ptid.lwp (), 0, 0);
+      lp->stopped = 0;
+      linux_nat_debug_printf
+	("PTRACE_CONT %s, 0, 0 (%s) (discarding SIGINT)",
+	 lp->ptid.to_string ().c_str (),
+	 errno ? safe_strerror (errno) : "OK");
+
+      return true;
+    }
+
+  maybe_clear_ignore_sigint (lp);
+
+  if (WSTOPSIG (status) != SIGSTOP)
+    {
+      /* The thread was stopped with a signal other than SIGSTOP.  */
+
+      linux_nat_debug_printf ("Pending event %s in %s",
+			      status_to_str ((int) status).c_str (),
+			      lp->ptid.to_string ().c_str ());
+
+      /* Save the sigtrap event.  */
+      lp->status = status;
+      gdb_assert (lp->signalled);
+      save_stop_reason (lp);
+    }
+  else
+    {
+      /* We caught the SIGSTOP that we intended to catch.  */
+
+      linux_nat_debug_printf ("Expected SIGSTOP caught for %s.",
+			      lp->ptid.to_string ().c_str ());
+
+      lp->signalled = 0;
+
+      /* If we are waiting for this stop so we can report the thread
+	 stopped then we need to record this status.  Otherwise, we can
+	 now discard this stop event.  */
+      if (lp->last_resume_kind == resume_stop)
+	{
+	  lp->status = status;
+	  save_stop_reason (lp);
+	}
+    }
+
+  return false;
+}
+
 /* Wait until LP is stopped.  */
 
 static int
@@ -2559,69 +2658,173 @@ stop_wait_callback (struct lwp_info *lp)
       if (status == 0)
 	return 0;
 
-      if (lp->ignore_sigint && WIFSTOPPED (status)
-	  && WSTOPSIG (status) == SIGINT)
-	{
-	  lp->ignore_sigint = 0;
+      if (stop_wait_status (lp, status))
+	return stop_wait_callback (lp);
+    }
 
-	  errno = 0;
-	  ptrace (PTRACE_CONT, lp->ptid.lwp (), 0, 0);
-	  lp->stopped = 0;
-	  linux_nat_debug_printf
-	    ("PTRACE_CONT %s, 0, 0 (%s) (discarding SIGINT)",
-	     lp->ptid.to_string ().c_str (),
-	     errno ? safe_strerror (errno) : "OK");
+  return 0;
+}
 
-	  return stop_wait_callback (lp);
-	}
+/* Below this many LWPs to wait for, stop_and_wait_lwps just waits for
+   each LWP in turn.  */
 
-      maybe_clear_ignore_sigint (lp);
+static const size_t bulk_stop_min_lwps = 16;
 
-      if (WSTOPSIG (status) != SIGSTOP)
-	{
-	  /* The thread was stopped with a signal other than SIGSTOP.  */
+/* Return true if LP is one stop_and_wait_lwps still needs to wait
+   for.  */
 
-	  linux_nat_debug_printf ("Pending event %s in %s",
-				  status_to_str ((int) status).c_str (),
-				  lp->ptid.to_string ().c_str ());
+static bool
+stop_wait_pending_p (const lwp_info *lp)
+{
+  return !lp->stopped && lwp_inferior (lp)->vfork_child == nullptr;
+}
 
-	  /* Save the sigtrap event.  */
-	  lp->status = status;
-	  gdb_assert (lp->signalled);
-	  save_stop_reason (lp);
+/* Process STATUS, reported by waitpid for LWPID while stopping LWPs
+   in bulk.  THREAD_DEAD is true if LWPID was found to have
+   vanished.  */
+
+static void
+bulk_stop_wait_event (pid_t lwpid, int status, bool thread_dead,
+		      ptid_t filter)
+{
+  lwp_info *lp = find_lwp_pid (ptid_t (lwpid));
+
+  /* Events for LWPs we are not waiting for, including new clones and
+     fork children we don't know about yet, are handled the same way
+     linux_nat_wait_1 handles them.  */
+  if (lp == nullptr || !lp->ptid.matches (filter)
+      || !stop_wait_pending_p (lp))
+    {
+      if (!thread_dead)
+	linux_nat_filter_event (lwpid, status);
+      return;
+    }
+
+  bool wait_again;
+  status = wait_lwp_status (lp, status, thread_dead, &wait_again);
+  if (status != 0)
+    stop_wait_status (lp, status);
+}
+
+/* Send a SIGSTOP to all LWPs matching FILTER, and wait until all of
+   them have reported back that they're no longer running.
+
+   With many LWPs, waiting for each of them in turn with wait_lwp
+   costs a waitpid call per LWP, and possibly a sigsuspend round trip
+   per LWP too, since the LWPs stop in whatever order the kernel
+   schedules them.  Instead, once the SIGSTOPs have been sent, reap
+   events with waitpid (-1), the same way linux_nat_wait_1 does, and
+   dispatch each event to its LWP.  The LWPs still being waited for
+   are kept in an array of LWP ids, compacted after every round.  */
+
+static void
+stop_and_wait_lwps (ptid_t filter)
+{
+  /* Send all the SIGSTOPs first ...  */
+  iterate_over_lwps (filter, stop_callback);
+
+  /* ... then collect the LWPs we need to wait for.  */
+  std::vector<pid_t> waiting;
+  for (lwp_info *lp : all_lwps ())
+    if (lp->ptid.matches (filter) && stop_wait_pending_p (lp))
+      waiting.push_back (lp->ptid.lwp ());
+
+  if (waiting.size () < bulk_stop_min_lwps)
+    {
+      iterate_over_lwps (filter, stop_wait_callback);
+      return;
+    }
+
+  linux_nat_debug_printf ("waiting for %zu LWPs in bulk", waiting.size ());
+
+  /* Drop from WAITING the LWPs that have stopped or are gone.  */
+  auto compact = [&] ()
+    {
+      auto it = std::remove_if (waiting.begin (), waiting.end (),
+				[&] (pid_t lwpid)
+				{
+				  lwp_info *lp = find_lwp_pid (ptid_t (lwpid));
+				  return lp == nullptr || lp->stopped;
+				});
+      waiting.erase (it, waiting.end ());
+    };
+
+  sigset_t prev_mask;
+  block_child_signals (&prev_mask);
+  SCOPE_EXIT { restore_child_signals_mask (&prev_mask); };
+
+  /* Whether to check each remaining LWP individually, see below.  */
+  bool sweep = true;
+
+  while (!waiting.empty ())
+    {
+      int status;
+      pid_t lwpid;
+      int reaped = 0;
+
+      /* Pull all events out of the kernel.  */
+      while ((lwpid = my_waitpid (-1, &status, __WALL | WNOHANG)) > 0)
+	{
+	  /* An exec makes all the other threads of the process vanish
+	     without reporting an exit.  */
+	  if (WIFSTOPPED (status)
+	      && linux_ptrace_get_extended_event (status) == PTRACE_EVENT_EXEC)
+	    sweep = true;
+
+	  bulk_stop_wait_event (lwpid, status, false, filter);
+	  reaped++;
 	}
-      else
+
+      compact ();
+      if (waiting.empty ())
+	break;
+
+      if (reaped > 0 && !sweep)
+	continue;
+
+      /* Nothing came out of waitpid (-1).  Like wait_lwp, look for
+	 LWPs that vanished, and for zombie thread group leaders, which
+	 won't report until all other threads in the group are reaped.
+	 Checking every LWP is only needed the first time, and after an
+	 exec; leaders are always checked.  */
+      for (size_t i = 0; i < waiting.size (); i++)
 	{
-	  /* We caught the SIGSTOP that we intended to catch.  */
+	  pid_t pid = waiting[i];
+	  lwp_info *lp = find_lwp_pid (ptid_t (pid));
 
-	  linux_nat_debug_printf ("Expected SIGSTOP caught for %s.",
-				  lp->ptid.to_string ().c_str ());
+	  /* Handling an earlier event may have stopped or deleted this
+	     LWP.  */
+	  if (lp == nullptr || lp->stopped)
+	    continue;
 
-	  lp->signalled = 0;
+	  bool is_tgl = lp->ptid.pid () == pid;
+	  if (!sweep && !is_tgl)
+	    continue;
 
-	  /* If we are waiting for this stop so we can report the thread
-	     stopped then we need to record this status.  Otherwise, we can
-	     now discard this stop event.  */
-	  if (lp->last_resume_kind == resume_stop)
+	  lwpid = my_waitpid (pid, &status, __WALL | WNOHANG);
+	  if (lwpid == -1 && errno == ECHILD)
 	    {
-	      lp->status = status;
-	      save_stop_reason (lp);
+	      linux_nat_debug_printf ("LWP %d vanished.", pid);
+	      bulk_stop_wait_event (pid, 0, true, filter);
+	    }
+	  else if (lwpid > 0)
+	    bulk_stop_wait_event (pid, status, false, filter);
+	  else if (is_tgl && linux_proc_pid_is_zombie (pid))
+	    {
+	      linux_nat_debug_printf ("Thread group leader %d vanished.",
+				      pid);
+	      bulk_stop_wait_event (pid, 0, true, filter);
 	    }
 	}
-    }
-
-  return 0;
-}
+      sweep = false;
 
-/* Get the inferior associated to LWP.  Must be called with an LWP that has
-   an associated inferior.  Always return non-nullptr.  */
+      compact ();
+      if (waiting.empty ())
+	break;
 
-static inferior *
-lwp_inferior (const lwp_info *lwp)
-{
-  inferior *inf = find_inferior_ptid (linux_target, lwp->ptid);
-  gdb_assert (inf != nullptr);
-  return inf;
+      /* Block until we get an event reported with SIGCHLD.  */
+      wait_for_signal ();
+    }
 }
 
 /* Return non-zero if LP has a wait status pending.  Discard the
@@ -3440,12 +3643,9 @@ linux_nat_wait_1 (ptid_t ptid, struct target_waitstatus *ourstatus,
 
   if (!target_is_non_stop_p ())
     {
-      /* Now stop all other LWP's ...  */
-      iterate_over_lwps (minus_one_ptid, stop_callback);
-
-      /* ... and wait until all of them have reported back that
-	 they're no longer running.  */
-      iterate_over_lwps (minus_one_ptid, stop_wait_callback);
+      /* Now stop all other LWP's, and wait until all of them have
+	 reported back that they're no longer running.  */
+      stop_and_wait_lwps (minus_one_ptid);
     }
 
   /* If we're not waiting for a specific LWP, choose an event LWP from
@@ -3515,8 +3715,9 @@ linux_nat_wait_1 (ptid_t ptid, struct target_waitstatus *ourstatus,
 static int
 resume_stopped_resumed_lwps (struct lwp_info *lp, const ptid_t wait_ptid)
 {
-  inferior *inf = lwp_inferior (lp);
-
+  /* This is called for every LWP each time linux_nat_wait_1 pulls
+     events out of the kernel, so check the cheap conditions before
+     looking up the inferior.  */
   if (!lp->stopped)
     {
       linux_nat_debug_printf ("NOT resuming LWP %s, not stopped",
@@ -3532,13 +3733,14 @@ resume_stopped_resumed_lwps (struct lwp_info *lp, const ptid_t wait_ptid)
       linux_nat_debug_printf ("NOT resuming LWP %s, has pending status",
 			      lp->ptid.to_string ().c_str ());
     }
-  else if (inf->vfork_child != nullptr)
+  else if (lwp_inferior (lp)->vfork_child != nullptr)
     {
       linux_nat_debug_printf ("NOT resuming LWP %s (vfork parent)",
 			      lp->ptid.to_string ().c_str ());
     }
   else
     {
+      inferior *inf = lwp_inferior (lp);
       struct regcache *regcache = get_thread_regcache (linux_target, lp->ptid);
       struct gdbarch *gdbarch = regcache->arch ();
 
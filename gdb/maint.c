@@ -46,6 +46,9 @@
 #include "cli/cli-setshow.h"
 #include "cli/cli-style.h"
 #include "cli/cli-cmds.h"
+#include "completer.h"
+#include "gdbsupport/filestuff.h"
+#include "gdbsupport/gdb_tilde_expand.h"
 
 static void maintenance_do_deprecate (const char *, int);
 
@@ -1180,7 +1183,8 @@ scoped_time_it::scoped_time_it (const char *what, bool enabled)
     m_what (what),
     m_start_wall (m_enabled
 		  ? std::chrono::steady_clock::now ()
-		  : std::chrono::steady_clock::time_point ())
+		  : std::chrono::steady_clock::time_point ()),
+    m_trace_event ("time-it", what)
 {
   if (m_enabled)
     get_run_time (m_start_user, m_start_sys, run_time_scope::thread);
@@ -1217,6 +1221,58 @@ scoped_time_it::~scoped_time_it ()
   gdb_stdlog->write_async_safe (str.data (), str.size ());
 }
 
+/* The "maintenance trace-events" commands.  */
+
+static cmd_list_element *maintenance_trace_events_list;
+
+/* Handle "maintenance trace-events start".  */
+
+static void
+maintenance_trace_events_start (const char *args, int from_tty)
+{
+  if (args != nullptr && *args != '\0')
+    error (_("Usage: maintenance trace-events start"));
+
+  if (gdb::trace_events::enabled ())
+    error (_("Events are already being recorded."));
+
+  gdb::trace_events::start ();
+}
+
+/* Handle "maintenance trace-events stop".  */
+
+static void
+maintenance_trace_events_stop (const char *args, int from_tty)
+{
+  std::string filename = extract_single_filename_arg (args);
+  if (filename.empty ())
+    error (_("Usage: maintenance trace-events stop FILE"));
+
+  if (!gdb::trace_events::enabled ())
+    error (_("Events are not being recorded."));
+
+  /* Open the file first, so that the events are not lost if that
+     fails.  */
+  filename = gdb_tilde_expand (filename.c_str ());
+  gdb_file_up file = gdb_fopen_cloexec (filename.c_str (), "w");
+  if (file == nullptr)
+    perror_with_name (filename.c_str ());
+
+  std::string json;
+  size_t dropped;
+  size_t count = gdb::trace_events::stop (json, &dropped);
+
+  if (fwrite (json.data (), 1, json.size (), file.get ()) != json.size ()
+      || fflush (file.get ()) != 0)
+    perror_with_name (filename.c_str ());
+
+  gdb_printf (_("Wrote %s events to %ps.\n"), pulongest (count),
+	      styled_string (file_name_style.style (), filename.c_str ()));
+  if (dropped > 0)
+    gdb_printf (_("%s older events were overwritten.\n"),
+		pulongest (dropped));
+}
+
 /* Options affecting the "maintenance selftest" command.  */
 
 struct maintenance_selftest_options
@@ -1428,6 +1484,27 @@ Show the canonical form of a C++ name.\n\
 Usage: maintenance canonicalize NAME"),
 		 &maintenancelist);
 
+  add_basic_prefix_cmd ("trace-events", class_maintenance, _("\
+Record a timeline of what GDB does internally."),
+			&maintenance_trace_events_list, 0, &maintenancelist);
+
+  add_cmd ("start", class_maintenance, maintenance_trace_events_start, _("\
+Start recording GDB's internal events.\n\
+Usage: maintenance trace-events start\n\
+While recording, GDB notes when commands, Python code, thread pool tasks,\n\
+remote packet round trips, DWARF symtab expansions, and the regions\n\
+timed by \"maintenance set per-command time\" start and end, in each\n\
+thread."),
+	   &maintenance_trace_events_list);
+
+  cmd = add_cmd ("stop", class_maintenance, maintenance_trace_events_stop, _("\
+Stop recording GDB's internal events, and write them to FILE.\n\
+Usage: maintenance trace-events stop FILE\n\
+The events are written in the Chrome trace event format, which tools such\n\
+as Perfetto show as a timeline."),
+		 &maintenance_trace_events_list);
+  set_cmd_completer (cmd, filename_maybe_quoted_completer);
+
   add_prefix_cmd ("per-command", class_maintenance, set_per_command_cmd, _("\
 Per-command statistics settings."),
 		    &per_command_setlist,
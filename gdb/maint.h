@@ -20,6 +20,7 @@
 #define GDB_MAINT_H
 
 #include "gdbsupport/run-time-clock.h"
+#include "gdbsupport/trace-events.h"
 #include <chrono>
 
 struct obj_section;
@@ -75,7 +76,8 @@ class scoped_command_stats
 extern bool per_command_time;
 
 /* RAII structure used to measure the time spent by the current thread in a
-   given scope.  */
+   given scope.  The scope is also recorded by "maint trace-events",
+   whether or not the time is printed.  */
 
 struct scoped_time_it
 {
@@ -99,6 +101,9 @@ struct scoped_time_it
 
   /* Wall-clock time at the start of execution.  */
   std::chrono::steady_clock::time_point m_start_wall;
+
+  /* The event recorded for the scope.  */
+  gdb::trace_events::scoped_event m_trace_event;
 };
 
 extern obj_section *maint_obj_section_from_bfd_section (bfd *abfd,
@@ -18,6 +18,7 @@
 
 #include "mi-cmds.h"
 #include "mi-getopt.h"
+#include "inferior.h"
 #include "remote.h"
 
 /* Get a file from the target.  */
@@ -92,3 +93,52 @@ mi_cmd_target_file_delete (const char *command, const char *const *argv,
   remote_file_delete (remote_file, 0);
 }
 
+
+/* Report, and optionally reset, the statistics about the packets
+   exchanged with the remote target.  */
+
+void
+mi_cmd_target_remote_stats (const char *command, const char *const *argv,
+			    int argc)
+{
+  enum opt
+    {
+      CLEAR_OPT
+    };
+  static const struct mi_opt opts[] =
+    {
+      {"-clear", CLEAR_OPT, 0},
+      { 0, 0, 0 }
+    };
+  static const char prefix[] = "-target-remote-stats";
+
+  int oind = 0;
+  const char *oarg;
+  bool clear = false;
+
+  while (1)
+    {
+      int opt = mi_getopt (prefix, argc, argv, opts, &oind, &oarg);
+      if (opt < 0)
+	break;
+      switch ((enum opt) opt)
+	{
+	case CLEAR_OPT:
+	  clear = true;
+	  break;
+	}
+    }
+
+  if (oind != argc)
+    error (_("-target-remote-stats: Usage: [--clear]"));
+
+  remote_packet_stats *stats
+    = remote_get_packet_stats (current_inferior ()->process_target ());
+  if (stats == nullptr)
+    error (_("-target-remote-stats: Not a remote target."));
+
+  remote_print_packet_stats (current_uiout, *stats);
+
+  if (clear)
+    stats->reset ();
+}
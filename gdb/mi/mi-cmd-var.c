@@ -30,6 +30,7 @@
 #include "gdbthread.h"
 #include "mi-parse.h"
 #include "inferior.h"
+#include "target.h"
 
 static void varobj_update_one (struct varobj *var,
 			       enum print_values print_values,
@@ -654,6 +655,14 @@ mi_cmd_var_update (const char *command, const char *const *argv, int argc)
 	 VAROBJ.  Therefore update each VAROBJ only once by iterating
 	 only the root VAROBJs.  */
 
+      /* Read the memory that the varobjs to re-evaluate are going to
+	 read, in a few large requests rather than many small ones.  */
+      std::vector<mem_range> prefetch_ranges;
+      if (inferior_ptid != null_ptid
+	  && inferior_thread ()->state == THREAD_STOPPED)
+	prefetch_ranges = varobj_stale_footprints ();
+      scoped_memory_prefetch prefetch (std::move (prefetch_ranges));
+
       all_root_varobjs ([=] (varobj *var)
 	{ mi_cmd_var_update_iter (var, *name == '0', print_values); });
     }
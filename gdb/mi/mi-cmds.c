@@ -324,6 +324,7 @@ add_builtin_mi_commands ()
   add_mi_cmd_mi ("target-file-get", mi_cmd_target_file_get);
   add_mi_cmd_mi ("target-file-put", mi_cmd_target_file_put);
   add_mi_cmd_mi ("target-flash-erase", mi_cmd_target_flash_erase);
+  add_mi_cmd_mi ("target-remote-stats", mi_cmd_target_remote_stats);
   add_mi_cmd_cli ("target-select", "target", 1);
   add_mi_cmd_mi ("thread-info", mi_cmd_thread_info);
   add_mi_cmd_mi ("thread-list-ids", mi_cmd_thread_list_ids);
@@ -40,6 +40,7 @@
 #include "frame.h"
 #include "mi-main.h"
 #include "mi-interp.h"
+#include "mi-console.h"
 #include "language.h"
 #include "valprint.h"
 #include "osdata.h"
@@ -1362,6 +1363,66 @@ mi_cmd_data_read_memory (const char *command, const char *const *argv,
   }
 }
 
+/* Output the fields describing the memory READ_RESULT, read by
+   -data-read-memory-bytes at ADDR, to UIOUT.  */
+
+static void
+output_memory_read_result (ui_out *uiout, gdbarch *gdbarch, CORE_ADDR addr,
+			   const memory_read_result &read_result)
+{
+  int unit_size = gdbarch_addressable_memory_unit_size (gdbarch);
+
+  uiout->field_core_addr ("begin", gdbarch, read_result.begin);
+  uiout->field_core_addr ("offset", gdbarch, read_result.begin - addr);
+  uiout->field_core_addr ("end", gdbarch, read_result.end);
+
+  std::string data = bin2hex (read_result.data.get (),
+			      (read_result.end - read_result.begin)
+			      * unit_size);
+  uiout->field_string ("contents", data);
+}
+
+/* Read LENGTH addressable units of memory at ADDR, CHUNK_SIZE units at
+   a time, and report each block read in a =memory-chunk notification
+   on the event channel of MI as soon as it is read, so that only one
+   chunk is ever held in memory.  Return the number of notifications
+   sent.  */
+
+static ULONGEST
+read_memory_bytes_chunked (mi_interp *mi, gdbarch *gdbarch, CORE_ADDR addr,
+			   ULONGEST length, ULONGEST chunk_size)
+{
+  ui_out *mi_uiout = mi->interp_ui_out ();
+  ULONGEST chunks = 0;
+
+  for (ULONGEST done = 0; done < length; done += chunk_size)
+    {
+      QUIT;
+
+      std::vector<memory_read_result> result
+	= read_memory_robust (current_inferior ()->top_target (),
+			      addr + done,
+			      std::min (chunk_size, length - done));
+
+      for (const memory_read_result &read_result : result)
+	{
+	  target_terminal::scoped_restore_terminal_state term_state;
+	  target_terminal::ours_for_output ();
+
+	  gdb_printf (mi->event_channel, "memory-chunk");
+	  {
+	    ui_out_redirect_pop redir (mi_uiout, mi->event_channel);
+
+	    output_memory_read_result (mi_uiout, gdbarch, addr, read_result);
+	  }
+	  gdb_flush (mi->event_channel);
+	  chunks++;
+	}
+    }
+
+  return chunks;
+}
+
 void
 mi_cmd_data_read_memory_bytes (const char *command, const char *const *argv,
 			       int argc)
@@ -1371,16 +1432,17 @@ mi_cmd_data_read_memory_bytes (const char *command, const char *const *argv,
   CORE_ADDR addr;
   LONGEST length;
   long offset = 0;
-  int unit_size = gdbarch_addressable_memory_unit_size (gdbarch);
+  LONGEST chunk_size = 0;
   int oind = 0;
   const char *oarg;
   enum opt
   {
-    OFFSET_OPT
+    OFFSET_OPT, CHUNK_SIZE_OPT
   };
   static const struct mi_opt opts[] =
     {
       {"o", OFFSET_OPT, 1},
+      {"-chunk-size", CHUNK_SIZE_OPT, 1},
       { 0, 0, 0 }
     };
 
@@ -1395,17 +1457,41 @@ mi_cmd_data_read_memory_bytes (const char *command, const char *const *argv,
 	case OFFSET_OPT:
 	  offset = atol (oarg);
 	  break;
+	case CHUNK_SIZE_OPT:
+	  chunk_size = atol (oarg);
+	  if (chunk_size <= 0)
+	    error (_("-data-read-memory-bytes: invalid chunk size: %s"),
+		   oarg);
+	  break;
 	}
     }
   argv += oind;
   argc -= oind;
 
   if (argc != 2)
-    error (_("Usage: [ -o OFFSET ] ADDR LENGTH."));
+    error (_("Usage: [ -o OFFSET ] [ --chunk-size SIZE ] ADDR LENGTH."));
 
   addr = parse_and_eval_address (argv[0]) + offset;
   length = atol (argv[1]);
 
+  /* Notifications need an MI interpreter to be sent to.  When the
+     command's output doesn't go to one, for instance with
+     gdb.execute_mi, just return all the memory.  */
+  mi_interp *mi = as_mi_interp (current_interpreter ());
+  if (chunk_size > 0
+      && mi != nullptr
+      && uiout == mi->interp_ui_out ()
+      && length > 0)
+    {
+      ULONGEST chunks = read_memory_bytes_chunked (mi, gdbarch, addr, length,
+						   chunk_size);
+      if (chunks == 0)
+	error (_("Unable to read memory."));
+
+      uiout->field_unsigned ("chunks", chunks);
+      return;
+    }
+
   std::vector<memory_read_result> result
     = read_memory_robust (current_inferior ()->top_target (), addr, length);
 
@@ -1417,14 +1503,7 @@ mi_cmd_data_read_memory_bytes (const char *command, const char *const *argv,
     {
       ui_out_emit_tuple tuple_emitter (uiout, NULL);
 
-      uiout->field_core_addr ("begin", gdbarch, read_result.begin);
-      uiout->field_core_addr ("offset", gdbarch, read_result.begin - addr);
-      uiout->field_core_addr ("end", gdbarch, read_result.end);
-
-      std::string data = bin2hex (read_result.data.get (),
-				  (read_result.end - read_result.begin)
-				  * unit_size);
-      uiout->field_string ("contents", data);
+      output_memory_read_result (uiout, gdbarch, addr, read_result);
     }
 }
 
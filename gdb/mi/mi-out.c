@@ -28,6 +28,25 @@
 #include "utils.h"
 #include "gdbsupport/gdb-checked-static-cast.h"
 
+/* Format VALUE in decimal into the buffer ending at END, and return a
+   pointer to the first character.  Plenty faster than going through
+   printf, which matters when emitting thousands of numbers.  */
+
+static char *
+format_decimal (char *end, ULONGEST value)
+{
+  char *p = end;
+
+  do
+    {
+      *--p = '0' + value % 10;
+      value /= 10;
+    }
+  while (value != 0);
+
+  return p;
+}
+
 /* Mark beginning of a table.  */
 
 void
@@ -99,8 +118,15 @@ mi_ui_out::do_field_signed (int fldno, int width, ui_align alignment,
 			    const char *fldname, LONGEST value,
 			    const ui_file_style &style)
 {
-  do_field_string (fldno, width, alignment, fldname, plongest (value),
-		   style);
+  char buf[24];
+  char *end = buf + sizeof (buf);
+  char *p = format_decimal (end, value < 0 ? -(ULONGEST) value : value);
+
+  if (value < 0)
+    *--p = '-';
+  field_start (fldname);
+  write (p, end - p);
+  write ("\"", 1);
 }
 
 /* Output an unsigned field.  */
@@ -109,8 +135,13 @@ void
 mi_ui_out::do_field_unsigned (int fldno, int width, ui_align alignment,
 			      const char *fldname, ULONGEST value)
 {
-  do_field_string (fldno, width, alignment, fldname, pulongest (value),
-		   ui_file_style ());
+  char buf[24];
+  char *end = buf + sizeof (buf);
+  char *p = format_decimal (end, value);
+
+  field_start (fldname);
+  write (p, end - p);
+  write ("\"", 1);
 }
 
 /* Used to omit a field.  */
@@ -129,15 +160,10 @@ mi_ui_out::do_field_string (int fldno, int width, ui_align align,
 			    const char *fldname, const char *string,
 			    const ui_file_style &style)
 {
-  ui_file *stream = m_streams.back ();
-  field_separator ();
-
-  if (fldname)
-    gdb_printf (stream, "%s=", fldname);
-  gdb_printf (stream, "\"");
+  field_start (fldname);
   if (string)
-    stream->putstr (string, '"');
-  gdb_printf (stream, "\"");
+    write_escaped (string);
+  write ("\"", 1);
 }
 
 void
@@ -194,6 +220,72 @@ mi_ui_out::do_redirect (ui_file *outstream)
     m_streams.pop_back ();
 }
 
+/* Emit the separator before a field, then FLDNAME if not NULL, and
+   the opening quote of the field's value.  */
+
+void
+mi_ui_out::field_start (const char *fldname)
+{
+  char buf[256];
+  size_t len = 0;
+
+  if (m_suppress_field_separator)
+    m_suppress_field_separator = false;
+  else
+    buf[len++] = ',';
+
+  if (fldname != nullptr)
+    {
+      size_t name_len = strlen (fldname);
+
+      if (name_len + 3 > sizeof (buf))
+	{
+	  write (buf, len);
+	  write (fldname, name_len);
+	  len = 0;
+	}
+      else
+	{
+	  memcpy (buf + len, fldname, name_len);
+	  len += name_len;
+	}
+      buf[len++] = '=';
+    }
+
+  buf[len++] = '"';
+  write (buf, len);
+}
+
+/* Write STRING, escaping it for use within double quotes.  Characters
+   that need no escaping are written in runs, instead of one at a
+   time.  */
+
+void
+mi_ui_out::write_escaped (const char *string)
+{
+  ui_file *stream = m_streams.back ();
+
+  while (*string != '\0')
+    {
+      const char *run = string;
+
+      for (;; ++string)
+	{
+	  unsigned char c = *string;
+
+	  if (c < 0x20 || c == '"' || c == '\\'
+	      || (c >= 0x7f && (c < 0xa0 || sevenbit_strings)))
+	    break;
+	}
+
+      if (string != run)
+	stream->write (run, string - run);
+
+      if (*string != '\0')
+	stream->putstrn (string++, 1, '"');
+    }
+}
+
 void
 mi_ui_out::field_separator ()
 {
@@ -212,7 +304,10 @@ mi_ui_out::open (const char *name, ui_out_type type)
   m_suppress_field_separator = true;
 
   if (name)
-    gdb_printf (stream, "%s=", name);
+    {
+      write (name, strlen (name));
+      write ("=", 1);
+    }
 
   switch (type)
     {
@@ -326,6 +421,9 @@ mi_ui_out::mi_ui_out (int mi_version)
   m_mi_version (mi_version)
 {
   string_file *stream = new string_file ();
+  /* Most responses fit, and the buffer is reused from one to the
+     next, so that building a response rarely needs to allocate.  */
+  stream->reserve (initial_buffer_size);
   m_streams.push_back (stream);
 }
 
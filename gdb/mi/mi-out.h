@@ -97,7 +97,16 @@ class mi_ui_out : public ui_out
 private:
 
   void field_separator ();
+  void field_start (const char *fldname);
+  void write_escaped (const char *string);
   void open (const char *name, ui_out_type type);
+
+  /* Write LEN bytes at BUF to the current stream.  */
+  void write (const char *buf, size_t len)
+  { m_streams.back ()->write (buf, len); }
+
+  /* The size of the buffer that responses are built in, at first.  */
+  static constexpr size_t initial_buffer_size = 64 * 1024;
   void close (ui_out_type type);
 
   /* The state of a recent progress_update.  */
@@ -736,14 +736,23 @@ microblaze_gdbarch_init (struct gdbarch_info info, struct gdbarch_list *arches)
   return gdbarch;
 }
 
+/* Initialize the standard target descriptions.  */
+
+static void
+microblaze_init_tdescs ()
+{
+  initialize_tdesc_microblaze_with_stack_protect ();
+  initialize_tdesc_microblaze ();
+}
+
 void _initialize_microblaze_tdep ();
 void
 _initialize_microblaze_tdep ()
 {
   gdbarch_register (bfd_arch_microblaze, microblaze_gdbarch_init);
 
-  initialize_tdesc_microblaze_with_stack_protect ();
-  initialize_tdesc_microblaze ();
+  /* Create the target descriptions the first time they are needed.  */
+  gdbarch_register_lazy_init (bfd_arch_microblaze, microblaze_init_tdescs);
   /* Debug this files internals.  */
   add_setshow_zuinteger_cmd ("microblaze", class_maintenance,
 			     &microblaze_debug_flag, _("\
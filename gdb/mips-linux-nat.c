@@ -455,6 +455,8 @@ mips_linux_nat_target::read_description ()
 {
   static int have_dsp = -1;
 
+  gdbarch_run_lazy_init (bfd_arch_mips);
+
   if (have_dsp < 0)
     {
       /* Assume no DSP if there is no inferior to inspect with ptrace.  */
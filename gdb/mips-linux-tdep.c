@@ -1628,6 +1628,17 @@ mips_linux_init_abi (struct gdbarch_info info,
     }
 }
 
+/* Initialize the standard target descriptions.  */
+
+static void
+mips_linux_init_tdescs ()
+{
+  initialize_tdesc_mips_linux ();
+  initialize_tdesc_mips_dsp_linux ();
+  initialize_tdesc_mips64_linux ();
+  initialize_tdesc_mips64_dsp_linux ();
+}
+
 void _initialize_mips_linux_tdep ();
 void
 _initialize_mips_linux_tdep ()
@@ -1643,9 +1654,6 @@ _initialize_mips_linux_tdep ()
 			      mips_linux_init_abi);
     }
 
-  /* Initialize the standard target descriptions.  */
-  initialize_tdesc_mips_linux ();
-  initialize_tdesc_mips_dsp_linux ();
-  initialize_tdesc_mips64_linux ();
-  initialize_tdesc_mips64_dsp_linux ();
+  /* Create the target descriptions the first time they are needed.  */
+  gdbarch_register_lazy_init (bfd_arch_mips, mips_linux_init_tdescs);
 }
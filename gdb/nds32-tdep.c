@@ -2093,6 +2093,7 @@ _initialize_nds32_tdep ()
   /* Initialize gdbarch.  */
   gdbarch_register (bfd_arch_nds32, nds32_gdbarch_init);
 
-  initialize_tdesc_nds32 ();
+  /* Create the target description the first time it is needed.  */
+  gdbarch_register_lazy_init (bfd_arch_nds32, initialize_tdesc_nds32);
   nds32_init_reggroups ();
 }
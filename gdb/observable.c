@@ -76,6 +76,7 @@ DEFINE_OBSERVABLE (target_post_wait);
 DEFINE_OBSERVABLE (new_program_space);
 DEFINE_OBSERVABLE (free_program_space);
 DEFINE_OBSERVABLE (tui_enabled);
+DEFINE_OBSERVABLE (setting_changed);
 
 } /* namespace observers */
 } /* namespace gdb */
@@ -260,6 +260,9 @@ extern observable <program_space */* pspace */> free_program_space;
 
 extern observable<bool /* enabled */> tui_enabled;
 
+/* The value of a setting was changed by a "set" command.  */
+extern observable<> setting_changed;
+
 } /* namespace observers */
 
 } /* namespace gdb */
@@ -126,6 +126,7 @@ fill_fpregset (const struct regcache *regcache,
 const struct target_desc *
 or1k_linux_nat_target::read_description ()
 {
+  gdbarch_run_lazy_init (bfd_arch_or1k);
   return tdesc_or1k_linux;
 }
 
@@ -174,6 +174,6 @@ _initialize_or1k_linux_tdep ()
   gdbarch_register_osabi (bfd_arch_or1k, 0, GDB_OSABI_LINUX,
 			  or1k_linux_init_abi);
 
-  /* Initialize the standard target descriptions.  */
-  initialize_tdesc_or1k_linux ();
+  /* Create the target description the first time it is needed.  */
+  gdbarch_register_lazy_init (bfd_arch_or1k, initialize_tdesc_or1k_linux);
 }
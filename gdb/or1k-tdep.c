@@ -1293,7 +1293,8 @@ _initialize_or1k_tdep ()
   /* Register this architecture.  */
   gdbarch_register (bfd_arch_or1k, or1k_gdbarch_init, or1k_dump_tdep);
 
-  initialize_tdesc_or1k ();
+  /* Create the target description the first time it is needed.  */
+  gdbarch_register_lazy_init (bfd_arch_or1k, initialize_tdesc_or1k);
 
   /* Debugging flag.  */
   add_setshow_boolean_cmd ("or1k", class_maintenance, &or1k_debug,
@@ -1948,6 +1948,8 @@ ppc_linux_nat_target::read_description ()
   if (inferior_ptid == null_ptid)
     return this->beneath ()->read_description ();
 
+  gdbarch_run_lazy_init (bfd_arch_powerpc);
+
   int tid = inferior_ptid.pid ();
 
   if (have_ptrace_getsetevrregs)
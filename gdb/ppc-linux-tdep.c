@@ -2392,20 +2392,11 @@ ppc_linux_init_abi (struct gdbarch_info info,
 
 }
 
-void _initialize_ppc_linux_tdep ();
-void
-_initialize_ppc_linux_tdep ()
-{
-  /* Register for all sub-families of the POWER/PowerPC: 32-bit and
-     64-bit PowerPC, and the older rs6k.  */
-  gdbarch_register_osabi (bfd_arch_powerpc, bfd_mach_ppc, GDB_OSABI_LINUX,
-			 ppc_linux_init_abi);
-  gdbarch_register_osabi (bfd_arch_powerpc, bfd_mach_ppc64, GDB_OSABI_LINUX,
-			 ppc_linux_init_abi);
-  gdbarch_register_osabi (bfd_arch_rs6000, bfd_mach_rs6k, GDB_OSABI_LINUX,
-			 ppc_linux_init_abi);
+/* Initialize the Linux target descriptions.  */
 
-  /* Initialize the Linux target descriptions.  */
+static void
+ppc_linux_init_tdescs ()
+{
   initialize_tdesc_powerpc_32l ();
   initialize_tdesc_powerpc_altivec32l ();
   initialize_tdesc_powerpc_vsx32l ();
@@ -2426,3 +2417,21 @@ _initialize_ppc_linux_tdep ()
   initialize_tdesc_powerpc_isa207_htm_vsx64l ();
   initialize_tdesc_powerpc_e500l ();
 }
+
+void _initialize_ppc_linux_tdep ();
+void
+_initialize_ppc_linux_tdep ()
+{
+  /* Register for all sub-families of the POWER/PowerPC: 32-bit and
+     64-bit PowerPC, and the older rs6k.  */
+  gdbarch_register_osabi (bfd_arch_powerpc, bfd_mach_ppc, GDB_OSABI_LINUX,
+			 ppc_linux_init_abi);
+  gdbarch_register_osabi (bfd_arch_powerpc, bfd_mach_ppc64, GDB_OSABI_LINUX,
+			 ppc_linux_init_abi);
+  gdbarch_register_osabi (bfd_arch_rs6000, bfd_mach_rs6k, GDB_OSABI_LINUX,
+			 ppc_linux_init_abi);
+
+  /* Create the target descriptions the first time they are needed.  */
+  gdbarch_register_lazy_init (bfd_arch_powerpc, ppc_linux_init_tdescs);
+  gdbarch_register_lazy_init (bfd_arch_rs6000, ppc_linux_init_tdescs);
+}
@@ -319,6 +319,10 @@ def do_enable_pretty_printer(arg, flag):
                 objfile.pretty_printers, name_re, subname_re, flag
             )
 
+    # Subprinters may have changed state, which the lookup cache
+    # cannot notice by itself.
+    gdb.invalidate_cached_pretty_printers()
+
     if flag:
         state = "enabled"
     else:
@@ -173,8 +173,13 @@ class RegexpCollectionPrettyPrinter(PrettyPrinter):
             self.gen_printer = gen_printer
             self.compiled_re = re.compile(regexp)
 
+    # Whether a printer is found only depends on the name of the type.
+    type_keyed = True
+
     def __init__(self, name):
         super(RegexpCollectionPrettyPrinter, self).__init__(name, [])
+        # Map type names to the subprinters whose regexp matches them.
+        self._matches = {}
 
     def add_printer(self, name, regexp, gen_printer):
         """Add a printer to the list.
@@ -197,6 +202,8 @@ class RegexpCollectionPrettyPrinter(PrettyPrinter):
         # separate parameter.
 
         self.subprinters.append(self.RegexpSubprinter(name, regexp, gen_printer))
+        self._matches.clear()
+        gdb.invalidate_cached_pretty_printers()
 
     def __call__(self, val):
         """Lookup the pretty-printer for the provided value."""
@@ -209,10 +216,21 @@ class RegexpCollectionPrettyPrinter(PrettyPrinter):
             return None
 
         # Iterate over table of type regexps to determine
-        # if a printer is registered for that type.
+        # if a printer is registered for that type.  Remember the
+        # result, printing a container usually looks up the same type
+        # many times.
+        matches = self._matches.get(typename)
+        if matches is None:
+            matches = tuple(
+                printer
+                for printer in self.subprinters
+                if printer.compiled_re.search(typename)
+            )
+            self._matches[typename] = matches
+
         # Return an instantiation of the printer if found.
-        for printer in self.subprinters:
-            if printer.enabled and printer.compiled_re.search(typename):
+        for printer in matches:
+            if printer.enabled:
                 return printer.gen_printer(val)
 
         # Cannot find a pretty printer.  Return None.
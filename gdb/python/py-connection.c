@@ -426,6 +426,108 @@ connpy_send_packet (PyObject *self, PyObject *args, PyObject *kw)
     }
 }
 
+/* Set KEY in DICT to VALUE.  Return false, with the Python error set,
+   on failure.  */
+
+static bool
+connpy_set_stat (PyObject *dict, const char *key, ULONGEST value)
+{
+  gdbpy_ref<> value_obj = gdb_py_object_from_ulongest (value);
+  if (value_obj == nullptr)
+    return false;
+
+  return PyDict_SetItemString (dict, key, value_obj.get ()) == 0;
+}
+
+/* Implement RemoteTargetConnection.packet_statistics function.  Return
+   a dictionary holding the statistics about the packets exchanged with
+   the target identified by SELF.  */
+
+static PyObject *
+connpy_packet_statistics (PyObject *self, PyObject *args)
+{
+  connection_object *conn = (connection_object *) self;
+
+  CONNPY_REQUIRE_VALID (conn);
+
+  const remote_packet_stats *stats = remote_get_packet_stats (conn->target);
+  gdb_assert (stats != nullptr);
+
+  gdbpy_ref<> result (PyDict_New ());
+  if (result == nullptr
+      || !connpy_set_stat (result.get (), "packets_sent", stats->packets_sent)
+      || !connpy_set_stat (result.get (), "packets_received",
+			   stats->packets_received)
+      || !connpy_set_stat (result.get (), "bytes_sent", stats->bytes_sent)
+      || !connpy_set_stat (result.get (), "bytes_received",
+			   stats->bytes_received)
+      || !connpy_set_stat (result.get (), "notifications",
+			   stats->notifications)
+      || !connpy_set_stat (result.get (), "retransmissions",
+			   stats->retransmissions)
+      || !connpy_set_stat (result.get (), "checksum_failures",
+			   stats->checksum_failures))
+    return nullptr;
+
+  gdbpy_ref<> types (PyDict_New ());
+  if (types == nullptr
+      || PyDict_SetItemString (result.get (), "packet_types",
+			       types.get ()) < 0)
+    return nullptr;
+
+  for (const auto &[name, type] : stats->packet_types)
+    {
+      gdbpy_ref<> type_dict (PyDict_New ());
+      if (type_dict == nullptr
+	  || !connpy_set_stat (type_dict.get (), "count", type.count)
+	  || !connpy_set_stat (type_dict.get (), "bytes_sent", type.bytes_sent)
+	  || !connpy_set_stat (type_dict.get (), "replies", type.replies)
+	  || !connpy_set_stat (type_dict.get (), "bytes_received",
+			       type.bytes_received)
+	  || !connpy_set_stat (type_dict.get (), "total_rtt", type.total_rtt)
+	  || !connpy_set_stat (type_dict.get (), "max_rtt", type.max_rtt))
+	return nullptr;
+
+      gdbpy_ref<> histogram (PyTuple_New (remote_packet_stats::rtt_buckets));
+      if (histogram == nullptr)
+	return nullptr;
+      for (int i = 0; i < remote_packet_stats::rtt_buckets; i++)
+	{
+	  gdbpy_ref<> count
+	    = gdb_py_object_from_ulongest (type.rtt_histogram[i]);
+	  if (count == nullptr)
+	    return nullptr;
+	  PyTuple_SET_ITEM (histogram.get (), i, count.release ());
+	}
+
+      if (PyDict_SetItemString (type_dict.get (), "rtt_histogram",
+				histogram.get ()) < 0
+	  || PyDict_SetItemString (types.get (), name.c_str (),
+				   type_dict.get ()) < 0)
+	return nullptr;
+    }
+
+  return result.release ();
+}
+
+/* Implement RemoteTargetConnection.clear_packet_statistics function.
+   Reset the statistics about the packets exchanged with the target
+   identified by SELF.  */
+
+static PyObject *
+connpy_clear_packet_statistics (PyObject *self, PyObject *args)
+{
+  connection_object *conn = (connection_object *) self;
+
+  CONNPY_REQUIRE_VALID (conn);
+
+  remote_packet_stats *stats = remote_get_packet_stats (conn->target);
+  gdb_assert (stats != nullptr);
+  stats->reset ();
+
+  Py_RETURN_NONE;
+}
+
 /* Global initialization for this file.  */
 
 void _initialize_py_connection ();
@@ -456,6 +558,12 @@ static PyMethodDef remote_connection_object_methods[] =
     METH_VARARGS | METH_KEYWORDS,
     "send_packet (PACKET) -> Bytes\n\
 Send PACKET to a remote target, return the reply as a bytes array." },
+  { "packet_statistics", connpy_packet_statistics, METH_NOARGS,
+    "packet_statistics () -> Dictionary\n\
+Return statistics about the packets exchanged with the remote target." },
+  { "clear_packet_statistics", connpy_clear_packet_statistics, METH_NOARGS,
+    "clear_packet_statistics () -> None\n\
+Reset the statistics about the packets exchanged with the remote target." },
   { NULL }
 };
 
@@ -585,6 +585,37 @@ infpy_read_memory (PyObject *self, PyObject *args, PyObject *kw)
   return gdbpy_buffer_to_membuf (std::move (buffer), addr, length);
 }
 
+/* Implementation of Inferior.map_memory (address, length).  Returns a
+   gdb.MemoryMapping object for LENGTH bytes of the inferior's memory
+   at ADDRESS.  Returns NULL on error, with a python exception set.  */
+static PyObject *
+infpy_map_memory (PyObject *self, PyObject *args, PyObject *kw)
+{
+  inferior_object *inf = (inferior_object *) self;
+  CORE_ADDR addr, length;
+  PyObject *addr_obj, *length_obj;
+  static const char *keywords[] = { "address", "length", NULL };
+
+  INFPY_REQUIRE_VALID (inf);
+
+  if (!gdb_PyArg_ParseTupleAndKeywords (args, kw, "OO", keywords,
+					&addr_obj, &length_obj))
+    return NULL;
+
+  if (get_addr_from_python (addr_obj, &addr) < 0
+      || get_addr_from_python (length_obj, &length) < 0)
+    return NULL;
+
+  if (length == 0)
+    {
+      PyErr_SetString (PyExc_ValueError,
+		       _("Argument 'length' should be greater than zero"));
+      return NULL;
+    }
+
+  return gdbpy_map_memory (inf->inferior, addr, length);
+}
+
 /* Implementation of Inferior.write_memory (address, buffer [, length]).
    Writes the contents of BUFFER (a Python object supporting the read
    buffer protocol) at ADDRESS in the inferior's memory.  Write LENGTH
@@ -1076,6 +1107,10 @@ Return true if this inferior is valid, false if not." },
     METH_VARARGS | METH_KEYWORDS,
     "read_memory (address, length) -> buffer\n\
 Return a buffer object for reading from the inferior's memory." },
+  { "map_memory", (PyCFunction) infpy_map_memory,
+    METH_VARARGS | METH_KEYWORDS,
+    "map_memory (address, length) -> gdb.MemoryMapping\n\
+Return a buffer object mapping a range of the inferior's memory." },
   { "write_memory", (PyCFunction) infpy_write_memory,
     METH_VARARGS | METH_KEYWORDS,
     "write_memory (address, buffer [, length])\n\
@@ -18,6 +18,11 @@
    along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
 
 #include "python-internal.h"
+#include "gdbcore.h"
+#include "inferior.h"
+#include "target-dcache.h"
+#include "target-float.h"
+#include "value.h"
 
 struct membuf_object {
   PyObject_HEAD
@@ -35,6 +40,66 @@ struct membuf_object {
 extern PyTypeObject membuf_object_type
     CPYCHECKER_TYPE_OBJECT_FOR_TYPEDEF ("membuf_object");
 
+/* A gdb.MemoryMapping object.  This keeps a host copy of a range of an
+   inferior's memory, and exports it through the buffer protocol.  The
+   copy is only read again when target memory may have changed since
+   it was filled, i.e. when the target dcache was invalidated or GDB
+   wrote to memory, so scripts can take views of the same range over
+   and over without reading it each time.  */
+
+struct memmap_object {
+  PyObject_HEAD
+
+  /* The number of the inferior whose memory is mapped.  */
+  int inf_num;
+
+  /* The mapped range.  */
+  CORE_ADDR addr;
+  ULONGEST length;
+
+  /* The host copy of the range.  It is allocated the first time it is
+     filled, and then reused for the lifetime of the object, so that
+     views taken earlier see the refreshed contents.  */
+  gdb_byte *buffer;
+
+  /* Whether BUFFER holds the contents of the range, and if so, the
+     process and the target_dcache_generation they were read at.  */
+  bool filled;
+  int pid;
+  ULONGEST generation;
+};
+
+extern PyTypeObject memmap_object_type
+    CPYCHECKER_TYPE_OBJECT_FOR_TYPEDEF ("memmap_object");
+
+/* A read-only, typed view of the contents of an array value, as
+   returned by gdb.Value.to_memoryview.  */
+
+struct valbuf_object {
+  PyObject_HEAD
+
+  /* The value whose contents BUFFER points into, holding a reference,
+     or nullptr if BUFFER is a byte-swapped copy owned by this
+     object.  */
+  struct value *value;
+  gdb_byte *buffer;
+
+  /* The number of octets in BUFFER.  */
+  Py_ssize_t length;
+
+  /* The struct module format of one element, and its size.  */
+  const char *format;
+  Py_ssize_t itemsize;
+
+  /* The number of dimensions, and an array holding their extents
+     followed by their strides.  */
+  int ndim;
+  Py_ssize_t *shape;
+};
+
+extern PyTypeObject valbuf_object_type
+    CPYCHECKER_TYPE_OBJECT_FOR_TYPEDEF ("valbuf_object");
+
 /* Wrap BUFFER, ADDRESS, and LENGTH into a gdb.Membuf object.  ADDRESS is
    the address within the inferior that the contents of BUFFER were read,
    and LENGTH is the number of octets in BUFFER.  */
@@ -96,13 +161,362 @@ get_buffer (PyObject *self, Py_buffer *buf, int flags)
   return ret;
 }
 
+/* Create a gdb.MemoryMapping object for the LENGTH octets of the
+   memory of INF at ADDRESS.  Nothing is read until the contents are
+   first requested.  */
+
+PyObject *
+gdbpy_map_memory (inferior *inf, CORE_ADDR address, ULONGEST length)
+{
+  if (length > PY_SSIZE_T_MAX)
+    {
+      PyErr_SetString (PyExc_ValueError, _("Mapping is too large."));
+      return nullptr;
+    }
+
+  memmap_object *memmap_obj = PyObject_New (memmap_object,
+					    &memmap_object_type);
+  if (memmap_obj == nullptr)
+    return nullptr;
+
+  memmap_obj->inf_num = inf->num;
+  memmap_obj->addr = address;
+  memmap_obj->length = length;
+  memmap_obj->buffer = nullptr;
+  memmap_obj->filled = false;
+  memmap_obj->pid = 0;
+  memmap_obj->generation = 0;
+
+  return (PyObject *) memmap_obj;
+}
+
+/* Make sure the contents of SELF are current, reading them from the
+   inferior if they are not.  Return 0 on success, or -1 with a Python
+   exception set.  */
+
+static int
+mmpy_update (memmap_object *self)
+{
+  inferior *inf = find_inferior_id (self->inf_num);
+  if (inf == nullptr)
+    {
+      PyErr_SetString (PyExc_RuntimeError,
+		       _("Inferior no longer exists."));
+      return -1;
+    }
+
+  if (self->filled
+      && self->pid == inf->pid
+      && self->generation == target_dcache_generation ())
+    return 0;
+
+  if (self->buffer == nullptr)
+    {
+      self->buffer = (gdb_byte *) malloc (self->length);
+      if (self->buffer == nullptr)
+	{
+	  PyErr_NoMemory ();
+	  return -1;
+	}
+    }
+
+  self->filled = false;
+  try
+    {
+      scoped_restore_current_inferior_for_memory restore_inferior (inf);
+
+      read_memory (self->addr, self->buffer, self->length);
+    }
+  catch (const gdb_exception &except)
+    {
+      return gdbpy_handle_gdb_exception (-1, except);
+    }
+
+  self->filled = true;
+  self->pid = inf->pid;
+  self->generation = target_dcache_generation ();
+  return 0;
+}
+
+/* Destructor for gdb.MemoryMapping objects.  */
+
+static void
+mmpy_dealloc (PyObject *self)
+{
+  free (((memmap_object *) self)->buffer);
+  Py_TYPE (self)->tp_free (self);
+}
+
+/* Return a description of the gdb.MemoryMapping object.  */
+
+static PyObject *
+mmpy_str (PyObject *self)
+{
+  memmap_object *memmap_obj = (memmap_object *) self;
+
+  return PyUnicode_FromFormat (_("Memory mapping for address %s, \
+which is %s bytes long."),
+			       paddress (gdbpy_enter::get_gdbarch (),
+					 memmap_obj->addr),
+			       pulongest (memmap_obj->length));
+}
+
+/* Implement the buffer protocol for gdb.MemoryMapping objects.  */
+
+static int
+mmpy_get_buffer (PyObject *self, Py_buffer *buf, int flags)
+{
+  memmap_object *memmap_obj = (memmap_object *) self;
+
+  if (mmpy_update (memmap_obj) < 0)
+    {
+      buf->obj = nullptr;
+      return -1;
+    }
+
+  return PyBuffer_FillInfo (buf, self, memmap_obj->buffer,
+			    memmap_obj->length, 1, flags);
+}
+
+/* Implementation of MemoryMapping.refresh () -> None.  Bring the
+   contents seen by existing views up to date.  */
+
+static PyObject *
+mmpy_refresh (PyObject *self, PyObject *args)
+{
+  if (mmpy_update ((memmap_object *) self) < 0)
+    return nullptr;
+
+  Py_RETURN_NONE;
+}
+
+/* Implementation of MemoryMapping.address.  */
+
+static PyObject *
+mmpy_get_address (PyObject *self, void *closure)
+{
+  memmap_object *memmap_obj = (memmap_object *) self;
+
+  return gdb_py_object_from_ulongest (memmap_obj->addr).release ();
+}
+
+/* Implementation of MemoryMapping.length.  */
+
+static PyObject *
+mmpy_get_length (PyObject *self, void *closure)
+{
+  memmap_object *memmap_obj = (memmap_object *) self;
+
+  return gdb_py_object_from_ulongest (memmap_obj->length).release ();
+}
+
+/* Return the struct module format code for elements of type TYPE, or
+   nullptr if TYPE is not a scalar type the buffer protocol can
+   describe.  */
+
+static const char *
+element_format (struct type *type)
+{
+  ULONGEST len = type->length ();
+
+  switch (type->code ())
+    {
+    case TYPE_CODE_BOOL:
+      return len == 1 ? "?" : nullptr;
+
+    case TYPE_CODE_FLT:
+      {
+	const struct floatformat *fmt = floatformat_from_type (type);
+	enum bfd_endian order = type_byte_order (type);
+
+	if (fmt == floatformats_ieee_half[order])
+	  return "e";
+	if (fmt == floatformats_ieee_single[order])
+	  return "f";
+	if (fmt == floatformats_ieee_double[order])
+	  return "d";
+	return nullptr;
+      }
+
+    case TYPE_CODE_INT:
+    case TYPE_CODE_CHAR:
+    case TYPE_CODE_ENUM:
+    case TYPE_CODE_PTR:
+      {
+	bool is_unsigned = (type->is_unsigned ()
+			    || type->code () == TYPE_CODE_PTR);
+
+	if (type->bit_size_differs_p ())
+	  return nullptr;
+	if (len == sizeof (char))
+	  return is_unsigned ? "B" : "b";
+	if (len == sizeof (short))
+	  return is_unsigned ? "H" : "h";
+	if (len == sizeof (int))
+	  return is_unsigned ? "I" : "i";
+	if (len == sizeof (long long))
+	  return is_unsigned ? "Q" : "q";
+	return nullptr;
+      }
+
+    default:
+      return nullptr;
+    }
+}
+
+/* Return a memoryview of the contents of VALUE, which must be a
+   (possibly multi-dimensional) array of scalars.  The view points
+   directly into the contents of VALUE, unless the target byte order
+   differs from the host's, in which case it is a byte-swapped copy.  */
+
+PyObject *
+gdbpy_value_to_memoryview (struct value *value)
+{
+  std::vector<Py_ssize_t> shape;
+  const char *format;
+  Py_ssize_t itemsize;
+  gdb::array_view<const gdb_byte> contents;
+  gdb::unique_xmalloc_ptr<gdb_byte> swapped;
+
+  try
+    {
+      struct type *type = check_typedef (value->type ());
+
+      while (type->code () == TYPE_CODE_ARRAY)
+	{
+	  struct type *elttype = check_typedef (type->target_type ());
+	  ULONGEST eltlen = elttype->length ();
+
+	  if (eltlen == 0
+	      || (type->bit_stride () != 0
+		  && type->bit_stride () != eltlen * 8))
+	    error (_("Array elements are not contiguous."));
+
+	  shape.push_back (type->length () / eltlen);
+	  type = elttype;
+	}
+
+      if (shape.empty ())
+	error (_("Value is not an array."));
+
+      format = element_format (type);
+      if (format == nullptr)
+	error (_("Array elements of type '%s' cannot be exported."),
+	       type->name () != nullptr ? type->name () : "?");
+      itemsize = type->length ();
+
+      contents = value->contents ();
+
+#if WORDS_BIGENDIAN
+      enum bfd_endian host_order = BFD_ENDIAN_BIG;
+#else
+      enum bfd_endian host_order = BFD_ENDIAN_LITTLE;
+#endif
+      if (itemsize > 1 && type_byte_order (type) != host_order)
+	{
+	  swapped.reset ((gdb_byte *) xmalloc (contents.size ()));
+	  for (size_t i = 0; i < contents.size (); i += itemsize)
+	    std::reverse_copy (&contents[i], &contents[i] + itemsize,
+			       swapped.get () + i);
+	}
+    }
+  catch (const gdb_exception &except)
+    {
+      return gdbpy_handle_gdb_exception (nullptr, except);
+    }
+
+  gdbpy_ref<valbuf_object> valbuf_obj (PyObject_New (valbuf_object,
+						     &valbuf_object_type));
+  if (valbuf_obj == nullptr)
+    return nullptr;
+
+  int ndim = shape.size ();
+  Py_ssize_t *extents = XNEWVEC (Py_ssize_t, 2 * ndim);
+  Py_ssize_t stride = itemsize;
+  for (int i = ndim - 1; i >= 0; i--)
+    {
+      extents[i] = shape[i];
+      extents[ndim + i] = stride;
+      stride *= shape[i];
+    }
+
+  valbuf_obj->shape = extents;
+  valbuf_obj->ndim = ndim;
+  valbuf_obj->format = format;
+  valbuf_obj->itemsize = itemsize;
+  valbuf_obj->length = contents.size ();
+  if (swapped != nullptr)
+    {
+      valbuf_obj->value = nullptr;
+      valbuf_obj->buffer = swapped.release ();
+    }
+  else
+    {
+      value->incref ();
+      valbuf_obj->value = value;
+      valbuf_obj->buffer = const_cast<gdb_byte *> (contents.data ());
+    }
+
+  return PyMemoryView_FromObject ((PyObject *) valbuf_obj.get ());
+}
+
+/* Destructor for value buffer objects.  */
+
+static void
+vbpy_dealloc (PyObject *self)
+{
+  valbuf_object *valbuf_obj = (valbuf_object *) self;
+
+  if (valbuf_obj->value != nullptr)
+    valbuf_obj->value->decref ();
+  else
+    xfree (valbuf_obj->buffer);
+  xfree (valbuf_obj->shape);
+  Py_TYPE (self)->tp_free (self);
+}
+
+/* Implement the buffer protocol for value buffer objects.  */
+
+static int
+vbpy_get_buffer (PyObject *self, Py_buffer *buf, int flags)
+{
+  valbuf_object *valbuf_obj = (valbuf_object *) self;
+
+  if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE)
+    {
+      PyErr_SetString (PyExc_BufferError, _("Value contents are read-only."));
+      buf->obj = nullptr;
+      return -1;
+    }
+
+  buf->buf = valbuf_obj->buffer;
+  buf->obj = self;
+  Py_INCREF (self);
+  buf->len = valbuf_obj->length;
+  buf->readonly = 1;
+  buf->itemsize = valbuf_obj->itemsize;
+  buf->format = ((flags & PyBUF_FORMAT) == PyBUF_FORMAT
+		 ? (char *) valbuf_obj->format : nullptr);
+  buf->ndim = valbuf_obj->ndim;
+  buf->shape = ((flags & PyBUF_ND) == PyBUF_ND
+		? valbuf_obj->shape : nullptr);
+  buf->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES
+		  ? valbuf_obj->shape + valbuf_obj->ndim : nullptr);
+  buf->suboffsets = nullptr;
+  buf->internal = nullptr;
+  return 0;
+}
+
 /* General Python initialization callback.  */
 
 static int CPYCHECKER_NEGATIVE_RESULT_SETS_EXCEPTION
 gdbpy_initialize_membuf (void)
 {
   membuf_object_type.tp_new = PyType_GenericNew;
-  return gdbpy_type_ready (&membuf_object_type);
+  if (gdbpy_type_ready (&membuf_object_type) < 0
+      || gdbpy_type_ready (&memmap_object_type) < 0)
+    return -1;
+  return gdbpy_type_ready (&valbuf_object_type);
 }
 
 GDBPY_INITIALIZE_FILE (gdbpy_initialize_membuf);
@@ -153,3 +567,94 @@ PyTypeObject membuf_object_type = {
   0,				  /* tp_init */
   0,				  /* tp_alloc */
 };
+
+static PyBufferProcs memmap_buffer_procs =
+{
+  mmpy_get_buffer
+};
+
+static gdb_PyGetSetDef memmap_object_getset[] =
+{
+  { "address", mmpy_get_address, nullptr,
+    "The address of the start of the mapped range.", nullptr },
+  { "length", mmpy_get_length, nullptr,
+    "The number of octets in the mapped range.", nullptr },
+  { nullptr }
+};
+
+static PyMethodDef memmap_object_methods[] =
+{
+  { "refresh", mmpy_refresh, METH_NOARGS,
+    "refresh () -> None.\n\
+Read the mapped range again if target memory may have changed." },
+  { nullptr }
+};
+
+PyTypeObject memmap_object_type = {
+  PyVarObject_HEAD_INIT (nullptr, 0)
+  "gdb.MemoryMapping",		  /*tp_name*/
+  sizeof (memmap_object),	  /*tp_basicsize*/
+  0,				  /*tp_itemsize*/
+  mmpy_dealloc,			  /*tp_dealloc*/
+  0,				  /*tp_print*/
+  0,				  /*tp_getattr*/
+  0,				  /*tp_setattr*/
+  0,				  /*tp_compare*/
+  0,				  /*tp_repr*/
+  0,				  /*tp_as_number*/
+  0,				  /*tp_as_sequence*/
+  0,				  /*tp_as_mapping*/
+  0,				  /*tp_hash */
+  0,				  /*tp_call*/
+  mmpy_str,			  /*tp_str*/
+  0,				  /*tp_getattro*/
+  0,				  /*tp_setattro*/
+  &memmap_buffer_procs,		  /*tp_as_buffer*/
+  Py_TPFLAGS_DEFAULT,		  /*tp_flags*/
+  "GDB inferior memory mapping object", /*tp_doc*/
+  0,				  /* tp_traverse */
+  0,				  /* tp_clear */
+  0,				  /* tp_richcompare */
+  0,				  /* tp_weaklistoffset */
+  0,				  /* tp_iter */
+  0,				  /* tp_iternext */
+  memmap_object_methods,	  /* tp_methods */
+  0,				  /* tp_members */
+  memmap_object_getset,		  /* tp_getset */
+  0,				  /* tp_base */
+  0,				  /* tp_dict */
+  0,				  /* tp_descr_get */
+  0,				  /* tp_descr_set */
+  0,				  /* tp_dictoffset */
+  0,				  /* tp_init */
+  0,				  /* tp_alloc */
+};
+
+static PyBufferProcs valbuf_buffer_procs =
+{
+  vbpy_get_buffer
+};
+
+PyTypeObject valbuf_object_type = {
+  PyVarObject_HEAD_INIT (nullptr, 0)
+  "gdb.ValueBuffer",		  /*tp_name*/
+  sizeof (valbuf_object),	  /*tp_basicsize*/
+  0,				  /*tp_itemsize*/
+  vbpy_dealloc,			  /*tp_dealloc*/
+  0,				  /*tp_print*/
+  0,				  /*tp_getattr*/
+  0,				  /*tp_setattr*/
+  0,				  /*tp_compare*/
+  0,				  /*tp_repr*/
+  0,				  /*tp_as_number*/
+  0,				  /*tp_as_sequence*/
+  0,				  /*tp_as_mapping*/
+  0,				  /*tp_hash */
+  0,				  /*tp_call*/
+  0,				  /*tp_str*/
+  0,				  /*tp_getattro*/
+  0,				  /*tp_setattro*/
+  &valbuf_buffer_procs,		  /*tp_as_buffer*/
+  Py_TPFLAGS_DEFAULT,		  /*tp_flags*/
+  "GDB value contents buffer object", /*tp_doc*/
+};
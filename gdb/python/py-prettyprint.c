@@ -25,6 +25,8 @@
 #include "python.h"
 #include "python-internal.h"
 #include "cli/cli-style.h"
+#include "observable.h"
+#include "gdbsupport/unordered_map.h"
 
 extern PyTypeObject printer_object_type;
 
@@ -44,23 +46,22 @@ enum gdbpy_string_repr_result
    printing.  */
 const struct value_print_options *gdbpy_current_print_options;
 
-/* Helper function for find_pretty_printer which iterates over a list,
-   calls each function and inspects output.  This will return a
-   printer object if one recognizes VALUE.  If no printer is found, it
-   will return None.  On error, it will set the Python error and
-   return NULL.  */
+/* Append the enabled pretty-printer lookup functions in LIST to
+   CANDIDATES.  Return false on error, with the Python error set.  */
 
-static gdbpy_ref<>
-search_pp_list (PyObject *list, PyObject *value)
+static bool
+collect_pp_list (PyObject *list, std::vector<gdbpy_ref<>> &candidates)
 {
   Py_ssize_t pp_list_size, list_index;
 
   pp_list_size = PyList_Size (list);
+  if (pp_list_size < 0)
+    return false;
   for (list_index = 0; list_index < pp_list_size; list_index++)
     {
       PyObject *function = PyList_GetItem (list, list_index);
       if (! function)
-	return NULL;
+	return false;
 
       /* Skip if disabled.  */
       if (PyObject_HasAttr (function, gdbpy_enabled_cst))
@@ -69,34 +70,28 @@ search_pp_list (PyObject *list, PyObject *value)
 	  int cmp;
 
 	  if (attr == NULL)
-	    return NULL;
+	    return false;
 	  cmp = PyObject_IsTrue (attr.get ());
 	  if (cmp == -1)
-	    return NULL;
+	    return false;
 
 	  if (!cmp)
 	    continue;
 	}
 
-      gdbpy_ref<> printer (PyObject_CallFunctionObjArgs (function, value,
-							 NULL));
-      if (printer == NULL)
-	return NULL;
-      else if (printer != Py_None)
-	return printer;
+      candidates.push_back (gdbpy_ref<>::new_reference (function));
     }
 
-  return gdbpy_ref<>::new_reference (Py_None);
+  return true;
 }
 
 /* Subroutine of find_pretty_printer to simplify it.
-   Look for a pretty-printer to print VALUE in all objfiles.
-   The result is NULL if there's an error and the search should be terminated.
-   The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
-   Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
+   Collect the enabled lookup functions of all objfiles in the current
+   program space.  Return false if there's an error and the search
+   should be terminated.  */
 
-static PyObject *
-find_pretty_printer_from_objfiles (PyObject *value)
+static bool
+collect_pretty_printers_from_objfiles (std::vector<gdbpy_ref<>> &candidates)
 {
   for (objfile *obj : current_program_space->objfiles ())
     {
@@ -109,55 +104,116 @@ find_pretty_printer_from_objfiles (PyObject *value)
 	}
 
       gdbpy_ref<> pp_list (objfpy_get_printers (objf.get (), NULL));
-      gdbpy_ref<> function (search_pp_list (pp_list.get (), value));
 
       /* If there is an error in any objfile list, abort the search and exit.  */
-      if (function == NULL)
-	return NULL;
-
-      if (function != Py_None)
-	return function.release ();
+      if (pp_list == NULL || !collect_pp_list (pp_list.get (), candidates))
+	return false;
     }
 
-  Py_RETURN_NONE;
+  return true;
 }
 
 /* Subroutine of find_pretty_printer to simplify it.
-   Look for a pretty-printer to print VALUE in the current program space.
-   The result is NULL if there's an error and the search should be terminated.
-   The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
-   Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
+   Collect the enabled lookup functions of the current program space.
+   Return false if there's an error and the search should be
+   terminated.  */
 
-static gdbpy_ref<>
-find_pretty_printer_from_progspace (PyObject *value)
+static bool
+collect_pretty_printers_from_progspace (std::vector<gdbpy_ref<>> &candidates)
 {
   gdbpy_ref<> obj = pspace_to_pspace_object (current_program_space);
 
   if (obj == NULL)
-    return NULL;
+    return false;
   gdbpy_ref<> pp_list (pspy_get_printers (obj.get (), NULL));
-  return search_pp_list (pp_list.get (), value);
+  return pp_list != NULL && collect_pp_list (pp_list.get (), candidates);
 }
 
 /* Subroutine of find_pretty_printer to simplify it.
-   Look for a pretty-printer to print VALUE in the gdb module.
-   The result is NULL if there's an error and the search should be terminated.
-   The result is Py_None, suitably inc-ref'd, if no pretty-printer was found.
-   Otherwise the result is the pretty-printer function, suitably inc-ref'd.  */
+   Collect the enabled lookup functions of the gdb module.  Return
+   false if there's an error and the search should be terminated.  */
 
-static gdbpy_ref<>
-find_pretty_printer_from_gdb (PyObject *value)
+static bool
+collect_pretty_printers_from_gdb (std::vector<gdbpy_ref<>> &candidates)
 {
   /* Fetch the global pretty printer list.  */
   if (gdb_python_module == NULL
       || ! PyObject_HasAttrString (gdb_python_module, "pretty_printers"))
-    return gdbpy_ref<>::new_reference (Py_None);
+    return true;
   gdbpy_ref<> pp_list (PyObject_GetAttrString (gdb_python_module,
 					       "pretty_printers"));
   if (pp_list == NULL || ! PyList_Check (pp_list.get ()))
-    return gdbpy_ref<>::new_reference (Py_None);
+    return true;
+
+  return collect_pp_list (pp_list.get (), candidates);
+}
+
+/* Finding the printer for a value means calling every lookup function
+   in turn until one accepts it, so printing a large container calls
+   all of them again for every element.  To avoid that, the outcome of
+   a search is remembered per type, provided that every lookup function
+   that was called declared, through a true "type_keyed" attribute,
+   that its answer only depends on the type of the value.
+
+   The cache is only valid for the list of enabled lookup functions it
+   was filled with, which is checked on every search, and is cleared
+   when objfiles are loaded or freed, or when
+   gdb.invalidate_cached_pretty_printers is called.  */
+
+struct pp_lookup_cache
+{
+  /* The value of pp_lookup_cache_generation when the cache was
+     filled.  */
+  ULONGEST generation = 0;
+
+  /* The program space, and the enabled lookup functions, in search
+     order, that the cache was filled with.  */
+  program_space *pspace = nullptr;
+  std::vector<gdbpy_ref<>> candidates;
+
+  /* Map a type to the lookup function that accepted values of that
+     type, or to None if none did.  */
+  gdb::unordered_map<struct type *, gdbpy_ref<>> results;
 
-  return search_pp_list (pp_list.get (), value);
+  void clear ()
+  {
+    pspace = nullptr;
+    candidates.clear ();
+    results.clear ();
+  }
+};
+
+static pp_lookup_cache pp_cache;
+
+/* Incremented whenever the cache must be cleared.  This is also done
+   from observers that can run without the GIL, so the cache itself is
+   only cleared the next time it is used.  */
+
+static ULONGEST pp_lookup_cache_generation = 1;
+
+/* Return true if the lookup function FUNCTION declares that whether
+   it accepts a value only depends on the value's type.  */
+
+static bool
+pp_type_keyed_p (PyObject *function)
+{
+  if (!PyObject_HasAttrString (function, "type_keyed"))
+    return false;
+
+  gdbpy_ref<> attr (PyObject_GetAttrString (function, "type_keyed"));
+  if (attr == NULL)
+    {
+      PyErr_Clear ();
+      return false;
+    }
+
+  int cmp = PyObject_IsTrue (attr.get ());
+  if (cmp == -1)
+    {
+      PyErr_Clear ();
+      return false;
+    }
+  return cmp != 0;
 }
 
 /* Find the pretty-printing constructor function for VALUE.  If no
@@ -167,19 +223,89 @@ find_pretty_printer_from_gdb (PyObject *value)
 static gdbpy_ref<>
 find_pretty_printer (PyObject *value)
 {
-  /* Look at the pretty-printer list for each objfile
-     in the current program-space.  */
-  gdbpy_ref<> function (find_pretty_printer_from_objfiles (value));
-  if (function == NULL || function != Py_None)
-    return function;
-
-  /* Look at the pretty-printer list for the current program-space.  */
-  function = find_pretty_printer_from_progspace (value);
-  if (function == NULL || function != Py_None)
-    return function;
-
-  /* Look at the pretty-printer list in the gdb module.  */
-  return find_pretty_printer_from_gdb (value);
+  /* Look at the pretty-printer list for each objfile in the current
+     program-space, then at the list of the current program-space, and
+     last at the list in the gdb module.  */
+  std::vector<gdbpy_ref<>> candidates;
+  if (!collect_pretty_printers_from_objfiles (candidates)
+      || !collect_pretty_printers_from_progspace (candidates)
+      || !collect_pretty_printers_from_gdb (candidates))
+    return NULL;
+
+  if (pp_cache.generation != pp_lookup_cache_generation
+      || pp_cache.pspace != current_program_space
+      || pp_cache.candidates != candidates)
+    {
+      pp_cache.clear ();
+      pp_cache.generation = pp_lookup_cache_generation;
+      pp_cache.pspace = current_program_space;
+      pp_cache.candidates = candidates;
+    }
+
+  struct type *type = value_object_to_value (value)->type ();
+  auto it = pp_cache.results.find (type);
+  if (it != pp_cache.results.end ())
+    {
+      if (it->second == Py_None)
+	return it->second;
+
+      gdbpy_ref<> printer (PyObject_CallFunctionObjArgs (it->second.get (),
+							 value, NULL));
+      if (printer == NULL || printer != Py_None)
+	return printer;
+
+      /* The function did not keep its promise.  Forget about it and
+	 do a full search.  */
+      pp_cache.results.erase (it);
+    }
+
+  bool cacheable = true;
+  for (const gdbpy_ref<> &function : candidates)
+    {
+      cacheable = cacheable && pp_type_keyed_p (function.get ());
+
+      gdbpy_ref<> printer (PyObject_CallFunctionObjArgs (function.get (),
+							 value, NULL));
+      if (printer == NULL)
+	return NULL;
+      else if (printer != Py_None)
+	{
+	  if (cacheable)
+	    pp_cache.results.emplace (type, function);
+	  return printer;
+	}
+    }
+
+  if (cacheable)
+    pp_cache.results.emplace (type,
+			      gdbpy_ref<>::new_reference (Py_None));
+  return gdbpy_ref<>::new_reference (Py_None);
+}
+
+/* Implementation of gdb.invalidate_cached_pretty_printers.  */
+
+PyObject *
+gdbpy_invalidate_cached_pretty_printers (PyObject *self, PyObject *args)
+{
+  pp_lookup_cache_generation++;
+  Py_RETURN_NONE;
+}
+
+/* Observer for objfiles being loaded or freed.  Types may have come or
+   gone, and the objfile's printers with them.  */
+
+static void
+pp_lookup_cache_objfile_changed (struct objfile *objfile)
+{
+  pp_lookup_cache_generation++;
+}
+
+/* Observer for all objfiles of a program space being removed.  */
+
+static void
+pp_lookup_cache_all_objfiles_removed (program_space *pspace)
+{
+  pp_lookup_cache_generation++;
 }
 
 /* Pretty-print a single value, via the printer object PRINTER.
@@ -579,12 +705,17 @@ gdbpy_apply_val_pretty_printer (const struct extension_language_defn *extlang,
   struct gdbarch *gdbarch = type->arch ();
   enum gdbpy_string_repr_result print_result;
 
-  if (value->lazy ())
-    value->fetch_lazy ();
+  /* No pretty-printer support for unavailable values.  Large arrays
+     that are printed without being read as a whole are only checked
+     element by element.  */
+  if (!val_print_array_lazily_p (value, options, language))
+    {
+      if (value->lazy ())
+	value->fetch_lazy ();
 
-  /* No pretty-printer support for unavailable values.  */
-  if (!value->bytes_available (0, type->length ()))
-    return EXT_LANG_RC_NOP;
+      if (!value->bytes_available (0, type->length ()))
+	return EXT_LANG_RC_NOP;
+    }
 
   if (!gdb_python_initialized)
     return EXT_LANG_RC_NOP;
@@ -839,4 +970,25 @@ gdbpy_initialize_prettyprint ()
   return gdbpy_type_ready (&printer_object_type);
 }
 
-GDBPY_INITIALIZE_FILE (gdbpy_initialize_prettyprint);
+/* Drop the references held by the lookup cache.  */
+
+static void
+gdbpy_finalize_prettyprint ()
+{
+  pp_cache.clear ();
+}
+
+GDBPY_INITIALIZE_FILE (gdbpy_initialize_prettyprint,
+		       gdbpy_finalize_prettyprint);
+
+void _initialize_py_prettyprint ();
+void
+_initialize_py_prettyprint ()
+{
+  gdb::observers::new_objfile.attach (pp_lookup_cache_objfile_changed,
+				      "py-prettyprint");
+  gdb::observers::free_objfile.attach (pp_lookup_cache_objfile_changed,
+				       "py-prettyprint");
+  gdb::observers::all_objfiles_removed.attach
+    (pp_lookup_cache_all_objfiles_removed, "py-prettyprint");
+}
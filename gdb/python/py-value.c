@@ -1381,6 +1381,13 @@ valpy_fetch_lazy (PyObject *self, PyObject *args)
   Py_RETURN_NONE;
 }
 
+/* Implements gdb.Value.to_memoryview ().  */
+static PyObject *
+valpy_to_memoryview (PyObject *self, PyObject *args)
+{
+  return gdbpy_value_to_memoryview (((value_object *) self)->value);
+}
+
 /* Calculate and return the address of the PyObject as the value of
    the builtin __hash__ call.  */
 static Py_hash_t
@@ -2246,6 +2253,9 @@ Assign VAL to this value." },
   { "to_array", valpy_to_array, METH_NOARGS,
     "to_array () -> Value\n\
 Return value as an array, if possible." },
+  { "to_memoryview", valpy_to_memoryview, METH_NOARGS,
+    "to_memoryview () -> memoryview\n\
+Return the contents of an array of scalars as a typed memoryview." },
   {NULL}  /* Sentinel */
 };
 
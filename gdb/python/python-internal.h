@@ -23,6 +23,7 @@
 #include "extension.h"
 #include "extension-priv.h"
 #include "registry.h"
+#include "gdbsupport/trace-events.h"
 
 /* These WITH_* macros are defined by the CPython API checker that
    comes with the Python plugin for GCC.  See:
@@ -550,6 +551,9 @@ gdbpy_ref<inferior_object> inferior_to_inferior_object (inferior *inf);
 
 PyObject *gdbpy_buffer_to_membuf (gdb::unique_xmalloc_ptr<gdb_byte> buffer,
 				  CORE_ADDR address, ULONGEST length);
+PyObject *gdbpy_map_memory (inferior *inf, CORE_ADDR address,
+			     ULONGEST length);
+PyObject *gdbpy_value_to_memoryview (struct value *value);
 
 struct process_stratum_target;
 gdbpy_ref<> target_to_connection_object (process_stratum_target *target);
@@ -854,6 +858,10 @@ class gdbpy_enter
      nullptr.  */
   static struct gdbarch *python_gdbarch;
 
+  /* Records the time spent in Python when "maint trace-events" is
+     on.  This is first so that it covers all of the rest.  */
+  gdb::trace_events::scoped_event m_trace_event;
+
   struct active_ext_lang_state *m_previous_active;
   PyGILState_STATE m_state;
   struct gdbarch *m_gdbarch;
@@ -966,6 +974,8 @@ gdbpy_ref<> apply_varobj_pretty_printer (PyObject *print_obj,
 gdbpy_ref<> gdbpy_get_varobj_pretty_printer (struct value *value);
 gdb::unique_xmalloc_ptr<char> gdbpy_get_display_hint (PyObject *printer);
 PyObject *gdbpy_default_visualizer (PyObject *self, PyObject *args);
+PyObject *gdbpy_invalidate_cached_pretty_printers (PyObject *self,
+						   PyObject *args);
 
 PyObject *gdbpy_print_options (PyObject *self, PyObject *args);
 void gdbpy_get_print_options (value_print_options *opts);
@@ -222,7 +222,8 @@ struct gdbarch *gdbpy_enter::python_gdbarch;
 
 gdbpy_enter::gdbpy_enter  (struct gdbarch *gdbarch,
 			   const struct language_defn *language)
-: m_gdbarch (python_gdbarch),
+: m_trace_event ("python", "Python"),
+  m_gdbarch (python_gdbarch),
   m_language (language == nullptr ? nullptr : current_language)
 {
   /* We should not ever enter Python unless initialized.  */
@@ -3081,6 +3082,10 @@ Return a tuple containing all inferiors." },
     "invalidate_cached_frames () -> None.\n\
 Invalidate any cached frame objects in gdb.\n\
 Intended for internal use only." },
+  { "invalidate_cached_pretty_printers",
+    gdbpy_invalidate_cached_pretty_printers, METH_NOARGS,
+    "invalidate_cached_pretty_printers () -> None.\n\
+Forget which pretty-printers were found for which types." },
 
   { "convenience_variable", gdbpy_convenience_variable, METH_VARARGS,
     "convenience_variable (NAME) -> value.\n\
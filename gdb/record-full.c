@@ -47,6 +47,8 @@
 #include "interps.h"
 
 #include <signal.h>
+#include <deque>
+#include <unordered_map>
 
 /* This module implements "target record-full", also known as "process
    record and replay".  This target sits on top of a "normal" target
@@ -70,8 +72,10 @@
 
 #define DEFAULT_RECORD_FULL_INSN_MAX_NUM	200000
 
+#define DEFAULT_RECORD_FULL_CHECKPOINT_INTERVAL	10000
+
 #define RECORD_FULL_IS_REPLAY \
-  (record_full_list->next || ::execution_direction == EXEC_REVERSE)
+  (record_full_list->next () || ::execution_direction == EXEC_REVERSE)
 
 #define RECORD_FULL_FILE_MAGIC	netorder32(0x20091016)
 
@@ -81,41 +85,7 @@
    ("record_full_reg") or a part of memory ("record_full_mem").  And each
    instruction must have a struct record_full_entry ("record_full_end")
    that indicates that this is the last struct record_full_entry of this
-   instruction.
-
-   Each struct record_full_entry is linked to "record_full_list" by "prev"
-   and "next" pointers.  */
-
-struct record_full_mem_entry
-{
-  CORE_ADDR addr;
-  int len;
-  /* Set this flag if target memory for this entry
-     can no longer be accessed.  */
-  int mem_entry_not_accessible;
-  union
-  {
-    gdb_byte *ptr;
-    gdb_byte buf[sizeof (gdb_byte *)];
-  } u;
-};
-
-struct record_full_reg_entry
-{
-  unsigned short num;
-  unsigned short len;
-  union 
-  {
-    gdb_byte *ptr;
-    gdb_byte buf[2 * sizeof (gdb_byte *)];
-  } u;
-};
-
-struct record_full_end_entry
-{
-  enum gdb_signal sigval;
-  ULONGEST insn_num;
-};
+   instruction.  */
 
 enum record_full_type
 {
@@ -126,44 +96,202 @@ enum record_full_type
 
 /* This is the data structure that makes up the execution log.
 
-   The execution log consists of a single linked list of entries
-   of type "struct record_full_entry".  It is doubly linked so that it
-   can be traversed in either direction.
+   The execution log consists of a sequence of variable-length entries
+   of type "struct record_full_entry", stored back to back in large
+   chunks of memory (see struct record_full_chunk below).  Each entry
+   is a small header immediately followed by its payload, so that
+   recording an instruction does not allocate memory of its own, and
+   the log costs little more than the data it holds.  The next and
+   prev methods traverse the log in either direction.
 
-   The start of the list is anchored by a struct called
+   The start of the log is anchored by an entry called
    "record_full_first".  The pointer "record_full_list" either points
-   to the last entry that was added to the list (in record mode), or to
-   the next entry in the list that will be executed (in replay mode).
+   to the last entry that was added to the log (in record mode), or to
+   the next entry in the log that will be executed (in replay mode).
 
-   Each list element (struct record_full_entry), in addition to next
-   and prev pointers, consists of a union of three entry types: mem,
-   reg, and end.  A field called "type" determines which entry type is
-   represented by a given list element.
+   A field called "type" determines which of the three entry types,
+   mem, reg, and end, a given entry is.
 
    Each instruction that is added to the execution log is represented
-   by a variable number of list elements ('entries').  The instruction
-   will have one "reg" entry for each register that is changed by 
-   executing the instruction (including the PC in every case).  It 
-   will also have one "mem" entry for each memory change.  Finally,
-   each instruction will have an "end" entry that separates it from
-   the changes associated with the next instruction.  */
+   by a variable number of entries.  The instruction will have one
+   "reg" entry for each register that is changed by executing the
+   instruction (including the PC in every case).  It will also have
+   one "mem" entry for each memory change.  Finally, each instruction
+   will have an "end" entry that separates it from the changes
+   associated with the next instruction.
+
+   The payload of a "reg" entry is the value of the register, the
+   payload of a "mem" entry is the address followed by the contents of
+   memory, and the payload of an "end" entry is the instruction
+   number.  */
 
 struct record_full_entry
 {
-  struct record_full_entry *prev;
-  struct record_full_entry *next;
-  enum record_full_type type;
-  union
+  /* The size of the previous entry in the same chunk, or 0 if this is
+     the first entry of its chunk.  */
+  uint32_t prev_size;
+
+  /* The type of this entry, an enum record_full_type.  */
+  uint8_t type;
+
+  /* For mem entries, set if target memory for this entry can no longer
+     be accessed.  */
+  uint8_t mem_entry_not_accessible;
+
+  /* The register number of a reg entry, or the signal (an enum
+     gdb_signal) of an end entry.  */
+  uint16_t num;
+
+  /* The length of the value of a reg or mem entry.  */
+  uint32_t len;
+
+  /* Return the entry after this one in the log, or NULL if this is the
+     last entry.  */
+  struct record_full_entry *next ();
+
+  /* Return the entry before this one in the log, or NULL if this is
+     record_full_first.  */
+  struct record_full_entry *prev ();
+
+  /* Return the number of bytes this entry takes in the log.  */
+  size_t size () const;
+
+  /* Return the address of a mem entry.  */
+  CORE_ADDR addr () const
   {
-    /* reg */
-    struct record_full_reg_entry reg;
-    /* mem */
-    struct record_full_mem_entry mem;
-    /* end */
-    struct record_full_end_entry end;
-  } u;
+    CORE_ADDR addr;
+
+    memcpy (&addr, payload (), sizeof (addr));
+    return addr;
+  }
+
+  /* Return the instruction number of an end entry.  */
+  ULONGEST insn_num () const
+  {
+    ULONGEST insn_num;
+
+    memcpy (&insn_num, payload (), sizeof (insn_num));
+    return insn_num;
+  }
+
+  void set_insn_num (ULONGEST insn_num)
+  {
+    memcpy (payload (), &insn_num, sizeof (insn_num));
+  }
+
+  /* Return the signal of an end entry.  */
+  enum gdb_signal sigval () const
+  {
+    return (enum gdb_signal) num;
+  }
+
+  void set_sigval (enum gdb_signal sigval)
+  {
+    num = sigval;
+  }
+
+  /* Return the start of the payload.  */
+  gdb_byte *payload ()
+  { return (gdb_byte *) (this + 1); }
+
+  const gdb_byte *payload () const
+  { return (const gdb_byte *) (this + 1); }
 };
 
+/* Return the number of bytes an entry of type TYPE whose value is LEN
+   bytes long takes in the log.  */
+
+static inline size_t
+record_full_entry_size (enum record_full_type type, size_t len)
+{
+  size_t size = sizeof (struct record_full_entry);
+
+  switch (type)
+    {
+    case record_full_end:
+      size += sizeof (ULONGEST);
+      break;
+    case record_full_reg:
+      size += len;
+      break;
+    case record_full_mem:
+      size += sizeof (CORE_ADDR) + len;
+      break;
+    }
+
+  return align_up (size, alignof (struct record_full_entry));
+}
+
+size_t
+record_full_entry::size () const
+{
+  return record_full_entry_size ((enum record_full_type) type, len);
+}
+
+/* The execution log is stored in chunks of RECORD_FULL_CHUNK_SIZE
+   bytes, aligned to their size, so that the chunk holding an entry can
+   be found from the address of the entry.  An entry too large for a
+   chunk gets a chunk of its own, whose size is a multiple of
+   RECORD_FULL_CHUNK_SIZE.
+
+   Deleting the oldest instructions when the log is full, and deleting
+   the instructions following the replay position when the user
+   changes the past, free whole chunks at a time.  */
+
+#define RECORD_FULL_CHUNK_SIZE	(256 * 1024)
+
+struct record_full_chunk
+{
+  struct record_full_chunk *prev;
+  struct record_full_chunk *next;
+
+  /* The number of bytes available for entries in this chunk.  */
+  size_t capacity;
+
+  /* The number of bytes used by entries.  */
+  size_t used;
+
+  /* The offset of the last entry in the chunk.  Only meaningful if
+     USED is not 0.  */
+  size_t last;
+
+  /* The number of end entries in the chunk.  */
+  size_t num_ends;
+
+  /* Return the start of the entries.  */
+  gdb_byte *data ()
+  { return (gdb_byte *) (this + 1); }
+
+  /* Return the entry at offset OFFSET.  */
+  struct record_full_entry *entry_at (size_t offset)
+  { return (struct record_full_entry *) (data () + offset); }
+
+  /* Return the offset of REC, an entry of this chunk.  */
+  size_t offset_of (struct record_full_entry *rec)
+  { return (gdb_byte *) rec - data (); }
+
+  /* Return true if an entry of SIZE bytes can be appended to this
+     chunk.  The entry must start in the first RECORD_FULL_CHUNK_SIZE
+     bytes so that record_full_chunk_of finds this chunk.  */
+  bool fits (size_t size)
+  {
+    return (sizeof (*this) + used < RECORD_FULL_CHUNK_SIZE
+	    && used + size <= capacity);
+  }
+};
+
+static_assert (sizeof (struct record_full_chunk)
+	       % alignof (struct record_full_entry) == 0);
+
+/* Return the chunk holding REC.  */
+
+static inline struct record_full_chunk *
+record_full_chunk_of (struct record_full_entry *rec)
+{
+  return ((struct record_full_chunk *)
+	  ((uintptr_t) rec & ~(uintptr_t) (RECORD_FULL_CHUNK_SIZE - 1)));
+}
+
 /* If true, query if PREC cannot record memory
    change of next instruction.  */
 bool record_full_memory_query = false;
@@ -180,27 +308,63 @@ static detached_regcache *record_full_core_regbuf = NULL;
 static std::vector<target_section> record_full_core_sections;
 static struct record_full_core_buf_entry *record_full_core_buf_list = NULL;
 
-/* The following variables are used for managing the linked list that
-   represents the execution log.
+/* The following variables are used for managing the execution log.
 
    record_full_first is the anchor that holds down the beginning of
-   the list.
+   the log.  It looks like an end entry whose instruction number is 0,
+   but is not stored in a chunk.
 
    record_full_list serves two functions:
-     1) In record mode, it anchors the end of the list.
-     2) In replay mode, it traverses the list and points to
+     1) In record mode, it anchors the end of the log.
+     2) In replay mode, it traverses the log and points to
 	the next instruction that must be emulated.
 
-   record_full_arch_list_head and record_full_arch_list_tail are used
-   to manage a separate list, which is used to build up the change
-   elements of the currently executing instruction during record mode.
-   When this instruction has been completely annotated in the "arch
-   list", it will be appended to the main execution log.  */
+   record_full_arch_list_head and record_full_arch_list_tail delimit
+   the entries of the currently executing instruction during record
+   mode.  They are stored after the last entry of the log, but are not
+   part of it yet.  When this instruction has been completely
+   annotated in the "arch list", it is committed to the log, or
+   discarded if recording it failed.
+
+   record_full_log_begin and record_full_log_end are the first and
+   last entries of the log, or NULL if the log is empty.
+   record_full_chunk_head and record_full_chunk_tail are the oldest and
+   newest chunks.  */
+
+static struct
+{
+  struct record_full_entry entry;
+  gdb_byte insn_num[sizeof (ULONGEST)];
+} record_full_first_storage;
 
-static struct record_full_entry record_full_first;
+static struct record_full_entry &record_full_first
+  = record_full_first_storage.entry;
 static struct record_full_entry *record_full_list = &record_full_first;
 static struct record_full_entry *record_full_arch_list_head = NULL;
 static struct record_full_entry *record_full_arch_list_tail = NULL;
+static struct record_full_entry *record_full_log_begin = NULL;
+static struct record_full_entry *record_full_log_end = NULL;
+static struct record_full_chunk *record_full_chunk_head = NULL;
+static struct record_full_chunk *record_full_chunk_tail = NULL;
+
+/* Every record_full_checkpoint_interval instructions, the position of
+   the instruction in the log is remembered, so that "record goto" can
+   find an instruction without walking the log from its start.  */
+
+struct record_full_checkpoint
+{
+  /* The instruction number.  */
+  ULONGEST insn_num;
+
+  /* The end entry of the instruction.  */
+  struct record_full_entry *entry;
+};
+
+static unsigned int record_full_checkpoint_interval
+  = DEFAULT_RECORD_FULL_CHECKPOINT_INTERVAL;
+
+/* The checkpoints of the log, oldest first.  */
+static std::deque<record_full_checkpoint> record_full_checkpoints;
 
 /* true ask user. false auto delete the last struct record_full_entry.  */
 static bool record_full_stop_at_limit = true;
@@ -392,64 +556,150 @@ static struct cmd_list_element *record_full_cmdlist;
 static void record_full_goto_insn (struct record_full_entry *entry,
 				   enum exec_direction_kind dir);
 
-/* Alloc and free functions for record_full_reg, record_full_mem, and
-   record_full_end entries.  */
+/* Functions managing the chunks of the execution log, and the
+   record_full_reg, record_full_mem, and record_full_end entries they
+   hold.  */
 
-/* Alloc a record_full_reg record entry.  */
+struct record_full_entry *
+record_full_entry::next ()
+{
+  if (this == record_full_log_end)
+    return NULL;
+  if (this == &record_full_first)
+    return record_full_log_begin;
 
-static inline struct record_full_entry *
-record_full_reg_alloc (struct regcache *regcache, int regnum)
+  struct record_full_chunk *chunk = record_full_chunk_of (this);
+  size_t offset = chunk->offset_of (this) + size ();
+
+  if (offset < chunk->used)
+    return chunk->entry_at (offset);
+  return chunk->next->entry_at (0);
+}
+
+struct record_full_entry *
+record_full_entry::prev ()
 {
-  struct record_full_entry *rec;
-  struct gdbarch *gdbarch = regcache->arch ();
+  if (this == &record_full_first)
+    return NULL;
+  if (this == record_full_log_begin)
+    return &record_full_first;
+  if (prev_size != 0)
+    return (struct record_full_entry *) ((gdb_byte *) this - prev_size);
 
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_reg;
-  rec->u.reg.num = regnum;
-  rec->u.reg.len = register_size (gdbarch, regnum);
-  if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-    rec->u.reg.u.ptr = (gdb_byte *) xmalloc (rec->u.reg.len);
+  struct record_full_chunk *chunk = record_full_chunk_of (this)->prev;
 
-  return rec;
+  if (chunk == NULL)
+    return &record_full_first;
+  return chunk->entry_at (chunk->last);
 }
 
-/* Free a record_full_reg record entry.  */
+/* Allocate a new chunk with room for an entry of SIZE bytes, and
+   append it to the list of chunks.  */
 
-static inline void
-record_full_reg_release (struct record_full_entry *rec)
+static struct record_full_chunk *
+record_full_chunk_new (size_t size)
 {
-  gdb_assert (rec->type == record_full_reg);
-  if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-    xfree (rec->u.reg.u.ptr);
-  xfree (rec);
+  size_t bytes = align_up (sizeof (struct record_full_chunk) + size,
+			   RECORD_FULL_CHUNK_SIZE);
+  void *mem = ::operator new (bytes,
+			      std::align_val_t (RECORD_FULL_CHUNK_SIZE));
+  struct record_full_chunk *chunk = (struct record_full_chunk *) mem;
+
+  chunk->prev = record_full_chunk_tail;
+  chunk->next = NULL;
+  chunk->capacity = bytes - sizeof (struct record_full_chunk);
+  chunk->used = 0;
+  chunk->last = 0;
+  chunk->num_ends = 0;
+
+  if (record_full_chunk_tail != NULL)
+    record_full_chunk_tail->next = chunk;
+  else
+    record_full_chunk_head = chunk;
+  record_full_chunk_tail = chunk;
+
+  return chunk;
 }
 
-/* Alloc a record_full_mem record entry.  */
+/* Free CHUNK.  The caller must have unlinked it.  */
+
+static void
+record_full_chunk_free (struct record_full_chunk *chunk)
+{
+  ::operator delete (chunk, std::align_val_t (RECORD_FULL_CHUNK_SIZE));
+}
+
+/* Add a struct record_full_entry to record_full_arch_list.  */
+
+static void
+record_full_arch_list_add (struct record_full_entry *rec)
+{
+  if (record_debug > 1)
+    gdb_printf (gdb_stdlog,
+		"Process record: record_full_arch_list_add %s.\n",
+		host_address_to_string (rec));
+
+  if (record_full_arch_list_head == NULL)
+    record_full_arch_list_head = rec;
+  record_full_arch_list_tail = rec;
+}
+
+/* Allocate an entry of type TYPE whose value is LEN bytes long after
+   the last entry of the log, and add it to record_full_arch_list.  */
+
+static struct record_full_entry *
+record_full_entry_alloc (enum record_full_type type, size_t len)
+{
+  size_t size = record_full_entry_size (type, len);
+  struct record_full_chunk *chunk = record_full_chunk_tail;
+
+  if (chunk == NULL || !chunk->fits (size))
+    chunk = record_full_chunk_new (size);
+
+  struct record_full_entry *rec = chunk->entry_at (chunk->used);
+
+  rec->prev_size = chunk->used == 0 ? 0 : chunk->used - chunk->last;
+  rec->type = type;
+  rec->mem_entry_not_accessible = 0;
+  rec->num = 0;
+  rec->len = len;
+
+  chunk->last = chunk->used;
+  chunk->used += size;
+  if (type == record_full_end)
+    chunk->num_ends++;
+
+  record_full_arch_list_add (rec);
+
+  return rec;
+}
+
+/* Alloc a record_full_reg record entry.  */
 
 static inline struct record_full_entry *
-record_full_mem_alloc (CORE_ADDR addr, int len)
+record_full_reg_alloc (struct regcache *regcache, int regnum)
 {
   struct record_full_entry *rec;
+  struct gdbarch *gdbarch = regcache->arch ();
 
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_mem;
-  rec->u.mem.addr = addr;
-  rec->u.mem.len = len;
-  if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-    rec->u.mem.u.ptr = (gdb_byte *) xmalloc (len);
+  rec = record_full_entry_alloc (record_full_reg,
+				 register_size (gdbarch, regnum));
+  rec->num = regnum;
 
   return rec;
 }
 
-/* Free a record_full_mem record entry.  */
+/* Alloc a record_full_mem record entry.  */
 
-static inline void
-record_full_mem_release (struct record_full_entry *rec)
+static inline struct record_full_entry *
+record_full_mem_alloc (CORE_ADDR addr, int len)
 {
-  gdb_assert (rec->type == record_full_mem);
-  if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-    xfree (rec->u.mem.u.ptr);
-  xfree (rec);
+  struct record_full_entry *rec;
+
+  rec = record_full_entry_alloc (record_full_mem, len);
+  memcpy (rec->payload (), &addr, sizeof (addr));
+
+  return rec;
 }
 
 /* Alloc a record_full_end record entry.  */
@@ -459,66 +709,139 @@ record_full_end_alloc (void)
 {
   struct record_full_entry *rec;
 
-  rec = XCNEW (struct record_full_entry);
-  rec->type = record_full_end;
+  rec = record_full_entry_alloc (record_full_end, 0);
+  rec->set_insn_num (0);
 
   return rec;
 }
 
-/* Free a record_full_end record entry.  */
+/* Free all the entries stored after REC, which is either
+   record_full_first or an entry of a chunk, whether they are part of
+   the log or of record_full_arch_list.  Return the number of end
+   entries freed.  This only frees whole chunks, and walks the entries
+   of the chunk holding REC.  */
 
-static inline void
-record_full_end_release (struct record_full_entry *rec)
+static ULONGEST
+record_full_truncate (struct record_full_entry *rec)
 {
-  xfree (rec);
-}
+  struct record_full_chunk *chunk = NULL;
+  struct record_full_chunk *next;
+  ULONGEST removed = 0;
 
-/* Free one record entry, any type.
-   Return entry->type, in case caller wants to know.  */
+  if (rec != &record_full_first)
+    {
+      chunk = record_full_chunk_of (rec);
 
-static inline enum record_full_type
-record_full_entry_release (struct record_full_entry *rec)
-{
-  enum record_full_type type = rec->type;
+      size_t offset = chunk->offset_of (rec);
+      size_t used = offset + rec->size ();
 
-  switch (type) {
-  case record_full_reg:
-    record_full_reg_release (rec);
-    break;
-  case record_full_mem:
-    record_full_mem_release (rec);
-    break;
-  case record_full_end:
-    record_full_end_release (rec);
-    break;
-  }
-  return type;
+      for (size_t p = used; p < chunk->used; p += chunk->entry_at (p)->size ())
+	if (chunk->entry_at (p)->type == record_full_end)
+	  removed++;
+
+      chunk->num_ends -= removed;
+      chunk->used = used;
+      chunk->last = offset;
+    }
+
+  for (struct record_full_chunk *c = (chunk != NULL
+				      ? chunk->next : record_full_chunk_head);
+       c != NULL;
+       c = next)
+    {
+      next = c->next;
+      removed += c->num_ends;
+      record_full_chunk_free (c);
+    }
+
+  if (chunk != NULL)
+    chunk->next = NULL;
+  else
+    record_full_chunk_head = NULL;
+  record_full_chunk_tail = chunk;
+
+  return removed;
 }
 
-/* Free all record entries in list pointed to by REC.  */
+/* Free the entries of record_full_arch_list.  */
 
 static void
-record_full_list_release (struct record_full_entry *rec)
+record_full_arch_list_discard (void)
 {
-  if (!rec)
+  if (record_full_arch_list_head == NULL)
     return;
 
-  while (rec->next)
-    rec = rec->next;
+  record_full_truncate (record_full_log_end != NULL
+			? record_full_log_end : &record_full_first);
+  record_full_arch_list_head = NULL;
+  record_full_arch_list_tail = NULL;
+}
 
-  while (rec->prev)
-    {
-      rec = rec->prev;
-      record_full_entry_release (rec->next);
-    }
+/* Free REC, the last entry of record_full_arch_list.  */
 
-  if (rec == &record_full_first)
+static void
+record_full_arch_list_remove_last (struct record_full_entry *rec)
+{
+  gdb_assert (rec == record_full_arch_list_tail);
+
+  if (rec == record_full_arch_list_head)
+    record_full_arch_list_discard ();
+  else
     {
-      record_full_insn_num = 0;
-      record_full_first.next = NULL;
+      record_full_arch_list_tail = rec->prev ();
+      record_full_truncate (record_full_arch_list_tail);
     }
-  else
-    record_full_entry_release (rec);
+}
+
+/* Add a checkpoint for REC, an end entry of the log, if its
+   instruction number calls for one.  */
+
+static void
+record_full_checkpoint_add (struct record_full_entry *rec)
+{
+  ULONGEST insn_num = rec->insn_num ();
+
+  if (record_full_checkpoint_interval != 0
+      && insn_num % record_full_checkpoint_interval == 0)
+    record_full_checkpoints.push_back ({ insn_num, rec });
+}
+
+/* Append the entries of record_full_arch_list to the log, and make
+   record_full_list point to the last one.  */
+
+static void
+record_full_arch_list_commit (void)
+{
+  gdb_assert (record_full_arch_list_head != NULL);
+
+  if (record_full_log_begin == NULL)
+    record_full_log_begin = record_full_arch_list_head;
+  record_full_log_end = record_full_arch_list_tail;
+  record_full_list = record_full_log_end;
+
+  for (struct record_full_entry *rec = record_full_arch_list_head;
+       rec != NULL;
+       rec = rec->next ())
+    if (rec->type == record_full_end)
+      record_full_checkpoint_add (rec);
+
+  record_full_arch_list_head = NULL;
+  record_full_arch_list_tail = NULL;
+}
+
+/* Free all the entries of the log.  */
+
+static void
+record_full_list_release (void)
+{
+  record_full_arch_list_discard ();
+  record_full_truncate (&record_full_first);
+
+  record_full_log_begin = NULL;
+  record_full_log_end = NULL;
+  record_full_list = &record_full_first;
+  record_full_insn_num = 0;
+  record_full_checkpoints.clear ();
 }
 
 /* Free all record entries forward of the given list position.  */
@@ -526,19 +849,32 @@ record_full_list_release (struct record_full_entry *rec)
 static void
 record_full_list_release_following (struct record_full_entry *rec)
 {
-  struct record_full_entry *tmp = rec->next;
+  gdb_assert (record_full_arch_list_head == NULL);
 
-  rec->next = NULL;
-  while (tmp)
+  if (rec->next () == NULL)
+    return;
+
+  ULONGEST removed = record_full_truncate (rec);
+
+  if (rec == &record_full_first)
     {
-      rec = tmp->next;
-      if (record_full_entry_release (tmp) == record_full_end)
-	{
-	  record_full_insn_num--;
-	  record_full_insn_count--;
-	}
-      tmp = rec;
+      record_full_log_begin = NULL;
+      record_full_log_end = NULL;
     }
+  else
+    record_full_log_end = rec;
+
+  /* Drop the checkpoints of the instructions that were freed.  */
+  struct record_full_entry *end = rec;
+
+  while (end->type != record_full_end)
+    end = end->prev ();
+  while (!record_full_checkpoints.empty ()
+	 && record_full_checkpoints.back ().insn_num > end->insn_num ())
+    record_full_checkpoints.pop_back ();
+
+  record_full_insn_num -= removed;
+  record_full_insn_count -= removed;
 }
 
 /* Delete the first instruction from the beginning of the log, to make
@@ -549,51 +885,48 @@ record_full_list_release_following (struct record_full_entry *rec)
 static void
 record_full_list_release_first (void)
 {
-  struct record_full_entry *tmp;
-
-  if (!record_full_first.next)
+  if (record_full_log_begin == NULL)
     return;
 
   /* Loop until a record_full_end.  */
   while (1)
     {
-      /* Cut record_full_first.next out of the linked list.  */
-      tmp = record_full_first.next;
-      record_full_first.next = tmp->next;
-      tmp->next->prev = &record_full_first;
+      struct record_full_entry *rec = record_full_log_begin;
+      struct record_full_chunk *chunk = record_full_chunk_of (rec);
+      uint8_t type = rec->type;
 
-      /* tmp is now isolated, and can be deleted.  */
-      if (record_full_entry_release (tmp) == record_full_end)
-	break;	/* End loop at first record_full_end.  */
-
-      if (!record_full_first.next)
+      if (rec == record_full_log_end)
 	{
-	  gdb_assert (record_full_insn_num == 1);
-	  break;	/* End loop when list is empty.  */
+	  /* The log is now empty.  */
+	  gdb_assert (type == record_full_end || record_full_insn_num == 1);
+	  record_full_truncate (&record_full_first);
+	  record_full_log_begin = NULL;
+	  record_full_log_end = NULL;
+	  record_full_list = &record_full_first;
+	  record_full_checkpoints.clear ();
+	  break;
 	}
-    }
-}
 
-/* Add a struct record_full_entry to record_full_arch_list.  */
+      record_full_log_begin = rec->next ();
+      if (type == record_full_end)
+	{
+	  chunk->num_ends--;
+	  if (!record_full_checkpoints.empty ()
+	      && record_full_checkpoints.front ().entry == rec)
+	    record_full_checkpoints.pop_front ();
+	}
 
-static void
-record_full_arch_list_add (struct record_full_entry *rec)
-{
-  if (record_debug > 1)
-    gdb_printf (gdb_stdlog,
-		"Process record: record_full_arch_list_add %s.\n",
-		host_address_to_string (rec));
+      /* Free the oldest chunk once all its entries are gone.  */
+      if (record_full_chunk_of (record_full_log_begin) != chunk)
+	{
+	  gdb_assert (chunk == record_full_chunk_head);
+	  record_full_chunk_head = chunk->next;
+	  record_full_chunk_head->prev = NULL;
+	  record_full_chunk_free (chunk);
+	}
 
-  if (record_full_arch_list_tail)
-    {
-      record_full_arch_list_tail->next = rec;
-      rec->prev = record_full_arch_list_tail;
-      record_full_arch_list_tail = rec;
-    }
-  else
-    {
-      record_full_arch_list_head = rec;
-      record_full_arch_list_tail = rec;
+      if (type == record_full_end)
+	break;	/* End loop at first record_full_end.  */
     }
 }
 
@@ -603,15 +936,9 @@ record_full_get_loc (struct record_full_entry *rec)
 {
   switch (rec->type) {
   case record_full_mem:
-    if (rec->u.mem.len > sizeof (rec->u.mem.u.buf))
-      return rec->u.mem.u.ptr;
-    else
-      return rec->u.mem.u.buf;
+    return rec->payload () + sizeof (CORE_ADDR);
   case record_full_reg:
-    if (rec->u.reg.len > sizeof (rec->u.reg.u.buf))
-      return rec->u.reg.u.ptr;
-    else
-      return rec->u.reg.u.buf;
+    return rec->payload ();
   case record_full_end:
   default:
     gdb_assert_not_reached ("unexpected record_full_entry type");
@@ -636,8 +963,6 @@ record_full_arch_list_add_reg (struct regcache *regcache, int regnum)
 
   regcache->cooked_read (regnum, record_full_get_loc (rec));
 
-  record_full_arch_list_add (rec);
-
   return 0;
 }
 
@@ -663,12 +988,10 @@ record_full_arch_list_add_mem (CORE_ADDR addr, int len)
   if (record_read_memory (current_inferior ()->arch (), addr,
 			  record_full_get_loc (rec), len))
     {
-      record_full_mem_release (rec);
+      record_full_arch_list_remove_last (rec);
       return -1;
     }
 
-  record_full_arch_list_add (rec);
-
   return 0;
 }
 
@@ -685,10 +1008,8 @@ record_full_arch_list_add_end (void)
 		"Process record: add end to arch list.\n");
 
   rec = record_full_end_alloc ();
-  rec->u.end.sigval = GDB_SIGNAL_0;
-  rec->u.end.insn_num = ++record_full_insn_count;
-
-  record_full_arch_list_add (rec);
+  rec->set_sigval (GDB_SIGNAL_0);
+  rec->set_insn_num (++record_full_insn_count);
 
   return 0;
 }
@@ -724,9 +1045,6 @@ record_full_message (struct regcache *regcache, enum gdb_signal signal)
 
   try
     {
-      record_full_arch_list_head = NULL;
-      record_full_arch_list_tail = NULL;
-
       /* Check record_full_insn_num.  */
       record_full_check_insn_num ();
 
@@ -757,7 +1075,7 @@ record_full_message (struct regcache *regcache, enum gdb_signal signal)
 						      to check */
 	{
 	  gdb_assert (record_full_list->type == record_full_end);
-	  record_full_list->u.end.sigval = signal;
+	  record_full_list->set_sigval (signal);
 	}
 
       if (signal == GDB_SIGNAL_0
@@ -777,13 +1095,11 @@ record_full_message (struct regcache *regcache, enum gdb_signal signal)
     }
   catch (const gdb_exception &ex)
     {
-      record_full_list_release (record_full_arch_list_tail);
+      record_full_arch_list_discard ();
       throw;
     }
 
-  record_full_list->next = record_full_arch_list_head;
-  record_full_arch_list_head->prev = record_full_list;
-  record_full_list = record_full_arch_list_tail;
+  record_full_arch_list_commit ();
 
   if (record_full_insn_num == record_full_insn_max_num)
     record_full_list_release_first ();
@@ -836,57 +1152,57 @@ record_full_exec_insn (struct regcache *regcache,
     {
     case record_full_reg: /* reg */
       {
-	gdb::byte_vector reg (entry->u.reg.len);
+	gdb::byte_vector reg (entry->len);
 
 	if (record_debug > 1)
 	  gdb_printf (gdb_stdlog,
 		      "Process record: record_full_reg %s to "
 		      "inferior num = %d.\n",
 		      host_address_to_string (entry),
-		      entry->u.reg.num);
+		      entry->num);
 
-	regcache->cooked_read (entry->u.reg.num, reg.data ());
-	regcache->cooked_write (entry->u.reg.num, record_full_get_loc (entry));
-	memcpy (record_full_get_loc (entry), reg.data (), entry->u.reg.len);
+	regcache->cooked_read (entry->num, reg.data ());
+	regcache->cooked_write (entry->num, record_full_get_loc (entry));
+	memcpy (record_full_get_loc (entry), reg.data (), entry->len);
       }
       break;
 
     case record_full_mem: /* mem */
       {
 	/* Nothing to do if the entry is flagged not_accessible.  */
-	if (!entry->u.mem.mem_entry_not_accessible)
+	if (!entry->mem_entry_not_accessible)
 	  {
-	    gdb::byte_vector mem (entry->u.mem.len);
+	    gdb::byte_vector mem (entry->len);
 
 	    if (record_debug > 1)
 	      gdb_printf (gdb_stdlog,
 			  "Process record: record_full_mem %s to "
 			  "inferior addr = %s len = %d.\n",
 			  host_address_to_string (entry),
-			  paddress (gdbarch, entry->u.mem.addr),
-			  entry->u.mem.len);
+			  paddress (gdbarch, entry->addr ()),
+			  entry->len);
 
 	    if (record_read_memory (gdbarch,
-				    entry->u.mem.addr, mem.data (),
-				    entry->u.mem.len))
-	      entry->u.mem.mem_entry_not_accessible = 1;
+				    entry->addr (), mem.data (),
+				    entry->len))
+	      entry->mem_entry_not_accessible = 1;
 	    else
 	      {
-		if (target_write_memory (entry->u.mem.addr, 
+		if (target_write_memory (entry->addr (), 
 					 record_full_get_loc (entry),
-					 entry->u.mem.len))
+					 entry->len))
 		  {
-		    entry->u.mem.mem_entry_not_accessible = 1;
+		    entry->mem_entry_not_accessible = 1;
 		    if (record_debug)
 		      warning (_("Process record: error writing memory at "
 				 "addr = %s len = %d."),
-			       paddress (gdbarch, entry->u.mem.addr),
-			       entry->u.mem.len);
+			       paddress (gdbarch, entry->addr ()),
+			       entry->len);
 		  }
 		else
 		  {
 		    memcpy (record_full_get_loc (entry), mem.data (),
-			    entry->u.mem.len);
+			    entry->len);
 
 		    /* We've changed memory --- check if a hardware
 		       watchpoint should trap.  Note that this
@@ -898,7 +1214,7 @@ record_full_exec_insn (struct regcache *regcache,
 		       traps.  */
 		    if (hardware_watchpoint_inserted_in_range
 			(current_inferior ()->aspace.get (),
-			 entry->u.mem.addr, entry->u.mem.len))
+			 entry->addr (), entry->len))
 		      record_full_stop_reason = TARGET_STOPPED_BY_WATCHPOINT;
 		  }
 	      }
@@ -908,6 +1224,240 @@ record_full_exec_insn (struct regcache *regcache,
     }
 }
 
+/* When replaying many instructions at once, applying each entry of
+   the log to the target costs several target accesses per
+   instruction.  Instead, apply them to a host-side copy of the
+   registers and of the memory pages they touch, and write the result
+   back to the target only once, when replay stops.  This makes going
+   back or forth over millions of instructions a matter of seconds.
+
+   Only the state that breakpoint and watchpoint checks need is looked
+   at during replay: the PC, which lives in the register cache, and the
+   addresses of memory changes.  */
+
+#define RECORD_FULL_PAGE_SIZE	4096
+
+class record_full_replay
+{
+public:
+  explicit record_full_replay (struct regcache *regcache)
+    : m_regcache (regcache),
+      m_gdbarch (regcache->arch ())
+  {}
+
+  DISABLE_COPY_AND_ASSIGN (record_full_replay);
+
+  /* Swap the value recorded in ENTRY with the current state, like
+     record_full_exec_insn, without writing to the target.  */
+  void exec (struct record_full_entry *entry);
+
+  /* Write the registers and memory changed since the last call to the
+     target.  */
+  void flush ();
+
+private:
+  /* A copy of a page of target memory.  */
+  struct page
+  {
+    gdb_byte data[RECORD_FULL_PAGE_SIZE];
+
+    /* The range of DATA that differs from target memory.  */
+    size_t dirty_begin = RECORD_FULL_PAGE_SIZE;
+    size_t dirty_end = 0;
+  };
+
+  /* Return the copy of the page at ADDR, reading it from the target
+     if necessary.  Return NULL if it can't be read.  */
+  page *get_page (CORE_ADDR addr);
+
+  /* Write the pages overlapping ADDR and LEN to the target, and forget
+     them.  */
+  void flush_range (CORE_ADDR addr, ULONGEST len);
+
+  /* Write PAGE, at ADDR, to the target.  */
+  void write_page (CORE_ADDR addr, page *page);
+
+  struct regcache *m_regcache;
+  struct gdbarch *m_gdbarch;
+
+  /* The pages read so far, by address.  NULL for pages that could not
+     be read.  */
+  std::unordered_map<CORE_ADDR, std::unique_ptr<page>> m_pages;
+
+  /* The raw registers changed since the last flush, and the values
+     the target has for them.  */
+  std::unordered_map<int, gdb::byte_vector> m_saved_regs;
+};
+
+record_full_replay::page *
+record_full_replay::get_page (CORE_ADDR addr)
+{
+  auto it = m_pages.find (addr);
+
+  if (it != m_pages.end ())
+    return it->second.get ();
+
+  std::unique_ptr<page> p (new page);
+
+  if (record_read_memory (m_gdbarch, addr, p->data, RECORD_FULL_PAGE_SIZE))
+    p.reset ();
+
+  return m_pages.emplace (addr, std::move (p)).first->second.get ();
+}
+
+void
+record_full_replay::write_page (CORE_ADDR addr, page *page)
+{
+  if (page == NULL || page->dirty_begin >= page->dirty_end)
+    return;
+
+  if (target_write_memory (addr + page->dirty_begin,
+			   page->data + page->dirty_begin,
+			   page->dirty_end - page->dirty_begin)
+      && record_debug)
+    warning (_("Process record: error writing memory at "
+	       "addr = %s len = %s."),
+	     paddress (m_gdbarch, addr + page->dirty_begin),
+	     pulongest (page->dirty_end - page->dirty_begin));
+
+  page->dirty_begin = RECORD_FULL_PAGE_SIZE;
+  page->dirty_end = 0;
+}
+
+void
+record_full_replay::flush_range (CORE_ADDR addr, ULONGEST len)
+{
+  CORE_ADDR first = align_down (addr, RECORD_FULL_PAGE_SIZE);
+
+  for (CORE_ADDR a = first; a < addr + len; a += RECORD_FULL_PAGE_SIZE)
+    {
+      auto it = m_pages.find (a);
+
+      if (it != m_pages.end ())
+	{
+	  write_page (a, it->second.get ());
+	  m_pages.erase (it);
+	}
+    }
+}
+
+void
+record_full_replay::exec (struct record_full_entry *entry)
+{
+  switch (entry->type)
+    {
+    case record_full_reg: /* reg */
+      {
+	int regnum = entry->num;
+
+	/* Pseudo registers are written through to the target.  */
+	if (regnum >= gdbarch_num_regs (m_gdbarch))
+	  {
+	    flush ();
+	    record_full_exec_insn (m_regcache, m_gdbarch, entry);
+	    break;
+	  }
+
+	gdb::byte_vector reg (entry->len);
+
+	if (record_debug > 1)
+	  gdb_printf (gdb_stdlog,
+		      "Process record: record_full_reg %s to "
+		      "inferior num = %d.\n",
+		      host_address_to_string (entry),
+		      entry->num);
+
+	m_regcache->raw_read (regnum, reg.data ());
+	if (m_saved_regs.find (regnum) == m_saved_regs.end ())
+	  m_saved_regs.emplace (regnum, reg);
+	m_regcache->raw_supply (regnum, record_full_get_loc (entry));
+	memcpy (record_full_get_loc (entry), reg.data (), entry->len);
+      }
+      break;
+
+    case record_full_mem: /* mem */
+      {
+	/* Nothing to do if the entry is flagged not_accessible.  */
+	if (entry->mem_entry_not_accessible)
+	  break;
+
+	CORE_ADDR addr = entry->addr ();
+	ULONGEST len = entry->len;
+	CORE_ADDR first = align_down (addr, RECORD_FULL_PAGE_SIZE);
+	bool readable = true;
+
+	if (record_debug > 1)
+	  gdb_printf (gdb_stdlog,
+		      "Process record: record_full_mem %s to "
+		      "inferior addr = %s len = %d.\n",
+		      host_address_to_string (entry),
+		      paddress (m_gdbarch, addr), entry->len);
+
+	for (CORE_ADDR a = first; a < addr + len; a += RECORD_FULL_PAGE_SIZE)
+	  if (get_page (a) == NULL)
+	    readable = false;
+
+	/* Some targets can read the memory of the entry but not the
+	   whole page.  Write the entry to the target directly.  */
+	if (!readable)
+	  {
+	    flush_range (addr, len);
+	    record_full_exec_insn (m_regcache, m_gdbarch, entry);
+	    break;
+	  }
+
+	gdb_byte *loc = record_full_get_loc (entry);
+
+	for (CORE_ADDR a = first; a < addr + len; a += RECORD_FULL_PAGE_SIZE)
+	  {
+	    page *p = get_page (a);
+	    CORE_ADDR begin = std::max (a, addr);
+	    CORE_ADDR end = std::min (a + RECORD_FULL_PAGE_SIZE, addr + len);
+	    size_t offset = begin - a;
+	    size_t n = end - begin;
+	    gdb_byte tmp[RECORD_FULL_PAGE_SIZE];
+
+	    memcpy (tmp, p->data + offset, n);
+	    memcpy (p->data + offset, loc + (begin - addr), n);
+	    memcpy (loc + (begin - addr), tmp, n);
+
+	    p->dirty_begin = std::min (p->dirty_begin, offset);
+	    p->dirty_end = std::max (p->dirty_end, offset + n);
+	  }
+
+	/* We've changed memory --- check if a hardware watchpoint
+	   should trap.  See record_full_exec_insn.  */
+	if (hardware_watchpoint_inserted_in_range
+	    (current_inferior ()->aspace.get (), addr, len))
+	  record_full_stop_reason = TARGET_STOPPED_BY_WATCHPOINT;
+      }
+      break;
+    }
+}
+
+void
+record_full_replay::flush ()
+{
+  for (auto &it : m_pages)
+    write_page (it.first, it.second.get ());
+  m_pages.clear ();
+
+  for (auto &it : m_saved_regs)
+    {
+      int regnum = it.first;
+      gdb::byte_vector value (it.second.size ());
+
+      /* Put back the value the target has, so that raw_write sees the
+	 change.  */
+      m_regcache->raw_collect (regnum, value.data ());
+      if (memcmp (value.data (), it.second.data (), value.size ()) == 0)
+	continue;
+      m_regcache->raw_supply (regnum, it.second.data ());
+      m_regcache->raw_write (regnum, value);
+    }
+  m_saved_regs.clear ();
+}
+
 static void record_full_restore (void);
 
 /* Asynchronous signal handle registered as event loop source for when
@@ -985,7 +1535,7 @@ record_full_open (const char *args, int from_tty)
   record_full_insn_num = 0;
   record_full_insn_count = 0;
   record_full_list = &record_full_first;
-  record_full_list->next = NULL;
+  gdb_assert (record_full_log_begin == NULL);
 
   if (current_program_space->core_bfd ())
     record_full_core_open_1 ();
@@ -1012,7 +1562,7 @@ record_full_base_target::close ()
   if (record_debug)
     gdb_printf (gdb_stdlog, "Process record: record_full_close\n");
 
-  record_full_list_release (record_full_list);
+  record_full_list_release ();
 
   /* Release record_full_core_regbuf.  */
   if (record_full_core_regbuf)
@@ -1309,6 +1859,7 @@ record_full_wait_1 (struct target_ops *ops,
       const address_space *aspace = current_inferior ()->aspace.get ();
       int continue_flag = 1;
       int first_record_full_end = 1;
+      record_full_replay replay (regcache);
 
       try
 	{
@@ -1341,8 +1892,8 @@ record_full_wait_1 (struct target_ops *ops,
 
 	  /* In EXEC_FORWARD mode, record_full_list points to the tail of prev
 	     instruction.  */
-	  if (execution_direction == EXEC_FORWARD && record_full_list->next)
-	    record_full_list = record_full_list->next;
+	  if (execution_direction == EXEC_FORWARD && record_full_list->next ())
+	    record_full_list = record_full_list->next ();
 
 	  /* Loop over the record_full_list, looking for the next place to
 	     stop.  */
@@ -1357,14 +1908,14 @@ record_full_wait_1 (struct target_ops *ops,
 		  break;
 		}
 	      if (execution_direction != EXEC_REVERSE
-		  && !record_full_list->next)
+		  && !record_full_list->next ())
 		{
 		  /* Hit end of record log going forward.  */
 		  status->set_no_history ();
 		  break;
 		}
 
-	      record_full_exec_insn (regcache, gdbarch, record_full_list);
+	      replay.exec (record_full_list);
 
 	      if (record_full_list->type == record_full_end)
 		{
@@ -1422,7 +1973,7 @@ record_full_wait_1 (struct target_ops *ops,
 			  continue_flag = 0;
 			}
 		      /* Check target signal */
-		      if (record_full_list->u.end.sigval != GDB_SIGNAL_0)
+		      if (record_full_list->sigval () != GDB_SIGNAL_0)
 			/* FIXME: better way to check */
 			continue_flag = 0;
 		    }
@@ -1432,39 +1983,50 @@ record_full_wait_1 (struct target_ops *ops,
 		{
 		  if (execution_direction == EXEC_REVERSE)
 		    {
-		      if (record_full_list->prev)
-			record_full_list = record_full_list->prev;
+		      if (record_full_list->prev ())
+			record_full_list = record_full_list->prev ();
 		    }
 		  else
 		    {
-		      if (record_full_list->next)
-			record_full_list = record_full_list->next;
+		      if (record_full_list->next ())
+			record_full_list = record_full_list->next ();
 		    }
 		}
 	    }
 	  while (continue_flag);
 
 	replay_out:
+	  replay.flush ();
+
 	  if (status->kind () == TARGET_WAITKIND_STOPPED)
 	    {
 	      if (record_full_get_sig)
 		status->set_stopped (GDB_SIGNAL_INT);
-	      else if (record_full_list->u.end.sigval != GDB_SIGNAL_0)
+	      else if (record_full_list->sigval () != GDB_SIGNAL_0)
 		/* FIXME: better way to check */
-		status->set_stopped (record_full_list->u.end.sigval);
+		status->set_stopped (record_full_list->sigval ());
 	      else
 		status->set_stopped (GDB_SIGNAL_TRAP);
 	    }
 	}
       catch (const gdb_exception &ex)
 	{
+	  try
+	    {
+	      replay.flush ();
+	    }
+	  catch (const gdb_exception_error &flush_ex)
+	    {
+	      exception_print (gdb_stderr, flush_ex);
+	    }
+
 	  if (execution_direction == EXEC_REVERSE)
 	    {
-	      if (record_full_list->next)
-		record_full_list = record_full_list->next;
+	      if (record_full_list->next ())
+		record_full_list = record_full_list->next ();
 	    }
 	  else
-	    record_full_list = record_full_list->prev;
+	    record_full_list = record_full_list->prev ();
 
 	  throw;
 	}
@@ -1552,9 +2114,6 @@ record_full_registers_change (struct regcache *regcache, int regnum)
   /* Check record_full_insn_num.  */
   record_full_check_insn_num ();
 
-  record_full_arch_list_head = NULL;
-  record_full_arch_list_tail = NULL;
-
   if (regnum < 0)
     {
       int i;
@@ -1563,7 +2122,7 @@ record_full_registers_change (struct regcache *regcache, int regnum)
 	{
 	  if (record_full_arch_list_add_reg (regcache, i))
 	    {
-	      record_full_list_release (record_full_arch_list_tail);
+	      record_full_arch_list_discard ();
 	      error (_("Process record: failed to record execution log."));
 	    }
 	}
@@ -1572,18 +2131,16 @@ record_full_registers_change (struct regcache *regcache, int regnum)
     {
       if (record_full_arch_list_add_reg (regcache, regnum))
 	{
-	  record_full_list_release (record_full_arch_list_tail);
+	  record_full_arch_list_discard ();
 	  error (_("Process record: failed to record execution log."));
 	}
     }
   if (record_full_arch_list_add_end ())
     {
-      record_full_list_release (record_full_arch_list_tail);
+      record_full_arch_list_discard ();
       error (_("Process record: failed to record execution log."));
     }
-  record_full_list->next = record_full_arch_list_head;
-  record_full_arch_list_head->prev = record_full_list;
-  record_full_list = record_full_arch_list_tail;
+  record_full_arch_list_commit ();
 
   if (record_full_insn_num == record_full_insn_max_num)
     record_full_list_release_first ();
@@ -1677,11 +2234,9 @@ record_full_target::xfer_partial (enum target_object object,
       record_full_check_insn_num ();
 
       /* Record registers change to list as an instruction.  */
-      record_full_arch_list_head = NULL;
-      record_full_arch_list_tail = NULL;
       if (record_full_arch_list_add_mem (offset, len))
 	{
-	  record_full_list_release (record_full_arch_list_tail);
+	  record_full_arch_list_discard ();
 	  if (record_debug)
 	    gdb_printf (gdb_stdlog,
 			"Process record: failed to record "
@@ -1690,16 +2245,14 @@ record_full_target::xfer_partial (enum target_object object,
 	}
       if (record_full_arch_list_add_end ())
 	{
-	  record_full_list_release (record_full_arch_list_tail);
+	  record_full_arch_list_discard ();
 	  if (record_debug)
 	    gdb_printf (gdb_stdlog,
 			"Process record: failed to record "
 			"execution log.");
 	  return TARGET_XFER_E_IO;
 	}
-      record_full_list->next = record_full_arch_list_head;
-      record_full_arch_list_head->prev = record_full_list;
-      record_full_list = record_full_arch_list_tail;
+      record_full_arch_list_commit ();
 
       if (record_full_insn_num == record_full_insn_max_num)
 	record_full_list_release_first ();
@@ -1862,7 +2415,7 @@ record_full_base_target::get_bookmark (const char *args, int from_tty)
 
   /* Return stringified form of instruction count.  */
   if (record_full_list && record_full_list->type == record_full_end)
-    ret = xstrdup (pulongest (record_full_list->u.end.insn_num));
+    ret = xstrdup (pulongest (record_full_list->insn_num ()));
 
   if (record_debug)
     {
@@ -1926,9 +2479,9 @@ record_full_base_target::info_record ()
     gdb_printf (_("Record mode:\n"));
 
   /* Find entry for first actual instruction in the log.  */
-  for (p = record_full_first.next;
+  for (p = record_full_first.next ();
        p != NULL && p->type != record_full_end;
-       p = p->next)
+       p = p->next ())
     ;
 
   /* Do we have a log at all?  */
@@ -1936,12 +2489,12 @@ record_full_base_target::info_record ()
     {
       /* Display instruction number for first instruction in the log.  */
       gdb_printf (_("Lowest recorded instruction number is %s.\n"),
-		  pulongest (p->u.end.insn_num));
+		  pulongest (p->insn_num ()));
 
       /* If in replay mode, display where we are in the log.  */
       if (RECORD_FULL_IS_REPLAY)
 	gdb_printf (_("Current instruction number is %s.\n"),
-		    pulongest (record_full_list->u.end.insn_num));
+		    pulongest (record_full_list->insn_num ()));
 
       /* Display instruction number for last instruction in the log.  */
       gdb_printf (_("Highest recorded instruction number is %s.\n"),
@@ -2002,16 +2555,16 @@ record_full_goto_entry (struct record_full_entry *p)
     error (_("Target insn not found."));
   else if (p == record_full_list)
     error (_("Already at target insn."));
-  else if (p->u.end.insn_num > record_full_list->u.end.insn_num)
+  else if (p->insn_num () > record_full_list->insn_num ())
     {
       gdb_printf (_("Go forward to insn number %s\n"),
-		  pulongest (p->u.end.insn_num));
+		  pulongest (p->insn_num ()));
       record_full_goto_insn (p, EXEC_FORWARD);
     }
   else
     {
       gdb_printf (_("Go backward to insn number %s\n"),
-		  pulongest (p->u.end.insn_num));
+		  pulongest (p->insn_num ()));
       record_full_goto_insn (p, EXEC_REVERSE);
     }
 
@@ -2030,7 +2583,7 @@ record_full_base_target::goto_record_begin ()
 {
   struct record_full_entry *p = NULL;
 
-  for (p = &record_full_first; p != NULL; p = p->next)
+  for (p = &record_full_first; p != NULL; p = p->next ())
     if (p->type == record_full_end)
       break;
 
@@ -2044,9 +2597,8 @@ record_full_base_target::goto_record_end ()
 {
   struct record_full_entry *p = NULL;
 
-  for (p = record_full_list; p->next != NULL; p = p->next)
-    ;
-  for (; p!= NULL; p = p->prev)
+  p = record_full_log_end != NULL ? record_full_log_end : &record_full_first;
+  for (; p!= NULL; p = p->prev ())
     if (p->type == record_full_end)
       break;
 
@@ -2058,10 +2610,21 @@ record_full_base_target::goto_record_end ()
 void
 record_full_base_target::goto_record (ULONGEST target_insn)
 {
-  struct record_full_entry *p = NULL;
-
-  for (p = &record_full_first; p != NULL; p = p->next)
-    if (p->type == record_full_end && p->u.end.insn_num == target_insn)
+  struct record_full_entry *p = &record_full_first;
+
+  /* Start from the closest checkpoint before TARGET_INSN.  */
+  auto it = std::upper_bound (record_full_checkpoints.begin (),
+			      record_full_checkpoints.end (), target_insn,
+			      [] (ULONGEST insn_num,
+				  const record_full_checkpoint &cp)
+			      {
+				return insn_num < cp.insn_num;
+			      });
+  if (it != record_full_checkpoints.begin ())
+    p = std::prev (it)->entry;
+
+  for (; p != NULL; p = p->next ())
+    if (p->type == record_full_end && p->insn_num () == target_insn)
       break;
 
   record_full_goto_entry (p);
@@ -2348,7 +2911,7 @@ record_full_restore (void)
     return;
 
   /* "record_full_restore" can only be called when record list is empty.  */
-  gdb_assert (record_full_first.next == NULL);
+  gdb_assert (record_full_log_begin == NULL);
  
   if (record_debug)
     gdb_printf (gdb_stdlog, "Restoring recording from core file.\n");
@@ -2378,8 +2941,6 @@ record_full_restore (void)
 
   /* Restore the entries in recfd into record_full_arch_list_head and
      record_full_arch_list_tail.  */
-  record_full_arch_list_head = NULL;
-  record_full_arch_list_tail = NULL;
   record_full_insn_num = 0;
 
   try
@@ -2410,16 +2971,16 @@ record_full_restore (void)
 
 	      /* Get val.  */
 	      bfdcore_read (current_program_space->core_bfd (), osec,
-			    record_full_get_loc (rec), rec->u.reg.len,
+			    record_full_get_loc (rec), rec->len,
 			    &bfd_offset);
 
 	      if (record_debug)
 		gdb_printf (gdb_stdlog,
 			    "  Reading register %d (1 "
 			    "plus %lu plus %d bytes)\n",
-			    rec->u.reg.num,
+			    rec->num,
 			    (unsigned long) sizeof (regnum),
-			    rec->u.reg.len);
+			    rec->len);
 	      break;
 
 	    case record_full_mem: /* mem */
@@ -2437,7 +2998,7 @@ record_full_restore (void)
 
 	      /* Get val.  */
 	      bfdcore_read (current_program_space->core_bfd (), osec,
-			    record_full_get_loc (rec), rec->u.mem.len,
+			    record_full_get_loc (rec), rec->len,
 			    &bfd_offset);
 
 	      if (record_debug)
@@ -2445,10 +3006,10 @@ record_full_restore (void)
 			    "  Reading memory %s (1 plus "
 			    "%lu plus %lu plus %d bytes)\n",
 			    paddress (get_current_arch (),
-				      rec->u.mem.addr),
+				      rec->addr ()),
 			    (unsigned long) sizeof (addr),
 			    (unsigned long) sizeof (len),
-			    rec->u.mem.len);
+			    rec->len);
 	      break;
 
 	    case record_full_end: /* end */
@@ -2459,13 +3020,13 @@ record_full_restore (void)
 	      bfdcore_read (current_program_space->core_bfd (), osec, &signal,
 			    sizeof (signal), &bfd_offset);
 	      signal = netorder32 (signal);
-	      rec->u.end.sigval = (enum gdb_signal) signal;
+	      rec->set_sigval ((enum gdb_signal) signal);
 
 	      /* Get insn count.  */
 	      bfdcore_read (current_program_space->core_bfd (), osec, &count,
 			    sizeof (count), &bfd_offset);
 	      count = netorder32 (count);
-	      rec->u.end.insn_num = count;
+	      rec->set_insn_num (count);
 	      record_full_insn_count = count + 1;
 	      if (record_debug)
 		gdb_printf (gdb_stdlog,
@@ -2482,21 +3043,17 @@ record_full_restore (void)
 		     bfd_get_filename (current_program_space->core_bfd ()));
 	      break;
 	    }
-
-	  /* Add rec to record arch list.  */
-	  record_full_arch_list_add (rec);
 	}
     }
   catch (const gdb_exception &ex)
     {
-      record_full_list_release (record_full_arch_list_tail);
+      record_full_arch_list_discard ();
       throw;
     }
 
   /* Add record_full_arch_list_head to the end of record list.  */
-  record_full_first.next = record_full_arch_list_head;
-  record_full_arch_list_head->prev = &record_full_first;
-  record_full_arch_list_tail->next = NULL;
+  if (record_full_arch_list_head != NULL)
+    record_full_arch_list_commit ();
   record_full_list = &record_full_first;
 
   /* Update record_full_insn_max_num.  */
@@ -2575,32 +3132,34 @@ record_full_base_target::save_record (const char *recfilename)
     = record_full_gdb_operation_disable_set ();
 
   /* Reverse execute to the begin of record list.  */
+  record_full_replay replay (regcache);
   while (1)
     {
       /* Check for beginning and end of log.  */
       if (record_full_list == &record_full_first)
 	break;
 
-      record_full_exec_insn (regcache, gdbarch, record_full_list);
+      replay.exec (record_full_list);
 
-      if (record_full_list->prev)
-	record_full_list = record_full_list->prev;
+      if (record_full_list->prev ())
+	record_full_list = record_full_list->prev ();
     }
+  replay.flush ();
 
   /* Compute the size needed for the extra bfd section.  */
   save_size = 4;	/* magic cookie */
-  for (record_full_list = record_full_first.next; record_full_list;
-       record_full_list = record_full_list->next)
+  for (record_full_list = record_full_first.next (); record_full_list;
+       record_full_list = record_full_list->next ())
     switch (record_full_list->type)
       {
       case record_full_end:
 	save_size += 1 + 4 + 4;
 	break;
       case record_full_reg:
-	save_size += 1 + 4 + record_full_list->u.reg.len;
+	save_size += 1 + 4 + record_full_list->len;
 	break;
       case record_full_mem:
-	save_size += 1 + 4 + 8 + record_full_list->u.mem.len;
+	save_size += 1 + 4 + 8 + record_full_list->len;
 	break;
       }
 
@@ -2651,19 +3210,19 @@ record_full_base_target::save_record (const char *recfilename)
 		gdb_printf (gdb_stdlog,
 			    "  Writing register %d (1 "
 			    "plus %lu plus %d bytes)\n",
-			    record_full_list->u.reg.num,
+			    record_full_list->num,
 			    (unsigned long) sizeof (regnum),
-			    record_full_list->u.reg.len);
+			    record_full_list->len);
 
 	      /* Write regnum.  */
-	      regnum = netorder32 (record_full_list->u.reg.num);
+	      regnum = netorder32 (record_full_list->num);
 	      bfdcore_write (obfd.get (), osec, &regnum,
 			     sizeof (regnum), &bfd_offset);
 
 	      /* Write regval.  */
 	      bfdcore_write (obfd.get (), osec,
 			     record_full_get_loc (record_full_list),
-			     record_full_list->u.reg.len, &bfd_offset);
+			     record_full_list->len, &bfd_offset);
 	      break;
 
 	    case record_full_mem: /* mem */
@@ -2672,25 +3231,25 @@ record_full_base_target::save_record (const char *recfilename)
 			    "  Writing memory %s (1 plus "
 			    "%lu plus %lu plus %d bytes)\n",
 			    paddress (gdbarch,
-				      record_full_list->u.mem.addr),
+				      record_full_list->addr ()),
 			    (unsigned long) sizeof (addr),
 			    (unsigned long) sizeof (len),
-			    record_full_list->u.mem.len);
+			    record_full_list->len);
 
 	      /* Write memlen.  */
-	      len = netorder32 (record_full_list->u.mem.len);
+	      len = netorder32 (record_full_list->len);
 	      bfdcore_write (obfd.get (), osec, &len, sizeof (len),
 			     &bfd_offset);
 
 	      /* Write memaddr.  */
-	      addr = netorder64 (record_full_list->u.mem.addr);
+	      addr = netorder64 (record_full_list->addr ());
 	      bfdcore_write (obfd.get (), osec, &addr, 
 			     sizeof (addr), &bfd_offset);
 
 	      /* Write memval.  */
 	      bfdcore_write (obfd.get (), osec,
 			     record_full_get_loc (record_full_list),
-			     record_full_list->u.mem.len, &bfd_offset);
+			     record_full_list->len, &bfd_offset);
 	      break;
 
 	      case record_full_end:
@@ -2701,12 +3260,12 @@ record_full_base_target::save_record (const char *recfilename)
 			      (unsigned long) sizeof (signal),
 			      (unsigned long) sizeof (count));
 		/* Write signal value.  */
-		signal = netorder32 (record_full_list->u.end.sigval);
+		signal = netorder32 (record_full_list->sigval ());
 		bfdcore_write (obfd.get (), osec, &signal,
 			       sizeof (signal), &bfd_offset);
 
 		/* Write insn count.  */
-		count = netorder32 (record_full_list->u.end.insn_num);
+		count = netorder32 (record_full_list->insn_num ());
 		bfdcore_write (obfd.get (), osec, &count,
 			       sizeof (count), &bfd_offset);
 		break;
@@ -2714,10 +3273,10 @@ record_full_base_target::save_record (const char *recfilename)
 	}
 
       /* Execute entry.  */
-      record_full_exec_insn (regcache, gdbarch, record_full_list);
+      replay.exec (record_full_list);
 
-      if (record_full_list->next)
-	record_full_list = record_full_list->next;
+      if (record_full_list->next ())
+	record_full_list = record_full_list->next ();
       else
 	break;
     }
@@ -2729,11 +3288,12 @@ record_full_base_target::save_record (const char *recfilename)
       if (record_full_list == cur_record_full_list)
 	break;
 
-      record_full_exec_insn (regcache, gdbarch, record_full_list);
+      replay.exec (record_full_list);
 
-      if (record_full_list->prev)
-	record_full_list = record_full_list->prev;
+      if (record_full_list->prev ())
+	record_full_list = record_full_list->prev ();
     }
+  replay.flush ();
 
   unlink_file.keep ();
 
@@ -2753,22 +3313,24 @@ record_full_goto_insn (struct record_full_entry *entry,
   scoped_restore restore_operation_disable
     = record_full_gdb_operation_disable_set ();
   regcache *regcache = get_thread_regcache (inferior_thread ());
-  struct gdbarch *gdbarch = regcache->arch ();
+  record_full_replay replay (regcache);
 
   /* Assume everything is valid: we will hit the entry,
      and we will not hit the end of the recording.  */
 
   if (dir == EXEC_FORWARD)
-    record_full_list = record_full_list->next;
+    record_full_list = record_full_list->next ();
 
   do
     {
-      record_full_exec_insn (regcache, gdbarch, record_full_list);
+      replay.exec (record_full_list);
       if (dir == EXEC_REVERSE)
-	record_full_list = record_full_list->prev;
+	record_full_list = record_full_list->prev ();
       else
-	record_full_list = record_full_list->next;
+	record_full_list = record_full_list->next ();
     } while (record_full_list != entry);
+
+  replay.flush ();
 }
 
 /* Alias for "target record-full".  */
@@ -2779,6 +3341,21 @@ cmd_record_full_start (const char *args, int from_tty)
   execute_command ("target record-full", from_tty);
 }
 
+/* Rebuild the checkpoints of the log after the interval changed.  */
+
+static void
+set_record_full_checkpoint_interval (const char *args, int from_tty,
+				     struct cmd_list_element *c)
+{
+  record_full_checkpoints.clear ();
+
+  for (struct record_full_entry *p = record_full_first.next ();
+       p != NULL;
+       p = p->next ())
+    if (p->type == record_full_end)
+      record_full_checkpoint_add (p);
+}
+
 static void
 set_record_full_insn_max_num (const char *args, int from_tty,
 			      struct cmd_list_element *c)
@@ -2808,9 +3385,9 @@ maintenance_print_record_instruction (const char *args, int from_tty)
 	{
 	  /* Move forward OFFSET instructions.  We know we found the
 	     end of an instruction when to_print->type is record_full_end.  */
-	  while (to_print->next != nullptr && offset > 0)
+	  while (to_print->next () != nullptr && offset > 0)
 	    {
-	      to_print = to_print->next;
+	      to_print = to_print->next ();
 	      if (to_print->type == record_full_end)
 		offset--;
 	    }
@@ -2819,9 +3396,9 @@ maintenance_print_record_instruction (const char *args, int from_tty)
 	}
       else
 	{
-	  while (to_print->prev != nullptr && offset < 0)
+	  while (to_print->prev () != nullptr && offset < 0)
 	    {
-	      to_print = to_print->prev;
+	      to_print = to_print->prev ();
 	      if (to_print->type == record_full_end)
 		offset++;
 	    }
@@ -2834,8 +3411,9 @@ maintenance_print_record_instruction (const char *args, int from_tty)
   gdbarch *arch = current_inferior ()->arch ();
 
   /* Go back to the start of the instruction.  */
-  while (to_print->prev != nullptr && to_print->prev->type != record_full_end)
-    to_print = to_print->prev;
+  while (to_print->prev () != nullptr
+	 && to_print->prev ()->type != record_full_end)
+    to_print = to_print->prev ();
 
   /* if we're in the first record, there are no actual instructions
      recorded.  Warn the user and leave.  */
@@ -2848,12 +3426,12 @@ maintenance_print_record_instruction (const char *args, int from_tty)
 	{
 	  case record_full_reg:
 	    {
-	      type *regtype = gdbarch_register_type (arch, to_print->u.reg.num);
+	      type *regtype = gdbarch_register_type (arch, to_print->num);
 	      value *val
 		  = value_from_contents (regtype,
 					 record_full_get_loc (to_print));
 	      gdb_printf ("Register %s changed: ",
-			  gdbarch_register_name (arch, to_print->u.reg.num));
+			  gdbarch_register_name (arch, to_print->num));
 	      struct value_print_options opts;
 	      get_user_print_options (&opts);
 	      opts.raw = true;
@@ -2865,15 +3443,15 @@ maintenance_print_record_instruction (const char *args, int from_tty)
 	    {
 	      gdb_byte *b = record_full_get_loc (to_print);
 	      gdb_printf ("%d bytes of memory at address %s changed from:",
-			  to_print->u.mem.len,
-			  print_core_address (arch, to_print->u.mem.addr));
-	      for (int i = 0; i < to_print->u.mem.len; i++)
+			  to_print->len,
+			  print_core_address (arch, to_print->addr ()));
+	      for (int i = 0; i < to_print->len; i++)
 		gdb_printf (" %02x", b[i]);
 	      gdb_printf ("\n");
 	      break;
 	    }
 	}
-      to_print = to_print->next;
+      to_print = to_print->next ();
     }
 }
 
@@ -2884,8 +3462,6 @@ _initialize_record_full ()
   struct cmd_list_element *c;
 
   /* Init record_full_first.  */
-  record_full_first.prev = NULL;
-  record_full_first.next = NULL;
   record_full_first.type = record_full_end;
 
   add_target (record_full_target_info, record_full_open);
@@ -2961,6 +3537,19 @@ limit.  Default is 200000."),
 		     no_class, 1, &show_record_cmdlist);
   deprecate_cmd (c, "show record full insn-number-max");
 
+  add_setshow_zuinteger_cmd ("checkpoint-interval", no_class,
+			     &record_full_checkpoint_interval,
+			     _("Set the interval between checkpoints of the "
+			       "execution log."),
+			     _("Show the interval between checkpoints of the "
+			       "execution log."), _("\
+GDB remembers the position in the execution log of every Nth recorded\n\
+instruction, which lets \"record goto\" find an instruction quickly.\n\
+Zero disables this.  Default is 10000."),
+			     set_record_full_checkpoint_interval,
+			     NULL, &set_record_full_cmdlist,
+			     &show_record_full_cmdlist);
+
   set_show_commands record_full_memory_query_cmds
     = add_setshow_boolean_cmd ("memory-query", no_class,
 			       &record_full_memory_query, _("\
@@ -75,10 +75,14 @@
 #include "gdbsupport/environ.h"
 #include "gdbsupport/byte-vector.h"
 #include "gdbsupport/search.h"
+#include "gdbsupport/trace-events.h"
 #include <algorithm>
+#include <deque>
 #include <iterator>
 #include "async-event.h"
 #include "gdbsupport/selftest.h"
+#include "test-target.h"
+#include "scoped-mock-context.h"
 #include "cli/cli-style.h"
 #include "gdbsupport/remote-args.h"
 
@@ -253,12 +257,18 @@ enum {
   PACKET_vFile_stat,
   PACKET_qXfer_auxv,
   PACKET_qXfer_features,
+  PACKET_qTDescHash,
   PACKET_qXfer_exec_file,
   PACKET_qXfer_libraries,
   PACKET_qXfer_libraries_svr4,
   PACKET_qXfer_memory_map,
   PACKET_qXfer_osdata,
   PACKET_qXfer_threads,
+
+  /* Support for reading only the changes to the thread list with
+     qXfer:threads:read.  */
+  PACKET_threads_delta,
+
   PACKET_qXfer_statictrace_read,
   PACKET_qXfer_traceframe_info,
   PACKET_qXfer_uib,
@@ -276,9 +286,15 @@ enum {
   PACKET_QEnvironmentUnset,
   PACKET_qCRC,
   PACKET_qSearch_memory,
+  PACKET_qSearch_memory_any,
   PACKET_vAttach,
   PACKET_vRun,
   PACKET_QStartNoAckMode,
+
+  /* Support for receiving further requests before replying to the
+     previous ones.  */
+  PACKET_pipelined_requests,
+
   PACKET_vKill,
   PACKET_qXfer_siginfo_read,
   PACKET_qXfer_siginfo_write,
@@ -652,6 +668,18 @@ class remote_state
   bool use_threadinfo_query = false;
   bool use_threadextra_query = false;
 
+  /* The generation of the thread list last read with
+     qXfer:threads:read, if the remote reported one and GDB's thread
+     list is known to be in sync with it.  When set, and the remote
+     supports it, only the changes since are requested.  */
+  std::optional<ULONGEST> thread_list_generation;
+
+  /* Threads the remote reported as removed in a thread list delta,
+     but that GDB could not delete at the time, see
+     can_delete_unlisted_thread.  The remote won't report them again,
+     so deleting them is retried on each thread list update.  */
+  std::vector<ptid_t> deferred_thread_removals;
+
   threadref echo_nextthread {};
   threadref nextthread {};
   threadref resultthreadlist[MAXTHREADLISTRESULTS] {};
@@ -676,6 +704,9 @@ class remote_state
      file descriptor at a time.  */
   struct readahead_cache readahead_cache;
 
+  /* Statistics about the packets exchanged with the remote.  */
+  remote_packet_stats packet_stats;
+
   /* The list of already fetched and acknowledged stop events.  This
      queue is used for notification Stop, and other notifications
      don't need queue for their events, because the notification
@@ -980,10 +1011,17 @@ class remote_target : public process_stratum_target
 
   const struct target_desc *read_description () override;
 
+  std::string read_description_hash () override;
+
   int search_memory (CORE_ADDR start_addr, ULONGEST search_space_len,
 		     const gdb_byte *pattern, ULONGEST pattern_len,
 		     CORE_ADDR *found_addrp) override;
 
+  int search_memory_multi (CORE_ADDR start_addr, ULONGEST search_space_len,
+			   gdb::array_view<const search_pattern> patterns,
+			   ULONGEST align, CORE_ADDR *found_addrp,
+			   size_t *found_indexp) override;
+
   bool can_async_p () override;
 
   bool is_async_p () override;
@@ -1173,10 +1211,17 @@ class remote_target : public process_stratum_target
 			    ULONGEST offset, fileio_error *remote_errno);
   int remote_hostio_pread_vFile (int fd, gdb_byte *read_buf, int len,
 				 ULONGEST offset, fileio_error *remote_errno);
+  int remote_hostio_pread_pipelined (int fd, gdb_byte *read_buf, int len,
+				     ULONGEST offset,
+				     fileio_error *remote_errno);
 
   int remote_hostio_send_command (int command_bytes, int which_packet,
 				  fileio_error *remote_errno, const char **attachment,
 				  int *attachment_len);
+  int remote_hostio_read_reply (int bytes_read, int which_packet,
+				fileio_error *remote_errno,
+				const char **attachment,
+				int *attachment_len);
   int remote_hostio_set_filesystem (struct inferior *inf,
 				    fileio_error *remote_errno);
   /* We should get rid of this and use fileio_open directly.  */
@@ -1347,6 +1392,16 @@ class remote_target : public process_stratum_target
 					  ULONGEST len_units,
 					  int unit_size, ULONGEST *xfered_len_units);
 
+  bool can_pipeline_requests ();
+  void discard_replies (size_t count, const gdb_exception &ex);
+
+  target_xfer_status remote_read_bytes_pipelined (CORE_ADDR memaddr,
+						  gdb_byte *myaddr,
+						  ULONGEST len_units,
+						  int unit_size,
+						  char packet_format,
+						  ULONGEST *xfered_len_units);
+
   target_xfer_status remote_xfer_live_readonly_partial (gdb_byte *readbuf,
 							ULONGEST memaddr,
 							ULONGEST len,
@@ -2423,6 +2478,11 @@ remote_target::get_memory_read_packet_size ()
   return size;
 }
 
+/* The maximum number of memory read requests that may be waiting for
+   a reply, when reading a large block of memory.  */
+
+static unsigned int remote_memory_read_window = 8;
+
 static enum packet_support packet_config_support (const packet_config *config);
 
 
@@ -4052,6 +4112,17 @@ struct thread_item
 
 struct threads_listing_context
 {
+  /* True if ITEMS and REMOVED only describe the changes to the thread
+     list since the generation GDB asked about, rather than the whole
+     list.  */
+  bool delta = false;
+
+  /* The thread list generation reported by the remote, if any.  */
+  std::optional<ULONGEST> generation;
+
+  /* When DELTA is true, the threads that have been removed.  */
+  std::vector<ptid_t> removed;
+
   /* Return true if this object contains an entry for a thread with ptid
      PTID.  */
 
@@ -4142,6 +4213,36 @@ remote_target::remote_get_threads_with_ql (threads_listing_context *context)
 
 #if defined(HAVE_LIBEXPAT)
 
+static void
+start_threads (struct gdb_xml_parser *parser,
+	       const struct gdb_xml_element *element,
+	       void *user_data,
+	       std::vector<gdb_xml_value> &attributes)
+{
+  struct threads_listing_context *data
+    = (struct threads_listing_context *) user_data;
+  struct gdb_xml_value *attr;
+
+  attr = xml_find_attribute (attributes, "generation");
+  if (attr != nullptr)
+    data->generation = *(ULONGEST *) attr->value.get ();
+
+  data->delta = xml_find_attribute (attributes, "since") != nullptr;
+}
+
+static void
+start_removed (struct gdb_xml_parser *parser,
+	       const struct gdb_xml_element *element,
+	       void *user_data,
+	       std::vector<gdb_xml_value> &attributes)
+{
+  struct threads_listing_context *data
+    = (struct threads_listing_context *) user_data;
+
+  char *id = (char *) xml_find_attribute (attributes, "id")->value.get ();
+  data->removed.push_back (read_ptid (id, nullptr));
+}
+
 static void
 start_thread (struct gdb_xml_parser *parser,
 	      const struct gdb_xml_element *element,
@@ -4199,22 +4300,40 @@ const struct gdb_xml_element thread_children[] = {
   { NULL, NULL, NULL, GDB_XML_EF_NONE, NULL, NULL }
 };
 
+const struct gdb_xml_attribute removed_attributes[] = {
+  { "id", GDB_XML_AF_NONE, NULL, NULL },
+  { NULL, GDB_XML_AF_NONE, NULL, NULL }
+};
+
 const struct gdb_xml_element threads_children[] = {
   { "thread", thread_attributes, thread_children,
     GDB_XML_EF_REPEATABLE | GDB_XML_EF_OPTIONAL,
     start_thread, end_thread },
+  { "removed", removed_attributes, NULL,
+    GDB_XML_EF_REPEATABLE | GDB_XML_EF_OPTIONAL,
+    start_removed, NULL },
   { NULL, NULL, NULL, GDB_XML_EF_NONE, NULL, NULL }
 };
 
+const struct gdb_xml_attribute threads_attributes[] = {
+  { "generation", GDB_XML_AF_OPTIONAL, gdb_xml_parse_attr_ulongest, NULL },
+  { "since", GDB_XML_AF_OPTIONAL, gdb_xml_parse_attr_ulongest, NULL },
+  { NULL, GDB_XML_AF_NONE, NULL, NULL }
+};
+
 const struct gdb_xml_element threads_elements[] = {
-  { "threads", NULL, threads_children,
-    GDB_XML_EF_NONE, NULL, NULL },
+  { "threads", threads_attributes, threads_children,
+    GDB_XML_EF_NONE, start_threads, NULL },
   { NULL, NULL, NULL, GDB_XML_EF_NONE, NULL, NULL }
 };
 
 #endif
 
-/* List remote threads using qXfer:threads:read.  */
+/* List remote threads using qXfer:threads:read.  If the remote
+   supports it, and GDB knows the generation of the thread list it
+   last read, ask only for the threads added and removed since, so
+   that the amount of data transferred on each stop is proportional
+   to the number of changes rather than to the number of threads.  */
 
 int
 remote_target::remote_get_threads_with_qxfer (threads_listing_context *context)
@@ -4222,8 +4341,20 @@ remote_target::remote_get_threads_with_qxfer (threads_listing_context *context)
 #if defined(HAVE_LIBEXPAT)
   if (m_features.packet_support (PACKET_qXfer_threads) == PACKET_ENABLE)
     {
+      struct remote_state *rs = get_remote_state ();
+      std::string annex;
+
+      if (rs->thread_list_generation.has_value ()
+	  && m_features.packet_support (PACKET_threads_delta) == PACKET_ENABLE)
+	annex = pulongest (*rs->thread_list_generation);
+
+      /* Until the reply has been parsed and applied, GDB's thread
+	 list can't be assumed to match any generation.  */
+      rs->thread_list_generation.reset ();
+
       std::optional<gdb::char_vector> xml
-	= target_read_stralloc (this, TARGET_OBJECT_THREADS, NULL);
+	= target_read_stralloc (this, TARGET_OBJECT_THREADS,
+				annex.empty () ? nullptr : annex.c_str ());
 
       if (xml && (*xml)[0] != '\0')
 	{
@@ -4290,6 +4421,57 @@ has_single_non_exited_thread (inferior *inf)
   return count == 1;
 }
 
+/* Return true if TP, a thread the remote target no longer lists,
+   can be deleted.  */
+
+static bool
+can_delete_unlisted_thread (thread_info *tp)
+{
+  /* Do not remove the thread if it is the last thread in the
+     inferior.  This situation happens when we have a pending exit
+     process status to process.  Otherwise we may end up with a
+     seemingly live inferior (i.e.  pid != 0) that has no threads.  */
+  if (has_single_non_exited_thread (tp->inf))
+    return false;
+
+  /* Do not remove the thread if we've requested to be notified of its
+     exit.  For example, the thread may be displaced stepping, infrun
+     will need to handle the exit event, and displaced stepping info
+     is recorded in the thread object.  If we deleted the thread now,
+     we'd lose that info.  */
+  if ((tp->thread_options () & GDB_THREAD_OPTION_EXIT) != 0)
+    return false;
+
+  return true;
+}
+
+/* Delete the threads of TARGET whose ptids are in REMOVED, as the
+   remote no longer lists them.  Return the ptids of the threads that
+   can't be deleted yet.  */
+
+static std::vector<ptid_t>
+delete_removed_threads (process_stratum_target *target,
+			const std::vector<ptid_t> &removed)
+{
+  std::vector<ptid_t> deferred;
+
+  for (ptid_t ptid : removed)
+    {
+      thread_info *tp = target->find_thread (ptid);
+
+      if (tp == nullptr)
+	continue;
+
+      if (can_delete_unlisted_thread (tp))
+	delete_thread (tp);
+      else if (std::find (deferred.begin (), deferred.end (), ptid)
+	       == deferred.end ())
+	deferred.push_back (ptid);
+    }
+
+  return deferred;
+}
+
 /* Implement the to_update_thread_list function for the remote
    targets.  */
 
@@ -4308,46 +4490,56 @@ remote_target::update_thread_list ()
     {
       got_list = 1;
 
-      if (context.items.empty ()
-	  && remote_thread_always_alive (inferior_ptid))
+      remote_state *rs = get_remote_state ();
+
+      if (context.delta)
 	{
-	  /* Some targets don't really support threads, but still
-	     reply an (empty) thread list in response to the thread
-	     listing packets, instead of replying "packet not
-	     supported".  Exit early so we don't delete the main
-	     thread.  */
-	  return;
+	  /* CONTEXT only holds the changes since the last update.
+	     Delete the GDB-side threads the remote reported as
+	     removed, now or in a previous update, unless the remote
+	     lists them as new again.  */
+	  std::vector<ptid_t> removed
+	    = std::move (rs->deferred_thread_removals);
+	  removed.insert (removed.end (), context.removed.begin (),
+			  context.removed.end ());
+	  removed.erase (std::remove_if (removed.begin (), removed.end (),
+					 [&] (ptid_t ptid)
+					 {
+					   return context.contains_thread (ptid);
+					 }),
+			 removed.end ());
+
+	  rs->deferred_thread_removals
+	    = delete_removed_threads (this, removed);
 	}
-
-      /* CONTEXT now holds the current thread list on the remote
-	 target end.  Delete GDB-side threads no longer found on the
-	 target.  */
-      for (thread_info *tp : all_threads_safe ())
+      else
 	{
-	  if (tp->inf->process_target () != this)
-	    continue;
+	  /* The full list below also accounts for the threads whose
+	     removal was deferred.  */
+	  rs->deferred_thread_removals.clear ();
 
-	  if (!context.contains_thread (tp->ptid))
+	  if (context.items.empty ()
+	      && remote_thread_always_alive (inferior_ptid))
 	    {
-	      /* Do not remove the thread if it is the last thread in
-		 the inferior.  This situation happens when we have a
-		 pending exit process status to process.  Otherwise we
-		 may end up with a seemingly live inferior (i.e.  pid
-		 != 0) that has no threads.  */
-	      if (has_single_non_exited_thread (tp->inf))
-		continue;
+	      /* Some targets don't really support threads, but still
+		 reply an (empty) thread list in response to the thread
+		 listing packets, instead of replying "packet not
+		 supported".  Exit early so we don't delete the main
+		 thread.  */
+	      return;
+	    }
 
-	      /* Do not remove the thread if we've requested to be
-		 notified of its exit.  For example, the thread may be
-		 displaced stepping, infrun will need to handle the
-		 exit event, and displaced stepping info is recorded
-		 in the thread object.  If we deleted the thread now,
-		 we'd lose that info.  */
-	      if ((tp->thread_options () & GDB_THREAD_OPTION_EXIT) != 0)
+	  /* CONTEXT now holds the current thread list on the remote
+	     target end.  Delete GDB-side threads no longer found on
+	     the target.  */
+	  for (thread_info *tp : all_threads_safe ())
+	    {
+	      if (tp->inf->process_target () != this)
 		continue;
 
-	      /* Not found.  */
-	      delete_thread (tp);
+	      if (!context.contains_thread (tp->ptid)
+		  && can_delete_unlisted_thread (tp))
+		delete_thread (tp);
 	    }
 	}
 
@@ -4379,6 +4571,10 @@ remote_target::update_thread_list ()
 	      info->thread_handle = std::move (item.thread_handle);
 	    }
 	}
+
+      /* GDB's thread list now matches this generation of the remote
+	 thread list, except for the deferred removals.  */
+      rs->thread_list_generation = context.generation;
     }
 
   if (!got_list)
@@ -4560,6 +4756,7 @@ remote_target::extended_remote_restart ()
      remote side really expects a number after the "R".  */
   xsnprintf (rs->buf.data (), get_remote_packet_size (), "R%x", 0);
   putpkt (rs->buf);
+  rs->packet_stats.record_unanswered ();
 
   remote_fileio_reset ();
 }
@@ -5757,6 +5954,8 @@ static const struct protocol_feature remote_protocol_features[] = {
     PACKET_qXfer_exec_file },
   { "qXfer:features:read", PACKET_DISABLE, remote_supported_packet,
     PACKET_qXfer_features },
+  { "qTDescHash", PACKET_DISABLE, remote_supported_packet,
+    PACKET_qTDescHash },
   { "qXfer:libraries:read", PACKET_DISABLE, remote_supported_packet,
     PACKET_qXfer_libraries },
   { "qXfer:libraries-svr4:read", PACKET_DISABLE, remote_supported_packet,
@@ -5769,6 +5968,8 @@ static const struct protocol_feature remote_protocol_features[] = {
     PACKET_qXfer_osdata },
   { "qXfer:threads:read", PACKET_DISABLE, remote_supported_packet,
     PACKET_qXfer_threads },
+  { "threads-delta", PACKET_DISABLE, remote_supported_packet,
+    PACKET_threads_delta },
   { "qXfer:traceframe-info:read", PACKET_DISABLE, remote_supported_packet,
     PACKET_qXfer_traceframe_info },
   { "QPassSignals", PACKET_DISABLE, remote_supported_packet,
@@ -5789,6 +5990,8 @@ static const struct protocol_feature remote_protocol_features[] = {
     PACKET_QEnvironmentUnset },
   { "QStartNoAckMode", PACKET_DISABLE, remote_supported_packet,
     PACKET_QStartNoAckMode },
+  { "pipelined-requests", PACKET_DISABLE, remote_supported_packet,
+    PACKET_pipelined_requests },
   { "multiprocess", PACKET_DISABLE, remote_supported_packet,
     PACKET_multiprocess_feature },
   { "QNonStop", PACKET_DISABLE, remote_supported_packet, PACKET_QNonStop },
@@ -6288,6 +6491,8 @@ remote_target::open_1 (const char *name, int from_tty, int extended_p)
   /* Probe for ability to use "ThreadInfo" query, as required.  */
   rs->use_threadinfo_query = 1;
   rs->use_threadextra_query = 1;
+  rs->thread_list_generation.reset ();
+  rs->deferred_thread_removals.clear ();
 
   rs->readahead_cache.invalidate ();
 
@@ -9698,6 +9903,17 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
 
   memaddr = remote_address_masked (memaddr);
 
+  /* Large reads are done with several requests in flight, once we
+     know which packet to use.  */
+  if (can_pipeline_requests ()
+      && remote_memory_read_window > 1
+      && len_units > todo_units
+      && m_features.packet_support (PACKET_x) != PACKET_SUPPORT_UNKNOWN)
+    return remote_read_bytes_pipelined (memaddr, myaddr, len_units, unit_size,
+					(m_features.packet_support (PACKET_x)
+					 == PACKET_ENABLE ? 'x' : 'm'),
+					xfered_len_units);
+
   /* Construct "m/x"<memaddr>","<len>".  */
   auto send_request = [this, rs, memaddr, todo_units] (char format) -> void
     {
@@ -9774,6 +9990,146 @@ remote_target::remote_read_bytes_1 (CORE_ADDR memaddr, gdb_byte *myaddr,
   return (*xfered_len_units != 0) ? TARGET_XFER_OK : TARGET_XFER_EOF;
 }
 
+/* Return true if several requests may be sent before reading the
+   replies.  The stub must say it accepts that, and the connection
+   must be in no-ack mode, where sending a packet does not wait for
+   anything.  */
+
+bool
+remote_target::can_pipeline_requests ()
+{
+  return (get_remote_state ()->noack_mode
+	  && (m_features.packet_support (PACKET_pipelined_requests)
+	      == PACKET_ENABLE));
+}
+
+/* Called when EX was thrown while COUNT requests were still waiting
+   for a reply.  Read and drop these replies, so that the next request
+   does not get one of them as its reply.  If the connection was
+   closed, there is nothing to read.  */
+
+void
+remote_target::discard_replies (size_t count, const gdb_exception &ex)
+{
+  if (ex.error == TARGET_CLOSE_ERROR)
+    return;
+
+  struct remote_state *rs = get_remote_state ();
+  for (size_t i = 0; i < count; i++)
+    getpkt (&rs->buf);
+}
+
+/* Read LEN_UNITS addressable memory units at MEMADDR, as
+   remote_read_bytes_1 would, but with several memory read packets of
+   type PACKET_FORMAT, up to remote_memory_read_window of which are
+   sent before waiting for the replies.  This hides the round trip
+   time of all but the first request.  It is only used if
+   can_pipeline_requests is true.  Only part of the memory may be
+   read, as for any partial transfer.  */
+
+target_xfer_status
+remote_target::remote_read_bytes_pipelined (CORE_ADDR memaddr,
+					    gdb_byte *myaddr,
+					    ULONGEST len_units, int unit_size,
+					    char packet_format,
+					    ULONGEST *xfered_len_units)
+{
+  struct remote_state *rs = get_remote_state ();
+
+  /* Number of units that fit in a reply.  */
+  ULONGEST chunk
+    = std::max ((ULONGEST) (get_memory_read_packet_size () / unit_size) / 2,
+		(ULONGEST) 1);
+
+  /* Don't do too much in a single partial transfer, so that callers
+     can show progress and be interrupted.  */
+  len_units = std::min (len_units, chunk * 64);
+
+  /* A request for LEN units at offset OFF from MEMADDR.  */
+  struct request
+  {
+    ULONGEST off;
+    ULONGEST len;
+  };
+
+  std::deque<request> to_send;
+  std::deque<request> in_flight;
+  for (ULONGEST off = 0; off < len_units; off += chunk)
+    to_send.push_back ({ off, std::min (chunk, len_units - off) });
+
+  /* The offset of the first unit that could not be read.  All the
+     replies must be read even after a failure, or the connection
+     would be out of sync.  */
+  ULONGEST error_at = len_units;
+
+  while (!to_send.empty () || !in_flight.empty ())
+    {
+      while (!to_send.empty ()
+	     && in_flight.size () < remote_memory_read_window)
+	{
+	  request req = to_send.front ();
+	  to_send.pop_front ();
+
+	  /* Nothing to read past a failure.  */
+	  if (req.off >= error_at)
+	    continue;
+
+	  char *buffer = rs->buf.data ();
+	  *buffer++ = packet_format;
+	  buffer += hexnumstr (buffer, (ULONGEST) memaddr + req.off);
+	  *buffer++ = ',';
+	  buffer += hexnumstr (buffer, req.len);
+	  *buffer = '\0';
+	  putpkt (rs->buf);
+	  in_flight.push_back (req);
+	}
+
+      if (in_flight.empty ())
+	break;
+
+      request req = in_flight.front ();
+      in_flight.pop_front ();
+
+      int packet_len;
+      try
+	{
+	  packet_len = getpkt (&rs->buf);
+	}
+      catch (const gdb_exception &ex)
+	{
+	  discard_replies (in_flight.size (), ex);
+	  throw;
+	}
+      ULONGEST got = 0;
+
+      if (packet_len >= 0
+	  && packet_check_result (rs->buf).status () != PACKET_ERROR)
+	{
+	  char *p = rs->buf.data ();
+	  int decoded_bytes = 0;
+
+	  if (packet_format == 'm')
+	    decoded_bytes = hex2bin (p, myaddr + req.off * unit_size,
+				     req.len * unit_size);
+	  else if (*p == 'b')
+	    decoded_bytes
+	      = remote_unescape_input ((const gdb_byte *) p + 1,
+				       packet_len - 1,
+				       myaddr + req.off * unit_size,
+				       req.len * unit_size);
+	  got = decoded_bytes / unit_size;
+	}
+
+      if (got == 0)
+	error_at = std::min (error_at, req.off);
+      else if (got < req.len)
+	to_send.push_front ({ req.off + got, req.len - got });
+    }
+
+  *xfered_len_units = error_at;
+  return error_at != 0 ? TARGET_XFER_OK : TARGET_XFER_E_IO;
+}
+
 /* Using the set of read-only target sections of remote, read live
    read-only memory.
 
@@ -10095,6 +10451,101 @@ escape_buffer (const char *buf, int n)
   return stb.release ();
 }
 
+/* Return the name under which packet BUF, which is LEN bytes long, is
+   counted in the packet statistics.  */
+
+static std::string_view
+remote_packet_stats_name (const char *buf, int len)
+{
+  if (len == 0)
+    return {};
+
+  /* Most packets are identified by their first character.  */
+  if (buf[0] != 'q' && buf[0] != 'Q' && buf[0] != 'v')
+    return std::string_view (buf, 1);
+
+  int end = 1;
+  while (end < len && isalnum ((unsigned char) buf[end]))
+    end++;
+
+  /* Transfers of different objects, and different file operations,
+     behave quite differently, so tell them apart.  */
+  std::string_view name (buf, end);
+  if ((name == "qXfer" || name == "vFile") && end < len && buf[end] == ':')
+    {
+      end++;
+      while (end < len && buf[end] != ':')
+	end++;
+      name = std::string_view (buf, end);
+    }
+
+  return name;
+}
+
+/* See remote.h.  */
+
+void
+remote_packet_stats::record_sent (const char *buf, int len)
+{
+  std::string_view name = remote_packet_stats_name (buf, len);
+  auto it = packet_types.find (name);
+  if (it == packet_types.end ())
+    it = packet_types.emplace (name, packet_type ()).first;
+
+  it->second.count++;
+  it->second.bytes_sent += len;
+  packets_sent++;
+  bytes_sent += len;
+
+  in_flight.push_back ({ &it->second, &it->first,
+			 std::chrono::steady_clock::now () });
+}
+
+/* See remote.h.  */
+
+void
+remote_packet_stats::record_received (int len)
+{
+  packets_received++;
+  bytes_received += len;
+
+  /* Packets that arrive when GDB isn't waiting for a reply, like the
+     stop replies of non-stop targets, are only counted in the
+     totals.  */
+  if (in_flight.empty ())
+    return;
+
+  in_flight_packet sent = in_flight.front ();
+  in_flight.pop_front ();
+
+  using namespace std::chrono;
+  steady_clock::time_point now = steady_clock::now ();
+  ULONGEST rtt = duration_cast<microseconds> (now - sent.start).count ();
+
+  if (gdb::trace_events::enabled ())
+    gdb::trace_events::record ("remote", "round trip", sent.start, now,
+			       *sent.name);
+
+  sent.type->replies++;
+  sent.type->bytes_received += len;
+  sent.type->total_rtt += rtt;
+  sent.type->max_rtt = std::max (sent.type->max_rtt, rtt);
+
+  int bucket = 0;
+  while (bucket < rtt_buckets - 1 && rtt >= rtt_bucket_bounds[bucket])
+    bucket++;
+  sent.type->rtt_histogram[bucket]++;
+}
+
+/* See remote.h.  */
+
+void
+remote_packet_stats::record_unanswered ()
+{
+  if (!in_flight.empty ())
+    in_flight.pop_back ();
+}
+
 int
 remote_target::putpkt (const char *buf)
 {
@@ -10120,8 +10571,7 @@ int
 remote_target::putpkt_binary (const char *buf, int cnt)
 {
   struct remote_state *rs = get_remote_state ();
-  int i;
-  unsigned char csum = 0;
+  unsigned char csum;
   gdb::def_vector<char> data (cnt + 6);
   char *buf2 = data.data ();
 
@@ -10151,15 +10601,15 @@ remote_target::putpkt_binary (const char *buf, int cnt)
   p = buf2;
   *p++ = '$';
 
-  for (i = 0; i < cnt; i++)
-    {
-      csum += buf[i];
-      *p++ = buf[i];
-    }
+  memcpy (p, buf, cnt);
+  p += cnt;
+  csum = remote_packet_checksum (buf, cnt);
   *p++ = '#';
   *p++ = tohex ((csum >> 4) & 0xf);
   *p++ = tohex (csum & 0xf);
 
+  rs->packet_stats.record_sent (buf, cnt);
+
   /* Send it over and over until we get a positive ack.  */
 
   while (1)
@@ -10211,6 +10661,7 @@ remote_target::putpkt_binary (const char *buf, int cnt)
 	      tcount++;
 	      if (tcount > 3)
 		return 0;
+	      rs->packet_stats.retransmissions++;
 	      break;		/* Retransmit buffer.  */
 	    case '$':
 	      {
@@ -10239,6 +10690,8 @@ remote_target::putpkt_binary (const char *buf, int cnt)
 		      ("  Notification received: %s",
 		       escape_buffer (rs->buf.data (), val).c_str ());
 
+		    rs->packet_stats.notifications++;
+		    rs->packet_stats.bytes_received += val;
 		    handle_notification (rs->notif_state, rs->buf.data ());
 		    /* We're in sync now, rewait for the ack.  */
 		    tcount = 0;
@@ -10379,6 +10832,7 @@ remote_target::read_frame (gdb::char_vector *buf_p)
 	    remote_debug_printf
 	      ("Bad checksum, sentsum=0x%x, csum=0x%x, buf=%s",
 	       pktcsum, csum, escape_buffer (buf, bc).c_str ());
+	    rs->packet_stats.checksum_failures++;
 
 	    /* Number of characters in buffer ignoring trailing
 	       NULL.  */
@@ -10539,6 +10993,8 @@ remote_target::getpkt (gdb::char_vector *buf, bool forever, bool *is_notif)
       /* If we got an ordinary packet, return that to our caller.  */
       if (c == '$')
 	{
+	  rs->packet_stats.record_received (val);
+
 	  if (remote_debug)
 	    {
 	      int max_chars;
@@ -10582,6 +11038,8 @@ remote_target::getpkt (gdb::char_vector *buf, bool forever, bool *is_notif)
 	  if (is_notif != NULL)
 	    *is_notif = true;
 
+	  rs->packet_stats.notifications++;
+	  rs->packet_stats.bytes_received += val;
 	  handle_notification (rs->notif_state, buf->data ());
 
 	  /* Notifications require no acknowledgement.  */
@@ -10721,6 +11179,10 @@ remote_target::remote_kill_k ()
   try
     {
       putpkt ("k");
+
+      /* The remote need not reply to "k", so GDB doesn't wait for
+	 it.  */
+      get_remote_state ()->packet_stats.record_unanswered ();
     }
   catch (const gdb_exception_error &ex)
     {
@@ -10762,6 +11224,11 @@ remote_target::mourn_inferior ()
      connected.  */
   rs->waiting_for_stop_reply = 0;
 
+  /* GDB just discarded the threads of the inferior, so the next thread
+     list update can't be based on what the remote reported before.  */
+  rs->thread_list_generation.reset ();
+  rs->deferred_thread_removals.clear ();
+
   /* If the current general thread belonged to the process we just
      detached from or has exited, the remote side current general
      thread becomes undefined.  Considering a case like this:
@@ -11871,7 +12338,6 @@ remote_target::xfer_partial (enum target_object object,
 	 PACKET_qXfer_osdata);
 
     case TARGET_OBJECT_THREADS:
-      gdb_assert (annex == NULL);
       return remote_read_qxfer
 	("threads", annex, readbuf, offset, len, xfered_len,
 	 PACKET_qXfer_threads);
@@ -12058,6 +12524,82 @@ remote_target::search_memory (CORE_ADDR start_addr, ULONGEST search_space_len,
   return found;
 }
 
+int
+remote_target::search_memory_multi (CORE_ADDR start_addr,
+				    ULONGEST search_space_len,
+				    gdb::array_view<const search_pattern> patterns,
+				    ULONGEST align, CORE_ADDR *found_addrp,
+				    size_t *found_indexp)
+{
+  int addr_size = gdbarch_addr_bit (current_inferior ()->arch ()) / 8;
+  struct remote_state *rs = get_remote_state ();
+  int max_size = get_memory_write_packet_size ();
+
+  auto read_memory = [this] (CORE_ADDR addr, gdb_byte *result, size_t len)
+    {
+      return (target_read (this, TARGET_OBJECT_MEMORY, NULL, result, addr, len)
+	      == len);
+    };
+
+  /* If we already know the packet isn't supported, fall back to reading
+     memory and doing the search here.  */
+  if (m_features.packet_support (PACKET_qSearch_memory_any) == PACKET_DISABLE)
+    return simple_search_memory_multi (read_memory, start_addr,
+				       search_space_len, patterns, align,
+				       found_addrp, found_indexp);
+
+  /* Make sure the remote is pointing at the right process.  */
+  set_general_process ();
+
+  std::string request
+    = string_printf ("qSearch:memory-any:%s;%s;%s",
+		     phex_nz (start_addr, addr_size),
+		     phex_nz (search_space_len), phex_nz (align));
+  for (const search_pattern &pattern : patterns)
+    {
+      request += ';';
+      request += bin2hex (pattern.data (), pattern.size ());
+    }
+
+  if (request.size () >= (size_t) max_size)
+    error (_("Patterns are too large to transmit to remote target."));
+
+  if (putpkt (request.c_str ()) < 0
+      || getpkt (&rs->buf) < 0
+      || (m_features.packet_ok (rs->buf, PACKET_qSearch_memory_any).status ()
+	  != PACKET_OK))
+    {
+      /* The request may not have worked because the command is not
+	 supported.  If so, fall back to the simple way.  */
+      if (m_features.packet_support (PACKET_qSearch_memory_any)
+	  == PACKET_DISABLE)
+	return simple_search_memory_multi (read_memory, start_addr,
+					   search_space_len, patterns, align,
+					   found_addrp, found_indexp);
+      return -1;
+    }
+
+  if (rs->buf[0] == '0')
+    return 0;
+  else if (rs->buf[0] == '1' && rs->buf[1] == ',')
+    {
+      ULONGEST found_addr, found_index;
+      const char *p = unpack_varlen_hex (&rs->buf[2], &found_addr);
+
+      if (*p != ',')
+	error (_("Unknown qSearch:memory-any reply: %s"), rs->buf.data ());
+      p = unpack_varlen_hex (p + 1, &found_index);
+      if (*p != '\0' || found_index >= patterns.size ())
+	error (_("Unknown qSearch:memory-any reply: %s"), rs->buf.data ());
+
+      *found_addrp = found_addr;
+      *found_indexp = found_index;
+      return 1;
+    }
+  else
+    error (_("Unknown qSearch:memory-any reply: %s"), rs->buf.data ());
+}
+
 void
 remote_target::rcmd (const char *command, struct ui_file *outbuf)
 {
@@ -12232,6 +12774,146 @@ cli_packet_command (const char *args, int from_tty)
   send_remote_packet (view, &cb);
 }
 
+/* See remote.h.  */
+
+remote_packet_stats *
+remote_get_packet_stats (process_stratum_target *target)
+{
+  remote_target *remote = as_remote_target (target);
+  if (remote == nullptr)
+    return nullptr;
+
+  return &remote->get_remote_state ()->packet_stats;
+}
+
+/* See remote.h.  */
+
+void
+remote_print_packet_stats (ui_out *uiout, const remote_packet_stats &stats)
+{
+  static const char *const bucket_names[remote_packet_stats::rtt_buckets] =
+    { "<10us", "<100us", "<1ms", "<10ms", "<100ms", "<1s", ">=1s" };
+  static const char *const bucket_fields[remote_packet_stats::rtt_buckets] =
+    { "under-10us", "under-100us", "under-1ms", "under-10ms", "under-100ms",
+      "under-1s", "over-1s" };
+
+  auto print_total = [&] (const char *text, const char *name, ULONGEST value)
+    {
+      uiout->text (text);
+      uiout->field_unsigned (name, value);
+      uiout->text ("\n");
+    };
+
+  {
+    ui_out_emit_tuple tuple_emitter (uiout, "totals");
+
+    print_total (_("Packets sent: "), "packets-sent", stats.packets_sent);
+    print_total (_("Packets received: "), "packets-received",
+		 stats.packets_received);
+    print_total (_("Bytes sent: "), "bytes-sent", stats.bytes_sent);
+    print_total (_("Bytes received: "), "bytes-received",
+		 stats.bytes_received);
+    print_total (_("Notifications received: "), "notifications",
+		 stats.notifications);
+    print_total (_("Retransmissions: "), "retransmissions",
+		 stats.retransmissions);
+    print_total (_("Checksum failures: "), "checksum-failures",
+		 stats.checksum_failures);
+  }
+
+  int name_width = strlen ("Packet");
+  for (const auto &[name, type] : stats.packet_types)
+    name_width = std::max (name_width, (int) name.size ());
+
+  int nr_types = stats.packet_types.size ();
+
+  uiout->text ("\n");
+  {
+    ui_out_emit_table table_emitter (uiout, 7, nr_types, "packet-types");
+
+    uiout->table_header (name_width, ui_left, "packet", "Packet");
+    uiout->table_header (7, ui_right, "count", "Count");
+    uiout->table_header (10, ui_right, "bytes-sent", "Sent");
+    uiout->table_header (7, ui_right, "replies", "Replies");
+    uiout->table_header (10, ui_right, "bytes-received", "Received");
+    uiout->table_header (9, ui_right, "avg-rtt", "Avg (us)");
+    uiout->table_header (9, ui_right, "max-rtt", "Max (us)");
+    uiout->table_body ();
+
+    for (const auto &[name, type] : stats.packet_types)
+      {
+	ui_out_emit_tuple tuple_emitter (uiout, nullptr);
+
+	uiout->field_string ("packet", name);
+	uiout->field_unsigned ("count", type.count);
+	uiout->field_unsigned ("bytes-sent", type.bytes_sent);
+	uiout->field_unsigned ("replies", type.replies);
+	uiout->field_unsigned ("bytes-received", type.bytes_received);
+	if (type.replies > 0)
+	  uiout->field_unsigned ("avg-rtt", type.total_rtt / type.replies);
+	else
+	  uiout->field_skip ("avg-rtt");
+	uiout->field_unsigned ("max-rtt", type.max_rtt);
+	uiout->text ("\n");
+      }
+  }
+
+  if (nr_types == 0)
+    return;
+
+  uiout->text (_("\nRound-trip times:\n"));
+  {
+    ui_out_emit_table table_emitter (uiout, remote_packet_stats::rtt_buckets
+				     + 1, nr_types, "round-trip-times");
+
+    uiout->table_header (name_width, ui_left, "packet", "Packet");
+    for (int i = 0; i < remote_packet_stats::rtt_buckets; i++)
+      uiout->table_header (6, ui_right, bucket_fields[i], bucket_names[i]);
+    uiout->table_body ();
+
+    for (const auto &[name, type] : stats.packet_types)
+      {
+	ui_out_emit_tuple tuple_emitter (uiout, nullptr);
+
+	uiout->field_string ("packet", name);
+	for (int i = 0; i < remote_packet_stats::rtt_buckets; i++)
+	  uiout->field_unsigned (bucket_fields[i], type.rtt_histogram[i]);
+	uiout->text ("\n");
+      }
+  }
+}
+
+/* Return the packet statistics of the current remote target, or throw
+   an error if the current target is not remote.  */
+
+static remote_packet_stats &
+get_current_remote_packet_stats ()
+{
+  remote_packet_stats *stats
+    = remote_get_packet_stats (current_inferior ()->process_target ());
+  if (stats == nullptr)
+    error (_("The current target is not a remote target."));
+
+  return *stats;
+}
+
+/* Entry point for the 'maint info remote-stats' command.  */
+
+static void
+maintenance_info_remote_stats (const char *args, int from_tty)
+{
+  remote_print_packet_stats (current_uiout,
+			     get_current_remote_packet_stats ());
+}
+
+/* Entry point for the 'maint clear-remote-stats' command.  */
+
+static void
+maintenance_clear_remote_stats (const char *args, int from_tty)
+{
+  get_current_remote_packet_stats ().reset ();
+}
+
 #if 0
 /* --------- UNIT_TEST for THREAD oriented PACKETS ------------------- */
 
@@ -12599,6 +13281,48 @@ remote_target::read_description ()
   return beneath ()->read_description ();
 }
 
+/* Ask the stub for the hash of its target description, with the
+   qTDescHash packet.  GDB uses it to find a description it already
+   has, instead of reading the XML again.  */
+
+std::string
+remote_target::read_description_hash ()
+{
+  struct remote_state *rs = get_remote_state ();
+
+  /* The hash is only useful if we would otherwise read the
+     description with qXfer:features:read.  */
+  if (m_features.packet_support (PACKET_qTDescHash) == PACKET_DISABLE
+      || m_features.packet_support (PACKET_qXfer_features) == PACKET_DISABLE)
+    return {};
+
+  /* The description is that of the general process, as for
+     qXfer:features:read.  */
+  set_general_process ();
+
+  putpkt ("qTDescHash");
+  getpkt (&rs->buf);
+  if (m_features.packet_ok (rs->buf, PACKET_qTDescHash).status ()
+      != PACKET_OK)
+    return {};
+
+  /* The hash is used to name files in the description cache, so only
+     accept hex digits.  */
+  const char *p = rs->buf.data ();
+  size_t len = strlen (p);
+  if (len == 0 || len > 128
+      || !std::all_of (p, p + len, [] (char c)
+			{
+			  return isxdigit ((unsigned char) c);
+			}))
+    {
+      warning (_("Invalid qTDescHash reply: %s"), p);
+      return {};
+    }
+
+  return p;
+}
+
 /* Remote file transfer support.  This is host-initiated I/O, not
    target-initiated; for target-initiated, see remote-fileio.c.  */
 
@@ -12738,8 +13462,7 @@ remote_target::remote_hostio_send_command (int command_bytes, int which_packet,
 					   int *attachment_len)
 {
   struct remote_state *rs = get_remote_state ();
-  int ret, bytes_read;
-  const char *attachment_tmp;
+  int bytes_read;
 
   if (m_features.packet_support (which_packet) == PACKET_DISABLE)
     {
@@ -12750,6 +13473,24 @@ remote_target::remote_hostio_send_command (int command_bytes, int which_packet,
   putpkt_binary (rs->buf.data (), command_bytes);
   bytes_read = getpkt (&rs->buf);
 
+  return remote_hostio_read_reply (bytes_read, which_packet, remote_errno,
+				   attachment, attachment_len);
+}
+
+/* Parse the response to an I/O packet, which getpkt put in RS->BUF
+   and which is BYTES_READ long.  The other arguments and the return
+   value are as for remote_hostio_send_command.  */
+
+int
+remote_target::remote_hostio_read_reply (int bytes_read, int which_packet,
+					 fileio_error *remote_errno,
+					 const char **attachment,
+					 int *attachment_len)
+{
+  struct remote_state *rs = get_remote_state ();
+  int ret;
+  const char *attachment_tmp;
+
   /* If it timed out, something is wrong.  Don't try to parse the
      buffer.  */
   if (bytes_read < 0)
@@ -12986,6 +13727,141 @@ remote_target::remote_hostio_pread_vFile (int fd, gdb_byte *read_buf, int len,
   return ret;
 }
 
+/* The maximum number of vFile:pread requests that may be waiting for
+   a reply, when reading a large block of a file.  */
+
+static unsigned int remote_file_read_window = 8;
+
+/* Read LEN bytes at OFFSET in the file open as FD, as
+   remote_hostio_pread_vFile would, but splitting the read into
+   several vFile:pread packets, and sending up to
+   remote_file_read_window of them before waiting for the replies.
+   This hides the round trip time of all but the first request.  This
+   is only used if can_pipeline_requests is true.  Return the number
+   of bytes read, which is only less than LEN at end of file or if a
+   read failed; or -1 if nothing could be read.  */
+
+int
+remote_target::remote_hostio_pread_pipelined (int fd, gdb_byte *read_buf,
+					      int len, ULONGEST offset,
+					      fileio_error *remote_errno)
+{
+  struct remote_state *rs = get_remote_state ();
+
+  if (m_features.packet_support (PACKET_vFile_pread) == PACKET_DISABLE)
+    {
+      *remote_errno = FILEIO_ENOSYS;
+      return -1;
+    }
+
+  /* Ask for somewhat less than fits in a reply, so that escaping rarely
+     makes the stub return less than requested.  Short replies are
+     handled all the same, by asking for the rest again.  */
+  int chunk = std::max (1L, get_remote_packet_size () * 15 / 16 - 32);
+
+  /* A request for LEN bytes at offset BUF_OFF of READ_BUF.  */
+  struct request
+  {
+    int buf_off;
+    int len;
+  };
+
+  std::deque<request> to_send;
+  std::deque<request> in_flight;
+  for (int off = 0; off < len; off += chunk)
+    to_send.push_back ({ off, std::min (chunk, len - off) });
+
+  /* The offset in READ_BUF of the end of the file, if seen.  */
+  int end = len;
+  /* The offset in READ_BUF of the first read that failed, and the
+     reason.  */
+  int error_at = len;
+  fileio_error first_errno = FILEIO_SUCCESS;
+  /* Set if a reply did not hold as many bytes as it claimed.  Errors
+     can only be thrown once all the replies are read, or the
+     connection would be out of sync.  */
+  bool bad_reply = false;
+
+  while (!to_send.empty () || !in_flight.empty ())
+    {
+      while (!to_send.empty ()
+	     && in_flight.size () < remote_file_read_window)
+	{
+	  request req = to_send.front ();
+	  to_send.pop_front ();
+
+	  /* Nothing to read past the end of the file or a failure.  */
+	  if (req.buf_off >= std::min (end, error_at))
+	    continue;
+
+	  char *p = rs->buf.data ();
+	  int left = get_remote_packet_size ();
+
+	  remote_buffer_add_string (&p, &left, "vFile:pread:");
+	  remote_buffer_add_int (&p, &left, fd);
+	  remote_buffer_add_string (&p, &left, ",");
+	  remote_buffer_add_int (&p, &left, req.len);
+	  remote_buffer_add_string (&p, &left, ",");
+	  remote_buffer_add_int (&p, &left, offset + req.buf_off);
+
+	  putpkt_binary (rs->buf.data (), p - rs->buf.data ());
+	  in_flight.push_back (req);
+	}
+
+      if (in_flight.empty ())
+	break;
+
+      request req = in_flight.front ();
+      in_flight.pop_front ();
+
+      fileio_error err;
+      const char *attachment;
+      int attachment_len;
+      int ret;
+      try
+	{
+	  ret = remote_hostio_read_reply (getpkt (&rs->buf),
+					  PACKET_vFile_pread, &err,
+					  &attachment, &attachment_len);
+	}
+      catch (const gdb_exception &ex)
+	{
+	  discard_replies (in_flight.size (), ex);
+	  throw;
+	}
+      if (ret < 0)
+	{
+	  if (req.buf_off < error_at)
+	    {
+	      error_at = req.buf_off;
+	      first_errno = err;
+	    }
+	  continue;
+	}
+
+      int read_len = remote_unescape_input ((gdb_byte *) attachment,
+					    attachment_len,
+					    read_buf + req.buf_off, req.len);
+      if (read_len != ret)
+	bad_reply = true;
+      else if (ret == 0)
+	end = std::min (end, req.buf_off);
+      else if (ret < req.len)
+	to_send.push_front ({ req.buf_off + ret, req.len - ret });
+    }
+
+  if (bad_reply)
+    error (_("Read returned a different number of bytes than it sent."));
+
+  if (error_at == 0)
+    {
+      *remote_errno = first_errno;
+      return -1;
+    }
+
+  return std::min (end, error_at);
+}
+
 /* See declaration.h.  */
 
 int
@@ -13033,6 +13909,14 @@ remote_target::remote_hostio_pread (int fd, gdb_byte *read_buf, int len,
   remote_debug_printf ("readahead cache miss %s",
 		       pulongest (cache->miss_count));
 
+  /* Large reads are done in one go, with several requests in
+     flight.  */
+  if (can_pipeline_requests ()
+      && remote_file_read_window > 1
+      && len > get_remote_packet_size ())
+    return remote_hostio_pread_pipelined (fd, read_buf, len, offset,
+					  remote_errno);
+
   cache->fd = fd;
   cache->offset = offset;
   cache->buf.resize (get_remote_packet_size ());
@@ -16158,6 +17042,44 @@ test_packet_check_result ()
 
   SELF_CHECK (packet_check_result ("").status () == PACKET_UNKNOWN);
 }
+
+/* Test that the threads a thread list delta reports as removed, but
+   which can't be deleted yet, are deleted by a later update.  */
+
+static void
+test_deferred_thread_removals ()
+{
+  scoped_mock_context<test_target_ops> mock (current_inferior ()->arch ());
+  process_stratum_target *target = &mock.mock_target;
+
+  ptid_t ptid (1, 2);
+  thread_info *tp = add_thread_silent (target, ptid);
+
+  /* GDB asked to be told about the exit of TP, so it is kept.  */
+  tp->set_thread_options (GDB_THREAD_OPTION_EXIT);
+  std::vector<ptid_t> deferred = delete_removed_threads (target, { ptid });
+  SELF_CHECK (deferred == std::vector<ptid_t> { ptid });
+  SELF_CHECK (target->find_thread (ptid) == tp);
+
+  /* Retrying while that is still the case keeps it once.  */
+  deferred.push_back (ptid);
+  deferred = delete_removed_threads (target, deferred);
+  SELF_CHECK (deferred == std::vector<ptid_t> { ptid });
+
+  /* Once it no longer is, the retry deletes it.  */
+  tp->set_thread_options (0);
+  deferred = delete_removed_threads (target, deferred);
+  SELF_CHECK (deferred.empty ());
+  SELF_CHECK (target->find_thread (ptid) == nullptr);
+
+  /* The last thread of an inferior is kept, and threads GDB doesn't
+     know about are ignored.  */
+  deferred = delete_removed_threads (target, { mock.mock_ptid,
+					       ptid_t (1, 3) });
+  SELF_CHECK (deferred == std::vector<ptid_t> { mock.mock_ptid });
+  SELF_CHECK (target->find_thread (mock.mock_ptid) == &mock.mock_thread);
+}
+
 } /* namespace selftests */
 #endif /* GDB_SELF_TEST */
 
@@ -16207,6 +17129,18 @@ response packet.  GDB supplies the initial `$' character, and the\n\
 terminating `#' character and checksum."),
 	   &maintenancelist);
 
+  add_cmd ("remote-stats", class_maintenance, maintenance_info_remote_stats,
+	   _("\
+Show statistics about the packets exchanged with the remote target.\n\
+For each type of packet, this shows how many were sent, the number of\n\
+bytes sent and received, and how long the remote took to reply."),
+	   &maintenanceinfolist);
+
+  add_cmd ("clear-remote-stats", class_maintenance,
+	   maintenance_clear_remote_stats, _("\
+Reset the statistics about the packets exchanged with the remote target."),
+	   &maintenancelist);
+
   set_show_commands remotebreak_cmds
     = add_setshow_boolean_cmd ("remotebreak", no_class, &remote_break, _("\
 Set whether to send break if interrupted."), _("\
@@ -16268,6 +17202,36 @@ further restriction and \"limit\" to enable that restriction."),
 	   _("Show the maximum number of bytes per memory-read packet."),
 	   &remote_show_cmdlist);
 
+  add_setshow_zuinteger_cmd ("memory-read-window", no_class,
+			     &remote_memory_read_window, _("\
+Set how many memory read requests may wait for a reply at once."),
+			     _("\
+Show how many memory read requests may wait for a reply at once."),
+			     _("\
+When reading a large block of memory from the remote target, GDB sends\n\
+up to this many memory read packets before it waits for the first reply,\n\
+to avoid waiting a round trip for each packet.  This is only done if the\n\
+connection is in no-ack mode, and the remote stub reports that it supports\n\
+it.  0 or 1 means to send one packet at a time."),
+			     NULL, NULL,
+			     &remote_set_cmdlist,
+			     &remote_show_cmdlist);
+
+  add_setshow_zuinteger_cmd ("file-read-window", no_class,
+			     &remote_file_read_window, _("\
+Set how many file read requests may wait for a reply at once."),
+			     _("\
+Show how many file read requests may wait for a reply at once."),
+			     _("\
+When reading a large block of a file from the remote target, GDB sends\n\
+up to this many vFile:pread packets before it waits for the first reply,\n\
+to avoid waiting a round trip for each packet.  This is only done if the\n\
+connection is in no-ack mode, and the remote stub reports that it supports\n\
+it.  0 or 1 means to send one packet at a time."),
+			     NULL, NULL,
+			     &remote_set_cmdlist,
+			     &remote_show_cmdlist);
+
   add_setshow_zuinteger_unlimited_cmd ("hardware-watchpoint-limit", no_class,
 			    &remote_hw_watchpoint_limit, _("\
 Set the maximum number of target hardware watchpoints."), _("\
@@ -16357,6 +17321,9 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (PACKET_qXfer_features,
 			 "qXfer:features:read", "target-features", 0);
 
+  add_packet_config_cmd (PACKET_qTDescHash, "qTDescHash",
+			 "target-features-hash", 0);
+
   add_packet_config_cmd (PACKET_qXfer_libraries, "qXfer:libraries:read",
 			 "library-info", 0);
 
@@ -16371,6 +17338,9 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (PACKET_qXfer_threads, "qXfer:threads:read", "threads",
 			 0);
 
+  add_packet_config_cmd (PACKET_threads_delta, "qXfer:threads:read delta",
+			 "threads-delta", 0);
+
   add_packet_config_cmd (PACKET_qXfer_siginfo_read, "qXfer:siginfo:read",
 			 "read-siginfo-object", 0);
 
@@ -16399,6 +17369,9 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (PACKET_qSearch_memory, "qSearch:memory",
 			 "search-memory", 0);
 
+  add_packet_config_cmd (PACKET_qSearch_memory_any, "qSearch:memory-any",
+			 "search-memory-any", 0);
+
   add_packet_config_cmd (PACKET_qTStatus, "qTStatus", "trace-status", 0);
 
   add_packet_config_cmd (PACKET_vFile_setfs, "vFile:setfs", "hostio-setfs", 0);
@@ -16428,6 +17401,9 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
 
   add_packet_config_cmd (PACKET_QStartNoAckMode, "QStartNoAckMode", "noack", 0);
 
+  add_packet_config_cmd (PACKET_pipelined_requests, "pipelined-requests",
+			 "pipelined-requests", 0);
+
   add_packet_config_cmd (PACKET_vKill, "vKill", "kill", 0);
 
   add_packet_config_cmd (PACKET_qAttached, "qAttached", "query-attached", 0);
@@ -16676,5 +17652,7 @@ from the target."),
 			    selftests::test_memory_tagging_functions);
   selftests::register_test ("packet_check_result",
 			    selftests::test_packet_check_result);
+  selftests::register_test ("remote_deferred_thread_removals",
+			    selftests::test_deferred_thread_removals);
 #endif
 }
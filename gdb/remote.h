@@ -20,11 +20,15 @@
 #define GDB_REMOTE_H
 
 #include "remote-notif.h"
+#include <chrono>
+#include <deque>
+#include <map>
 
 struct target_desc;
 struct remote_target;
 
 class process_stratum_target;
+class ui_out;
 
 /* True when printing "remote" debug statements is enabled.  */
 
@@ -126,4 +130,99 @@ extern bool is_remote_target (process_stratum_target *target);
 
 extern bool remote_register_is_expedited (int regnum);
 
+/* Statistics about the packets exchanged with a remote target.  These
+   are gathered whether or not "set debug remote" is on.  Byte counts
+   are of packet contents, without the framing and checksum, and after
+   expanding run-length encoding.  */
+
+struct remote_packet_stats
+{
+  /* The upper bounds, in microseconds, of the buckets of the
+     round-trip time histograms.  The last bucket has no upper
+     bound.  */
+  static constexpr ULONGEST rtt_bucket_bounds[] =
+    { 10, 100, 1000, 10000, 100000, 1000000 };
+
+  static constexpr int rtt_buckets = ARRAY_SIZE (rtt_bucket_bounds) + 1;
+
+  /* Statistics about one type of packet, and the replies to it.  */
+  struct packet_type
+  {
+    /* The number of packets sent, and their size.  */
+    ULONGEST count = 0;
+    ULONGEST bytes_sent = 0;
+
+    /* The number of replies received, and their size.  */
+    ULONGEST replies = 0;
+    ULONGEST bytes_received = 0;
+
+    /* The total and longest time, in microseconds, between sending a
+       packet and receiving its reply, and their distribution.  */
+    ULONGEST total_rtt = 0;
+    ULONGEST max_rtt = 0;
+    ULONGEST rtt_histogram[rtt_buckets] {};
+  };
+
+  /* Record that packet BUF, which is LEN bytes long, is being
+     sent.  */
+  void record_sent (const char *buf, int len);
+
+  /* Record that a reply LEN bytes long was received.  It answers the
+     oldest packet sent whose reply wasn't received yet.  */
+  void record_received (int len);
+
+  /* Record that the last packet sent gets no reply, like "k".  */
+  void record_unanswered ();
+
+  /* Forget all statistics, and the packets in flight.  */
+  void reset ()
+  { *this = {}; }
+
+  /* Per packet type statistics.  Packets are grouped by their name,
+     for instance "m", "vCont" or "qXfer:features".  */
+  std::map<std::string, packet_type, std::less<>> packet_types;
+
+  /* Totals across all packet types.  */
+  ULONGEST packets_sent = 0;
+  ULONGEST packets_received = 0;
+  ULONGEST bytes_sent = 0;
+  ULONGEST bytes_received = 0;
+
+  /* The number of asynchronous notifications received.  */
+  ULONGEST notifications = 0;
+
+  /* The number of times a packet had to be sent again because the
+     remote did not acknowledge it.  */
+  ULONGEST retransmissions = 0;
+
+  /* The number of packets received with a bad checksum.  */
+  ULONGEST checksum_failures = 0;
+
+  /* A packet whose reply hasn't been received yet: its type, its
+     name, and when it was sent.  */
+  struct in_flight_packet
+  {
+    packet_type *type;
+    const std::string *name;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  /* The packets sent whose replies haven't been received yet, oldest
+     first.  The remote replies in order, so when GDB sends several
+     packets before reading their replies, as when reading memory or
+     files in chunks, each reply is matched with its own packet.  */
+  std::deque<in_flight_packet> in_flight;
+};
+
+/* Return the packet statistics of TARGET, or nullptr if TARGET is not
+   a remote target.  */
+
+extern remote_packet_stats *remote_get_packet_stats
+  (process_stratum_target *target);
+
+/* Print STATS to UIOUT.  */
+
+extern void remote_print_packet_stats (ui_out *uiout,
+				       const remote_packet_stats &stats);
+
 #endif /* GDB_REMOTE_H */
@@ -687,6 +687,8 @@ rs6000_nat_target::fetch_registers (struct regcache *regcache, int regno)
 const struct target_desc *
 rs6000_nat_target::read_description ()
 {
+   gdbarch_run_lazy_init (bfd_arch_rs6000);
+
    if (ARCH64())
      {
        if (__power_vsx ())
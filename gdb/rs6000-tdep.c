@@ -8722,14 +8722,11 @@ ppc_insn_prefix_dform (unsigned int insn1, unsigned int insn2)
 
 /* Initialization code.  */
 
-void _initialize_rs6000_tdep ();
-void
-_initialize_rs6000_tdep ()
-{
-  gdbarch_register (bfd_arch_rs6000, rs6000_gdbarch_init, rs6000_dump_tdep);
-  gdbarch_register (bfd_arch_powerpc, rs6000_gdbarch_init, rs6000_dump_tdep);
+/* Initialize the standard target descriptions.  */
 
-  /* Initialize the standard target descriptions.  */
+static void
+rs6000_init_tdescs ()
+{
   initialize_tdesc_powerpc_32 ();
   initialize_tdesc_powerpc_altivec32 ();
   initialize_tdesc_powerpc_vsx32 ();
@@ -8749,6 +8746,18 @@ _initialize_rs6000_tdep ()
   initialize_tdesc_powerpc_860 ();
   initialize_tdesc_powerpc_e500 ();
   initialize_tdesc_rs6000 ();
+}
+
+void _initialize_rs6000_tdep ();
+void
+_initialize_rs6000_tdep ()
+{
+  gdbarch_register (bfd_arch_rs6000, rs6000_gdbarch_init, rs6000_dump_tdep);
+  gdbarch_register (bfd_arch_powerpc, rs6000_gdbarch_init, rs6000_dump_tdep);
+
+  /* Create the target descriptions the first time they are needed.  */
+  gdbarch_register_lazy_init (bfd_arch_rs6000, rs6000_init_tdescs);
+  gdbarch_register_lazy_init (bfd_arch_powerpc, rs6000_init_tdescs);
 
   /* Add root prefix command for all "set powerpc"/"show powerpc"
      commands.  */
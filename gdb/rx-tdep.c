@@ -1068,5 +1068,7 @@ void
 _initialize_rx_tdep ()
 {
   gdbarch_register (bfd_arch_rx, rx_gdbarch_init);
-  initialize_tdesc_rx ();
+
+  /* Create the target description the first time it is needed.  */
+  gdbarch_register_lazy_init (bfd_arch_rx, initialize_tdesc_rx);
 }
@@ -994,6 +994,8 @@ s390_linux_nat_target::read_description ()
   if (inferior_ptid == null_ptid)
     return this->beneath ()->read_description ();
 
+  gdbarch_run_lazy_init (bfd_arch_s390);
+
   int tid = inferior_ptid.pid ();
 
   have_regset_last_break
@@ -1235,17 +1235,11 @@ s390_linux_init_abi_64 (struct gdbarch_info info, struct gdbarch *gdbarch)
   set_xml_syscall_file_name (gdbarch, XML_SYSCALL_FILENAME_S390X);
 }
 
-void _initialize_s390_linux_tdep ();
-void
-_initialize_s390_linux_tdep ()
-{
-  /* Hook us into the OSABI mechanism.  */
-  gdbarch_register_osabi (bfd_arch_s390, bfd_mach_s390_31, GDB_OSABI_LINUX,
-			  s390_linux_init_abi_31);
-  gdbarch_register_osabi (bfd_arch_s390, bfd_mach_s390_64, GDB_OSABI_LINUX,
-			  s390_linux_init_abi_64);
+/* Initialize the GNU/Linux target descriptions.  */
 
-  /* Initialize the GNU/Linux target descriptions.  */
+static void
+s390_linux_init_tdescs ()
+{
   initialize_tdesc_s390_linux32v1 ();
   initialize_tdesc_s390_linux32v2 ();
   initialize_tdesc_s390_linux64 ();
@@ -1262,3 +1256,17 @@ _initialize_s390_linux_tdep ()
   initialize_tdesc_s390x_tevx_linux64 ();
   initialize_tdesc_s390x_gs_linux64 ();
 }
+
+void _initialize_s390_linux_tdep ();
+void
+_initialize_s390_linux_tdep ()
+{
+  /* Hook us into the OSABI mechanism.  */
+  gdbarch_register_osabi (bfd_arch_s390, bfd_mach_s390_31, GDB_OSABI_LINUX,
+			  s390_linux_init_abi_31);
+  gdbarch_register_osabi (bfd_arch_s390, bfd_mach_s390_64, GDB_OSABI_LINUX,
+			  s390_linux_init_abi_64);
+
+  /* Create the target descriptions the first time they are needed.  */
+  gdbarch_register_lazy_init (bfd_arch_s390, s390_linux_init_tdescs);
+}
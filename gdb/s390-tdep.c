@@ -7515,6 +7515,15 @@ disassemble_s390x ()
 
 #endif /* GDB_SELF_TEST */
 
+/* Initialize the default target descriptions.  */
+
+static void
+s390_init_tdescs ()
+{
+  initialize_tdesc_s390_linux32 ();
+  initialize_tdesc_s390x_linux64 ();
+}
+
 void _initialize_s390_tdep ();
 void
 _initialize_s390_tdep ()
@@ -7522,8 +7531,8 @@ _initialize_s390_tdep ()
   /* Hook us into the gdbarch mechanism.  */
   gdbarch_register (bfd_arch_s390, s390_gdbarch_init);
 
-  initialize_tdesc_s390_linux32 ();
-  initialize_tdesc_s390x_linux64 ();
+  /* Create the target descriptions the first time they are needed.  */
+  gdbarch_register_lazy_init (bfd_arch_s390, s390_init_tdescs);
 
 #if GDB_SELF_TEST
   selftests::register_test ("disassemble-s390x",
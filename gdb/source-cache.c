@@ -24,6 +24,10 @@
 #include "objfiles.h"
 #include "exec.h"
 #include "cli/cli-cmds.h"
+#include "run-on-main-thread.h"
+#include "gdbsupport/thread-pool.h"
+#include "observable.h"
+#include <algorithm>
 
 #ifdef HAVE_SOURCE_HIGHLIGHT
 /* If Gnulib redirects 'open' and 'close' to its replacements
@@ -36,15 +40,23 @@
 #include <srchilite/sourcehighlight.h>
 #include <srchilite/langmap.h>
 #include <srchilite/settings.h>
+#if CXX_STD_THREAD
+#include <mutex>
+#endif
 #endif
 
 #if GDB_SELF_TEST
 #include "gdbsupport/selftest.h"
 #endif
 
-/* The number of source files we'll cache.  */
+/* The maximum number of bytes of source text we'll cache.  */
+
+static unsigned int source_cache_max_size = 32 * 1024 * 1024;
+
+/* Files at least this large are styled in the background.  -1 means
+   that styling is never done in the background.  */
 
-#define MAX_ENTRIES 5
+static int background_styling_threshold = 64 * 1024;
 
 /* See source-cache.h.  */
 
@@ -90,11 +102,37 @@ set_use_gnu_source_highlight_enabled (const char *ignore_args,
 #endif
 }
 
+/* Return the offset of the start of each line in TEXT.  */
+
+static std::vector<off_t>
+compute_line_offsets (std::string_view text)
+{
+  const char *start = text.data ();
+  const char *end = start + text.size ();
+
+  std::vector<off_t> offsets;
+  offsets.push_back (0);
+  /* memchr is much faster than a byte-at-a-time loop on large
+     files.  */
+  for (const char *p = start;
+       (p = (const char *) memchr (p, '\n', end - p)) != nullptr;)
+    {
+      ++p;
+      /* A newline at the end does not start a new line.  It would
+	 seem simpler to just strip the newline in this function, but
+	 then "list" won't print the final newline.  */
+      if (p != end)
+	offsets.push_back (p - start);
+    }
+
+  offsets.shrink_to_fit ();
+  return offsets;
+}
+
 /* See source-cache.h.  */
 
-std::string
-source_cache::get_plain_source_lines (struct symtab *s,
-				      const std::string &fullname)
+void
+source_cache::get_plain_source_lines (struct symtab *s, source_text &result)
 {
   scoped_fd desc (open_source_file (s));
   if (desc.get () < 0)
@@ -104,10 +142,24 @@ source_cache::get_plain_source_lines (struct symtab *s,
   if (fstat (desc.get (), &st) < 0)
     perror_with_name (symtab_to_filename_for_display (s));
 
-  std::string lines;
-  lines.resize (st.st_size);
-  if (myread (desc.get (), &lines[0], lines.size ()) < 0)
-    perror_with_name (symtab_to_filename_for_display (s));
+  result.file_size = st.st_size;
+  result.file_mtime = st.st_mtime;
+  result.file_ino = st.st_ino;
+
+#ifdef HAVE_SYS_MMAN_H
+  /* An empty file can't be mapped; neither can some special files,
+     in which case the contents are read instead.  */
+  if (st.st_size > 0 && S_ISREG (st.st_mode))
+    result.mapping.reset (nullptr, st.st_size, PROT_READ, MAP_PRIVATE,
+			  desc.get (), 0);
+  if (result.mapping.get () == MAP_FAILED)
+#endif
+    {
+      result.contents.resize (st.st_size);
+      if (myread (desc.get (), &result.contents[0],
+		  result.contents.size ()) < 0)
+	perror_with_name (symtab_to_filename_for_display (s));
+    }
 
   time_t mtime = 0;
   if (s->compunit ()->objfile () != NULL
@@ -119,24 +171,46 @@ source_cache::get_plain_source_lines (struct symtab *s,
   if (mtime && mtime < st.st_mtime)
     warning (_("Source file is more recent than executable."));
 
-  std::vector<off_t> offsets;
-  offsets.push_back (0);
-  for (size_t offset = lines.find ('\n');
-       offset != std::string::npos;
-       offset = lines.find ('\n', offset))
+  m_offset_cache.insert_or_assign (result.fullname,
+				   compute_line_offsets (result.text ()));
+}
+
+/* See source-cache.h.  */
+
+bool
+source_cache::source_text::unchanged_p () const
+{
+#ifdef HAVE_SYS_MMAN_H
+  /* Reading from the mapping of a file that was truncated would
+     crash, so check that the file is still what we mapped.  Files
+     that were read into memory are a private copy, and are not
+     checked.  */
+  if (mapping.get () != MAP_FAILED)
     {
-      ++offset;
-      /* A newline at the end does not start a new line.  It would
-	 seem simpler to just strip the newline in this function, but
-	 then "list" won't print the final newline.  */
-      if (offset != lines.size ())
-	offsets.push_back (offset);
+      struct stat st;
+      if (stat (fullname.c_str (), &st) < 0)
+	return false;
+      return (st.st_size == file_size
+	      && st.st_mtime == file_mtime
+	      && st.st_ino == file_ino);
     }
+#endif
+  return true;
+}
 
-  offsets.shrink_to_fit ();
-  m_offset_cache.emplace (fullname, std::move (offsets));
+/* See source-cache.h.  */
+
+size_t
+source_cache::entry_size (const source_text &entry) const
+{
+  size_t result = (entry.text ().size ()
+		   + entry.styled_offsets.size () * sizeof (off_t));
+
+  auto iter = m_offset_cache.find (entry.fullname);
+  if (iter != m_offset_cache.end ())
+    result += iter->second.size () * sizeof (off_t);
 
-  return lines;
+  return result;
 }
 
 #ifdef HAVE_SOURCE_HIGHLIGHT
@@ -194,18 +268,24 @@ get_language_name (enum language lang)
 
 #endif /* HAVE_SOURCE_HIGHLIGHT */
 
-/* Try to highlight CONTENTS from file FULLNAME in language LANG using
-   the GNU source-highlight library.  Return true if highlighting
-   succeeded.  */
+/* Highlight CONTENTS from file FULLNAME in language LANG using the
+   GNU source-highlight library.  Return true if highlighting
+   succeeded.  Unlike try_source_highlight, this does not check
+   whether use of the library is enabled, and it may be called from a
+   worker thread.  */
 
 static bool
-try_source_highlight (std::string &contents ATTRIBUTE_UNUSED,
-		      enum language lang ATTRIBUTE_UNUSED,
-		      const std::string &fullname ATTRIBUTE_UNUSED)
+source_highlight (std::string &contents ATTRIBUTE_UNUSED,
+		  enum language lang ATTRIBUTE_UNUSED,
+		  const std::string &fullname ATTRIBUTE_UNUSED)
 {
 #ifdef HAVE_SOURCE_HIGHLIGHT
-  if (!use_gnu_source_highlight)
-    return false;
+#if CXX_STD_THREAD
+  /* The highlighter objects below are shared by the main thread and
+     background styling.  */
+  static std::mutex highlighter_mutex;
+  std::lock_guard<std::mutex> guard (highlighter_mutex);
+#endif
 
   const char *lang_name = get_language_name (lang);
 
@@ -260,6 +340,20 @@ try_source_highlight (std::string &contents ATTRIBUTE_UNUSED,
 #endif /* HAVE_SOURCE_HIGHLIGHT */
 }
 
+/* Try to highlight CONTENTS from file FULLNAME in language LANG using
+   the GNU source-highlight library.  Return true if highlighting
+   succeeded.  */
+
+static bool
+try_source_highlight (std::string &contents, enum language lang,
+		      const std::string &fullname)
+{
+  if (!use_gnu_source_highlight)
+    return false;
+
+  return source_highlight (contents, lang, fullname);
+}
+
 #ifdef HAVE_SOURCE_HIGHLIGHT
 #if GDB_SELF_TEST
 namespace selftests
@@ -305,102 +399,228 @@ static void gnu_source_highlight_test ()
 
 /* See source-cache.h.  */
 
-bool
-source_cache::ensure (struct symtab *s)
+void
+source_cache::erase (std::list<source_text>::iterator entry)
 {
-  std::string fullname = symtab_to_fullname (s);
+  m_total_size -= entry_size (*entry);
+  m_offset_cache.erase (entry->fullname);
+  m_source_map.erase (entry);
+}
+
+/* See source-cache.h.  */
+
+void
+source_cache::trim ()
+{
+  while (m_total_size > source_cache_max_size && m_source_map.size () > 1)
+    erase (m_source_map.begin ());
+}
+
+/* See source-cache.h.  */
+
+void
+source_cache::install_styled (source_text &entry, std::string &&contents)
+{
+  m_total_size -= entry_size (entry);
+
+  entry.styled_offsets = compute_line_offsets (contents);
+  entry.contents = std::move (contents);
+  entry.styled = true;
+#ifdef HAVE_SYS_MMAN_H
+  /* The plain text is no longer needed.  */
+  scoped_mmap plain (std::move (entry.mapping));
+#endif
+
+  m_total_size += entry_size (entry);
+}
+
+/* See source-cache.h.  */
+
+void
+source_cache::style (source_text &entry, enum language lang)
+{
+  gdb_assert (!entry.styled && !entry.styling_pending);
+
+  std::string contents (entry.text ());
 
-  size_t size = m_source_map.size ();
-  for (int i = 0; i < size; ++i)
+  if (background_styling_threshold != -1
+      && contents.size () >= background_styling_threshold)
     {
-      if (m_source_map[i].fullname == fullname)
+      unsigned int id = entry.id;
+      entry.styling_pending = true;
+
+      if (use_gnu_source_highlight)
+	gdb::thread_pool::g_thread_pool->post_task
+	  ([this, id, lang, fullname = entry.fullname,
+	    contents = std::move (contents)] () mutable
+	   {
+	     bool styled = source_highlight (contents, lang, fullname);
+	     run_on_main_thread
+	       ([this, id, lang, styled,
+		 contents = std::move (contents)] () mutable
+		{
+		  finish_styling (id, lang, styled, std::move (contents));
+		});
+	   });
+      else
 	{
-	  /* This should always hold, because we create the file offsets
-	     when reading the file.  */
-	  gdb_assert (m_offset_cache.find (fullname)
-		      != m_offset_cache.end ());
-	  /* Not strictly LRU, but at least ensure that the most
-	     recently used entry is always the last candidate for
-	     deletion.  Note that this property is relied upon by at
-	     least one caller.  */
-	  if (i != size - 1)
-	    std::swap (m_source_map[i], m_source_map[size - 1]);
-
-	  /* If the styling status of the cached entry matches our desired
-	     styling status, or we know this file cannot be styled, in
-	     which case, this (unstyled) content, is the best we can do.  */
-	  if (((source_styling && gdb_stdout->can_emit_style_escape ())
-	       == m_source_map[size - 1].styled)
-	      || m_no_styling_files.count (fullname) > 0)
-	    return true;
+	  /* Python can only be used on the main thread.  Leave the
+	     styling to the event loop, so that the plain text is shown
+	     first.  */
+	  run_on_main_thread
+	    ([this, id, lang, contents = std::move (contents)] () mutable
+	     {
+	       finish_styling (id, lang, false, std::move (contents));
+	     });
+	}
+      return;
+    }
 
-	  /* We found a match, but styling status doesn't match the desired
-	     styling status.  We already moved the matching item to the
-	     back of M_SOURCE_MAP, so drop the entry now, and then
-	     recompute with the desired styling.  */
-	  m_source_map.pop_back ();
-	  break;
+  bool styled_p = try_source_highlight (contents, lang, entry.fullname);
+  if (!styled_p)
+    {
+      std::optional<std::string> ext_contents
+	= ext_lang_colorize (entry.fullname, contents, lang);
+      if (ext_contents.has_value ())
+	{
+	  contents = std::move (*ext_contents);
+	  styled_p = true;
 	}
     }
 
-  std::string contents;
-  bool styled_p = false;
-  try
+  if (styled_p)
+    install_styled (entry, std::move (contents));
+  else
     {
-      contents = get_plain_source_lines (s, fullname);
+      /* Styling failed.  Styling can fail for instance for these
+	 reasons:
+	 - the language is not supported.
+	 - the language cannot not be auto-detected from the file name.
+	 - no stylers available.
+
+	 Since styling failed, don't try styling the file again after it
+	 drops from the cache.
+
+	 Note that clearing the source cache also clears
+	 m_no_styling_files.  */
+      m_no_styling_files.insert (entry.fullname);
     }
-  catch (const gdb_exception_error &e)
+}
+
+/* See source-cache.h.  */
+
+void
+source_cache::finish_styling (unsigned int id, enum language lang,
+			      bool styled, std::string &&contents)
+{
+  auto iter = std::find_if (m_source_map.begin (), m_source_map.end (),
+			    [id] (const source_text &entry)
+			    {
+			      return entry.id == id;
+			    });
+
+  /* The entry may have been dropped from the cache in the
+     meantime.  */
+  if (iter == m_source_map.end ())
+    return;
+
+  iter->styling_pending = false;
+
+  if (!styled)
     {
-      /* If 's' is not found, an exception is thrown.  */
-      return false;
+      std::optional<std::string> ext_contents
+	= ext_lang_colorize (iter->fullname, contents, lang);
+      if (ext_contents.has_value ())
+	{
+	  contents = std::move (*ext_contents);
+	  styled = true;
+	}
     }
 
-  if (source_styling && gdb_stdout->can_emit_style_escape ()
-      && m_no_styling_files.count (fullname) == 0)
+  if (!styled)
     {
-      styled_p
-	= try_source_highlight (contents, s->language (), fullname);
+      /* See source_cache::style.  */
+      m_no_styling_files.insert (iter->fullname);
+      return;
+    }
+
+  install_styled (*iter, std::move (contents));
+  trim ();
 
-      if (!styled_p)
+  /* Have the source shown again, now with styling.  */
+  gdb::observers::styling_changed.notify ();
+}
+
+/* See source-cache.h.  */
+
+bool
+source_cache::ensure (struct symtab *s)
+{
+  std::string fullname = symtab_to_fullname (s);
+  bool want_styled = source_styling && gdb_stdout->can_emit_style_escape ();
+
+  auto iter = std::find_if (m_source_map.begin (), m_source_map.end (),
+			    [&] (const source_text &entry)
+			    {
+			      return entry.fullname == fullname;
+			    });
+  if (iter != m_source_map.end ())
+    {
+      /* This should always hold, because we create the file offsets
+	 when reading the file.  */
+      gdb_assert (m_offset_cache.find (fullname) != m_offset_cache.end ());
+
+      if (!iter->unchanged_p ())
+	erase (iter);
+      else
 	{
-	  std::optional<std::string> ext_contents;
-	  ext_contents = ext_lang_colorize (fullname, contents,
-					    s->language ());
-	  if (ext_contents.has_value ())
+	  /* Ensure that the most recently used entry is always the
+	     last candidate for deletion.  Note that this property is
+	     relied upon by at least one caller.  */
+	  m_source_map.splice (m_source_map.end (), m_source_map, iter);
+
+	  /* If the styling status of the cached entry matches our
+	     desired styling status, or styling is on its way, or we
+	     know this file cannot be styled, in which case, this
+	     (unstyled) content, is the best we can do.  */
+	  if (want_styled == iter->styled
+	      || iter->styling_pending
+	      || m_no_styling_files.count (fullname) > 0)
+	    return true;
+
+	  /* The plain text can be styled right away.  */
+	  if (want_styled)
 	    {
-	      contents = std::move (*ext_contents);
-	      styled_p = true;
+	      style (*iter, s->language ());
+	      trim ();
+	      return true;
 	    }
-	}
 
-      if (!styled_p)
-	{
-	  /* Styling failed.  Styling can fail for instance for these
-	     reasons:
-	     - the language is not supported.
-	     - the language cannot not be auto-detected from the file name.
-	     - no stylers available.
-
-	     Since styling failed, don't try styling the file again after it
-	     drops from the cache.
-
-	     Note that clearing the source cache also clears
-	     m_no_styling_files.  */
-	  m_no_styling_files.insert (fullname);
+	  /* The entry is styled, but styling is not wanted; drop the
+	     entry, and read the file again.  */
+	  erase (iter);
 	}
     }
 
-  source_text result
-    = { std::move (fullname), std::move (contents), styled_p };
-  m_source_map.push_back (std::move (result));
-
-  if (m_source_map.size () > MAX_ENTRIES)
+  source_text &entry = m_source_map.emplace_back ();
+  entry.id = m_next_id++;
+  entry.fullname = std::move (fullname);
+  try
     {
-      auto iter = m_source_map.begin ();
-      m_offset_cache.erase (iter->fullname);
-      m_source_map.erase (iter);
+      get_plain_source_lines (s, entry);
     }
+  catch (const gdb_exception_error &e)
+    {
+      /* If 's' is not found, an exception is thrown.  */
+      m_source_map.pop_back ();
+      return false;
+    }
+  m_total_size += entry_size (entry);
+
+  if (want_styled && m_no_styling_files.count (entry.fullname) == 0)
+    style (entry, s->language ());
 
+  trim ();
   return true;
 }
 
@@ -427,44 +647,28 @@ source_cache::get_line_charpos (struct symtab *s,
 }
 
 /* A helper function that extracts the desired source lines from TEXT,
-   putting them into LINES_OUT.  The arguments are as for
-   get_source_lines.  Returns true on success, false if the line
-   numbers are invalid.  */
+   whose lines start at OFFSETS, putting them into LINES_OUT.  The
+   other arguments are as for get_source_lines.  Returns true on
+   success, false if the line numbers are invalid.  */
 
 static bool
-extract_lines (const std::string &text, int first_line, int last_line,
-	       std::string *lines_out)
+extract_lines (std::string_view text, const std::vector<off_t> &offsets,
+	       int first_line, int last_line, std::string *lines_out)
 {
-  int lineno = 1;
-  std::string::size_type pos = 0;
-  std::string::size_type first_pos = std::string::npos;
-
-  while (pos != std::string::npos && lineno <= last_line)
-    {
-      std::string::size_type new_pos = text.find ('\n', pos);
-
-      if (lineno == first_line)
-	first_pos = pos;
+  if (first_line < 1 || first_line > last_line
+      || first_line > offsets.size ())
+    return false;
 
-      pos = new_pos;
-      if (lineno == last_line || pos == std::string::npos)
-	{
-	  /* A newline at the end does not start a new line.  */
-	  if (first_pos == std::string::npos
-	      || first_pos == text.size ())
-	    return false;
-	  if (pos == std::string::npos)
-	    pos = text.size ();
-	  else
-	    ++pos;
-	  *lines_out = text.substr (first_pos, pos - first_pos);
-	  return true;
-	}
-      ++lineno;
-      ++pos;
-    }
+  size_t first_pos = offsets[first_line - 1];
+  /* A newline at the end does not start a new line.  */
+  if (first_pos == text.size ())
+    return false;
 
-  return false;
+  size_t last_pos = (last_line < offsets.size ()
+		     ? offsets[last_line]
+		     : text.size ());
+  *lines_out = text.substr (first_pos, last_pos - first_pos);
+  return true;
 }
 
 /* See source-cache.h.  */
@@ -479,7 +683,14 @@ source_cache::get_source_lines (struct symtab *s, int first_line,
   if (!ensure (s))
     return false;
 
-  return extract_lines (m_source_map.back ().contents,
+  const source_text &entry = m_source_map.back ();
+  if (entry.styled)
+    return extract_lines (entry.text (), entry.styled_offsets,
+			  first_line, last_line, lines);
+
+  auto iter = m_offset_cache.find (entry.fullname);
+  gdb_assert (iter != m_offset_cache.end ());
+  return extract_lines (entry.text (), iter->second,
 			first_line, last_line, lines);
 }
 
@@ -492,21 +703,63 @@ source_cache_flush_command (const char *command, int from_tty)
   gdb_printf (_("Source cache flushed.\n"));
 }
 
+/* The "maint set source-cache max-size" command.  */
+
+static void
+set_source_cache_max_size (const char *args, int from_tty,
+			   struct cmd_list_element *c)
+{
+  g_source_cache.trim ();
+}
+
+/* The "maint show source-cache max-size" command.  */
+
+static void
+show_source_cache_max_size (struct ui_file *file, int from_tty,
+			    struct cmd_list_element *c, const char *value)
+{
+  gdb_printf (file, _("The source cache holds at most %s bytes.\n"),
+	      value);
+}
+
+/* The "maint show source-cache background-styling-threshold"
+   command.  */
+
+static void
+show_background_styling_threshold (struct ui_file *file, int from_tty,
+				   struct cmd_list_element *c,
+				   const char *value)
+{
+  gdb_printf (file,
+	      _("Source files of at least %s bytes are styled "
+		"in the background.\n"),
+	      value);
+}
+
 #if GDB_SELF_TEST
 namespace selftests
 {
 static void extract_lines_test ()
 {
   std::string input_text = "abc\ndef\nghi\njkl\n";
+  std::vector<off_t> offsets = compute_line_offsets (input_text);
   std::string result;
 
-  SELF_CHECK (extract_lines (input_text, 1, 1, &result)
+  SELF_CHECK (offsets == std::vector<off_t> ({ 0, 4, 8, 12 }));
+  SELF_CHECK (extract_lines (input_text, offsets, 1, 1, &result)
 	      && result == "abc\n");
-  SELF_CHECK (!extract_lines (input_text, 2, 1, &result));
-  SELF_CHECK (extract_lines (input_text, 1, 2, &result)
+  SELF_CHECK (!extract_lines (input_text, offsets, 2, 1, &result));
+  SELF_CHECK (extract_lines (input_text, offsets, 1, 2, &result)
 	      && result == "abc\ndef\n");
-  SELF_CHECK (extract_lines ("abc", 1, 1, &result)
+  SELF_CHECK (extract_lines (input_text, offsets, 3, 10, &result)
+	      && result == "ghi\njkl\n");
+  SELF_CHECK (!extract_lines (input_text, offsets, 5, 5, &result));
+
+  std::string abc = "abc";
+  SELF_CHECK (extract_lines (abc, compute_line_offsets (abc), 1, 1, &result)
 	      && result == "abc");
+  SELF_CHECK (!extract_lines ("", compute_line_offsets (""), 1, 1,
+			      &result));
 }
 }
 #endif
@@ -519,6 +772,44 @@ _initialize_source_cache ()
 	   _("Force gdb to flush its source code cache."),
 	   &maintenanceflushlist);
 
+  /* All the 'maint set|show source-cache' sub-commands.  */
+  static struct cmd_list_element *maint_set_source_cache_cmdlist;
+  static struct cmd_list_element *maint_show_source_cache_cmdlist;
+
+  add_setshow_prefix_cmd ("source-cache", class_maintenance,
+			  _("Set source cache specific variables."),
+			  _("Show source cache specific variables."),
+			  &maint_set_source_cache_cmdlist,
+			  &maint_show_source_cache_cmdlist,
+			  &maintenance_set_cmdlist,
+			  &maintenance_show_cmdlist);
+
+  add_setshow_uinteger_cmd ("max-size", class_maintenance,
+			    &source_cache_max_size, _("\
+Set the maximum size of the source cache, in bytes."), _("\
+Show the maximum size of the source cache, in bytes."), _("\
+The least recently used source files are dropped from the cache when\n\
+the text of the cached files, styled or not, exceeds this size.  The\n\
+most recently used file is always kept.\n\
+Use \"unlimited\" or 0 to not limit the size of the cache."),
+			    set_source_cache_max_size,
+			    show_source_cache_max_size,
+			    &maint_set_source_cache_cmdlist,
+			    &maint_show_source_cache_cmdlist);
+
+  add_setshow_zuinteger_unlimited_cmd ("background-styling-threshold",
+				       class_maintenance,
+				       &background_styling_threshold, _("\
+Set the size from which source files are styled in the background."), _("\
+Show the size from which source files are styled in the background."), _("\
+Source files of at least this many bytes are shown without styling\n\
+until styling, which is done in the background, completes.\n\
+Use \"unlimited\" to always style source files before showing them."),
+				       nullptr,
+				       show_background_styling_threshold,
+				       &maint_set_source_cache_cmdlist,
+				       &maint_show_source_cache_cmdlist);
+
   /* All the 'maint set|show gnu-source-highlight' sub-commands.  */
   static struct cmd_list_element *maint_set_gnu_source_highlight_cmdlist;
   static struct cmd_list_element *maint_show_gnu_source_highlight_cmdlist;
@@ -21,18 +21,26 @@
 
 #include "gdbsupport/unordered_map.h"
 #include "gdbsupport/unordered_set.h"
+#include "gdbsupport/scoped_mmap.h"
+#include <list>
 
 /* This caches two things related to source files.
 
-   First, it caches highlighted source text, keyed by the source
-   file's full name.  A size-limited LRU cache is used.
+   First, it caches source text, keyed by the source file's full name.
+   An LRU cache is used, bounded by the total number of bytes held in
+   it.  Un-highlighted text is mapped into memory directly from the
+   file where possible.
 
-   Highlighting depends on the GNU Source Highlight library.  When not
-   available or when highlighting fails for some reason, this cache
-   will instead store the un-highlighted source text.
+   Highlighting depends on the GNU Source Highlight library or on the
+   Pygments Python package.  When not available or when highlighting
+   fails for some reason, this cache will instead store the
+   un-highlighted source text.  Large files are highlighted in the
+   background; until that is done, the un-highlighted text is
+   returned.
 
    Second, this will cache the file offsets corresponding to the start
-   of each line of a source file.  This cache is not size-limited.  */
+   of each line of a source file.  These are dropped along with the
+   file's text.  */
 class source_cache
 {
 public:
@@ -61,39 +69,106 @@ class source_cache
   bool get_source_lines (struct symtab *s, int first_line,
 			 int last_line, std::string *lines_out);
 
-  /* Remove all the items from the source cache.  */
+  /* Remove all the items from the source cache.  Styling that is
+     still in progress is discarded when it completes.  */
   void clear ()
   {
     m_source_map.clear ();
     m_offset_cache.clear ();
     m_no_styling_files.clear ();
+    m_total_size = 0;
   }
 
+  /* Drop entries, least recently used first, until the cache fits
+     in its size limit.  The most recently used entry is never
+     dropped.  */
+  void trim ();
+
 private:
 
   /* One element in the cache.  */
   struct source_text
   {
+    /* Return the text of the file, styled or not.  */
+    std::string_view text () const
+    {
+#ifdef HAVE_SYS_MMAN_H
+      if (mapping.get () != MAP_FAILED)
+	return std::string_view ((const char *) mapping.get (),
+				 mapping.size ());
+#endif
+      return contents;
+    }
+
+    /* Return true if the file has not changed since it was mapped
+       into memory.  Entries that were not mapped are not checked.  */
+    bool unchanged_p () const;
+
+    /* A number identifying this entry, used to find it again once
+       background styling completes.  */
+    unsigned int id = 0;
     /* The full name of the file.  */
     std::string fullname;
-    /* The contents of the file.  */
+    /* The size, modification time and inode of the file when it was
+       read.  Used to notice a file that changed under a mapping.  */
+    off_t file_size = 0;
+    time_t file_mtime = 0;
+    ino_t file_ino = 0;
+#ifdef HAVE_SYS_MMAN_H
+    /* The un-styled contents of the file, when mapped.  */
+    scoped_mmap mapping;
+#endif
+    /* The contents of the file, if styled or if the file could not
+       be mapped.  */
     std::string contents;
+    /* The offset of each line in CONTENTS, when styled.  For
+       un-styled text, the file offsets in M_OFFSET_CACHE are used.  */
+    std::vector<off_t> styled_offsets;
     /* True if CONTENTS are styled.  Otherwise, false.  */
-    bool styled;
+    bool styled = false;
+    /* True if the file is being styled in the background.  */
+    bool styling_pending = false;
   };
 
-  /* A helper function for get_source_lines reads a source file.
-     Returns the contents of the file; or throws an exception on
-     error.  This also updates m_offset_cache.  */
-  std::string get_plain_source_lines (struct symtab *s,
-				      const std::string &fullname);
+  /* A helper function for ensure that reads a source file into
+     RESULT.  Throws an exception on error.  This also updates
+     m_offset_cache.  */
+  void get_plain_source_lines (struct symtab *s, source_text &result);
 
   /* A helper function that the data for the given symtab is entered
      into both caches.  Returns false on error.  */
   bool ensure (struct symtab *s);
 
-  /* The contents of the source text cache.  */
-  std::vector<source_text> m_source_map;
+  /* Style the un-styled text in ENTRY, which is in language LANG.
+     Small files are styled right away; larger ones are styled in the
+     background, see finish_styling.  */
+  void style (source_text &entry, enum language lang);
+
+  /* Called on the main thread when background styling of the entry
+     with identifier ID completes.  STYLED is true if CONTENTS holds
+     the styled text; otherwise, CONTENTS are still plain.  */
+  void finish_styling (unsigned int id, enum language lang, bool styled,
+		       std::string &&contents);
+
+  /* Replace the contents of ENTRY with the styled text CONTENTS.  */
+  void install_styled (source_text &entry, std::string &&contents);
+
+  /* The number of bytes attributed to ENTRY, including its line
+     offsets.  */
+  size_t entry_size (const source_text &entry) const;
+
+  /* Remove ENTRY from the cache.  */
+  void erase (std::list<source_text>::iterator entry);
+
+  /* The contents of the source text cache, most recently used
+     last.  */
+  std::list<source_text> m_source_map;
+
+  /* The sum of the sizes of the entries in M_SOURCE_MAP.  */
+  size_t m_total_size = 0;
+
+  /* The identifier to give the next entry.  */
+  unsigned int m_next_id = 0;
 
   /* The file offset cache.  The key is the full name of the source
      file.  */
@@ -25,6 +25,33 @@
 static const registry<address_space>::key<DCACHE, dcache_deleter>
   target_dcache_aspace_key;
 
+/* See target_dcache_generation.  */
+
+static ULONGEST target_dcache_generation_counter;
+
+/* A write to target memory by GDB.  */
+
+struct memory_write
+{
+  /* The generation that the write started.  */
+  ULONGEST generation;
+
+  CORE_ADDR addr;
+  ULONGEST len;
+};
+
+/* The writes to target memory since generation WRITE_LOG_BASE, which
+   is when the log was last emptied.  Writes before that are
+   forgotten.  */
+
+static std::vector<memory_write> write_log;
+static ULONGEST write_log_base;
+
+/* The most writes kept in WRITE_LOG.  When there are more, the log is
+   emptied, as if the whole memory had changed.  */
+
+static constexpr size_t max_write_log = 256;
+
 /* Target dcache is initialized or not.  */
 
 int
@@ -44,10 +71,55 @@ target_dcache_invalidate (address_space_ref_ptr aspace)
   DCACHE *dcache
     = target_dcache_aspace_key.get (aspace.get ());
 
+  target_dcache_generation_counter++;
+  write_log.clear ();
+  write_log_base = target_dcache_generation_counter;
+
   if (dcache != NULL)
     dcache_invalidate (dcache);
 }
 
+/* See target-dcache.h.  */
+
+ULONGEST
+target_dcache_generation ()
+{
+  return target_dcache_generation_counter;
+}
+
+/* See target-dcache.h.  */
+
+void
+target_dcache_note_memory_write (CORE_ADDR addr, ULONGEST len)
+{
+  target_dcache_generation_counter++;
+
+  if (write_log.size () == max_write_log)
+    {
+      write_log.clear ();
+      write_log_base = target_dcache_generation_counter;
+    }
+  else
+    write_log.push_back ({ target_dcache_generation_counter, addr, len });
+}
+
+/* See target-dcache.h.  */
+
+bool
+target_dcache_writes_since (ULONGEST generation,
+			    gdb::function_view<void (CORE_ADDR,
+						     ULONGEST)> callback)
+{
+  if (generation < write_log_base)
+    return false;
+
+  for (const memory_write &write : write_log)
+    if (write.generation > generation)
+      callback (write.addr, write.len);
+
+  return true;
+}
+
 /* Return the target dcache.  Return NULL if target dcache is not
    initialized yet.  */
 
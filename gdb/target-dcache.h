@@ -20,6 +20,7 @@
 
 #include "dcache.h"
 #include "progspace.h"
+#include "gdbsupport/function-view.h"
 
 extern void target_dcache_invalidate (address_space_ref_ptr aspace);
 
@@ -33,4 +34,26 @@ extern int stack_cache_enabled_p (void);
 
 extern int code_cache_enabled_p (void);
 
+/* Return a number that changes whenever host-side copies of target
+   memory may have become stale: whenever the target dcache of some
+   address space is invalidated, and whenever GDB writes to target
+   memory.  A copy filled when this returned N is still current as
+   long as it returns N.  */
+
+extern ULONGEST target_dcache_generation ();
+
+/* Note that GDB wrote LEN bytes to target memory at ADDR.  */
+
+extern void target_dcache_note_memory_write (CORE_ADDR addr, ULONGEST len);
+
+/* If GDB's own writes are the only changes to target memory that may
+   have happened since target_dcache_generation returned GENERATION,
+   call CALLBACK with the address and length of each of them, and
+   return true.  Otherwise, for instance if the inferior may have run
+   since, return false.  */
+
+extern bool target_dcache_writes_since
+  (ULONGEST generation,
+   gdb::function_view<void (CORE_ADDR addr, ULONGEST len)> callback);
+
 #endif /* GDB_TARGET_DCACHE_H */
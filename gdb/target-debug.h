@@ -345,6 +345,26 @@ target_debug_print_size_t (size_t size)
   return pulongest (size);
 }
 
+static std::string
+target_debug_print_size_t_p (size_t *size)
+{
+  return pulongest (*size);
+}
+
+static std::string
+target_debug_print_search_patterns
+  (gdb::array_view<const search_pattern> patterns)
+{
+  std::string s = "{";
+
+  for (const search_pattern &pattern : patterns)
+    string_appendf (s, " %s", pulongest (pattern.size ()));
+
+  s += " }";
+
+  return s;
+}
+
 static std::string
 target_debug_print_gdb_array_view_const_gdb_byte (gdb::array_view<const gdb_byte> vector)
 {
@@ -120,9 +120,11 @@ struct dummy_target : public target_ops
   void flash_erase (ULONGEST arg0, LONGEST arg1) override;
   void flash_done () override;
   const struct target_desc *read_description () override;
+  std::string read_description_hash () override;
   ptid_t get_ada_task_ptid (long arg0, ULONGEST arg1) override;
   int auxv_parse (const gdb_byte **arg0, const gdb_byte *arg1, CORE_ADDR *arg2, CORE_ADDR *arg3) override;
   int search_memory (CORE_ADDR arg0, ULONGEST arg1, const gdb_byte *arg2, ULONGEST arg3, CORE_ADDR *arg4) override;
+  int search_memory_multi (CORE_ADDR arg0, ULONGEST arg1, gdb::array_view<const search_pattern> arg2, ULONGEST arg3, CORE_ADDR *arg4, size_t *arg5) override;
   bool can_execute_reverse () override;
   enum exec_direction_kind execution_direction () override;
   bool supports_multi_process () override;
@@ -301,9 +303,11 @@ struct debug_target : public target_ops
   void flash_erase (ULONGEST arg0, LONGEST arg1) override;
   void flash_done () override;
   const struct target_desc *read_description () override;
+  std::string read_description_hash () override;
   ptid_t get_ada_task_ptid (long arg0, ULONGEST arg1) override;
   int auxv_parse (const gdb_byte **arg0, const gdb_byte *arg1, CORE_ADDR *arg2, CORE_ADDR *arg3) override;
   int search_memory (CORE_ADDR arg0, ULONGEST arg1, const gdb_byte *arg2, ULONGEST arg3, CORE_ADDR *arg4) override;
+  int search_memory_multi (CORE_ADDR arg0, ULONGEST arg1, gdb::array_view<const search_pattern> arg2, ULONGEST arg3, CORE_ADDR *arg4, size_t *arg5) override;
   bool can_execute_reverse () override;
   enum exec_direction_kind execution_direction () override;
   bool supports_multi_process () override;
@@ -2541,6 +2545,30 @@ debug_target::read_description ()
   return result;
 }
 
+std::string
+target_ops::read_description_hash ()
+{
+  return this->beneath ()->read_description_hash ();
+}
+
+std::string
+dummy_target::read_description_hash ()
+{
+  return std::string ();
+}
+
+std::string
+debug_target::read_description_hash ()
+{
+  target_debug_printf_nofunc ("-> %s->read_description_hash (...)", this->beneath ()->shortname ());
+  std::string result
+    = this->beneath ()->read_description_hash ();
+  target_debug_printf_nofunc ("<- %s->read_description_hash () = %s",
+	      this->beneath ()->shortname (),
+	      target_debug_print_std_string (result).c_str ());
+  return result;
+}
+
 ptid_t
 target_ops::get_ada_task_ptid (long arg0, ULONGEST arg1)
 {
@@ -2624,6 +2652,36 @@ debug_target::search_memory (CORE_ADDR arg0, ULONGEST arg1, const gdb_byte *arg2
   return result;
 }
 
+int
+target_ops::search_memory_multi (CORE_ADDR arg0, ULONGEST arg1, gdb::array_view<const search_pattern> arg2, ULONGEST arg3, CORE_ADDR *arg4, size_t *arg5)
+{
+  return this->beneath ()->search_memory_multi (arg0, arg1, arg2, arg3, arg4, arg5);
+}
+
+int
+dummy_target::search_memory_multi (CORE_ADDR arg0, ULONGEST arg1, gdb::array_view<const search_pattern> arg2, ULONGEST arg3, CORE_ADDR *arg4, size_t *arg5)
+{
+  return default_search_memory_multi (this, arg0, arg1, arg2, arg3, arg4, arg5);
+}
+
+int
+debug_target::search_memory_multi (CORE_ADDR arg0, ULONGEST arg1, gdb::array_view<const search_pattern> arg2, ULONGEST arg3, CORE_ADDR *arg4, size_t *arg5)
+{
+  target_debug_printf_nofunc ("-> %s->search_memory_multi (...)", this->beneath ()->shortname ());
+  int result
+    = this->beneath ()->search_memory_multi (arg0, arg1, arg2, arg3, arg4, arg5);
+  target_debug_printf_nofunc ("<- %s->search_memory_multi (%s, %s, %s, %s, %s, %s) = %s",
+	      this->beneath ()->shortname (),
+	      target_debug_print_CORE_ADDR (arg0).c_str (),
+	      target_debug_print_ULONGEST (arg1).c_str (),
+	      target_debug_print_search_patterns (arg2).c_str (),
+	      target_debug_print_ULONGEST (arg3).c_str (),
+	      target_debug_print_CORE_ADDR_p (arg4).c_str (),
+	      target_debug_print_size_t_p (arg5).c_str (),
+	      target_debug_print_int (result).c_str ());
+  return result;
+}
+
 bool
 target_ops::can_execute_reverse ()
 {
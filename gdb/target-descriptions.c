@@ -36,6 +36,7 @@
 #include "completer.h"
 #include "readline/tilde.h"
 #include "cli/cli-style.h"
+#include "gdbsupport/pathstuff.h"
 
 /* Types.  */
 
@@ -1249,6 +1250,36 @@ unset_tdesc_filename_cmd (const char *args, int from_tty)
   target_find_description ();
 }
 
+static void
+show_tdesc_cache_cmd (struct ui_file *file, int from_tty,
+		      struct cmd_list_element *c, const char *value)
+{
+  gdb_printf (file,
+	      _("Looking up target descriptions by their hash is %s.\n"),
+	      value);
+}
+
+static void
+set_tdesc_cache_directory_cmd (const char *args, int from_tty,
+			       struct cmd_list_element *c)
+{
+  /* Make sure the directory is absolute and tilde-expanded.  */
+  if (!tdesc_cache_directory.empty ())
+    tdesc_cache_directory = gdb_abspath (tdesc_cache_directory);
+}
+
+static void
+show_tdesc_cache_directory_cmd (struct ui_file *file, int from_tty,
+				struct cmd_list_element *c, const char *value)
+{
+  if (*value != '\0')
+    gdb_printf (file,
+		_("Target descriptions are saved in \"%ps\".\n"),
+		styled_string (file_name_style.style (), value));
+  else
+    gdb_printf (file, _("Target descriptions are not saved.\n"));
+}
+
 /* Print target description in C.  */
 
 class print_c_tdesc : public tdesc_element_visitor
@@ -1913,6 +1944,31 @@ Unset the file to read for an XML target description.\n\
 When unset, GDB will read the description from the target."),
 	   &tdesc_unset_cmdlist);
 
+  add_setshow_boolean_cmd ("cache", class_obscure, &tdesc_cache_enabled,
+			   _("\
+Set whether to look up target descriptions by their hash."), _("\
+Show whether to look up target descriptions by their hash."), _("\
+When on, and the target reports a hash for its description, GDB uses\n\
+a description with the same hash that it read before, in this session\n\
+or in an earlier one, instead of reading it from the target again."),
+			   nullptr, show_tdesc_cache_cmd,
+			   &tdesc_set_cmdlist, &tdesc_show_cmdlist);
+
+  std::string cache_dir = get_standard_cache_dir ();
+  if (!cache_dir.empty ())
+    tdesc_cache_directory = cache_dir + SLASH_STRING + "tdesc";
+
+  add_setshow_filename_cmd ("cache-directory", class_obscure,
+			    &tdesc_cache_directory, _("\
+Set the directory where target descriptions are saved."), _("\
+Show the directory where target descriptions are saved."), _("\
+Target descriptions that have a hash are saved in this directory, so\n\
+that later sessions can use them without reading them from the target.\n\
+When empty, they are only reused within a session."),
+			    set_tdesc_cache_directory_cmd,
+			    show_tdesc_cache_directory_cmd,
+			    &tdesc_set_cmdlist, &tdesc_show_cmdlist);
+
   auto grp = make_maint_print_c_tdesc_options_def_group (nullptr);
   static std::string help_text
     = gdb::option::build_help (_("\
@@ -0,0 +1,505 @@
+/* Local cache of files read from the target filesystem.
+
+   Copyright (C) 2025 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "target-file-cache.h"
+
+#include "cli/cli-cmds.h"
+#include "cli/cli-decode.h"
+#include "command.h"
+#include "event-top.h"
+#include "extract-store-integer.h"
+#include "target.h"
+#include "elf/common.h"
+#include "elf/external.h"
+#include "gdbsupport/byte-vector.h"
+#include "gdbsupport/filestuff.h"
+#include "gdbsupport/fileio.h"
+#include "gdbsupport/gdb_unlinker.h"
+#include "gdbsupport/pathstuff.h"
+#include "gdbsupport/rsp-low.h"
+#include "gdbsupport/scoped_fd.h"
+#include <sys/stat.h>
+
+/* When set to true, show debug messages about the target file cache.  */
+static bool debug_target_file_cache = false;
+
+#define target_file_cache_debug(FMT, ...)				     \
+  debug_prefixed_printf_cond_nofunc (debug_target_file_cache,		     \
+				     "target-file-cache", FMT, ## __VA_ARGS__)
+
+/* Whether the cache is used, for "set/show target-file-cache enabled".  */
+static bool target_file_cache_enabled = false;
+
+/* The cache directory, for "set/show target-file-cache directory".  */
+static std::string target_file_cache_directory;
+
+/* Statistics for "show target-file-cache stats".  */
+static unsigned int target_file_cache_hits;
+static unsigned int target_file_cache_misses;
+static ULONGEST target_file_cache_bytes_transferred;
+
+/* set/show target-file-cache commands.  */
+static cmd_list_element *set_target_file_cache_prefix_list;
+static cmd_list_element *show_target_file_cache_prefix_list;
+
+/* The largest number of bytes read from the target at a time when
+   transferring a file.  The remote target splits large reads into
+   several requests, and keeps several of them in flight.  */
+static constexpr ULONGEST transfer_chunk_size = 4 * 1024 * 1024;
+
+/* Read LEN bytes at OFFSET in the target file FD into BUF.  Return
+   false if that is not possible, including if the file is too
+   short.  */
+
+static bool
+read_target_file (int fd, gdb_byte *buf, ULONGEST len, ULONGEST offset)
+{
+  ULONGEST pos = 0;
+
+  while (pos < len)
+    {
+      fileio_error target_errno;
+      int n = target_fileio_pread (fd, buf + pos,
+				   std::min (len - pos, transfer_chunk_size),
+				   offset + pos, &target_errno);
+      if (n <= 0)
+	return false;
+      pos += n;
+    }
+
+  return true;
+}
+
+/* Return the GNU build-id of the target file FD, as a hex string, by
+   looking at its ELF notes.  Return an empty string if the file is not
+   ELF or has no build-id.  This reads the headers rather than using
+   BFD, because BFD would look at the section headers, which are at the
+   end of the file, while the notes are normally right after the
+   program headers, at the start.  */
+
+static std::string
+target_file_build_id (int fd)
+{
+  gdb_byte ehdr[sizeof (Elf64_External_Ehdr)];
+
+  if (!read_target_file (fd, ehdr, sizeof (Elf32_External_Ehdr), 0)
+      || ehdr[EI_MAG0] != ELFMAG0 || ehdr[EI_MAG1] != ELFMAG1
+      || ehdr[EI_MAG2] != ELFMAG2 || ehdr[EI_MAG3] != ELFMAG3)
+    return {};
+
+  bool is_64 = ehdr[EI_CLASS] == ELFCLASS64;
+  if (!is_64 && ehdr[EI_CLASS] != ELFCLASS32)
+    return {};
+
+  bfd_endian byte_order;
+  if (ehdr[EI_DATA] == ELFDATA2MSB)
+    byte_order = BFD_ENDIAN_BIG;
+  else if (ehdr[EI_DATA] == ELFDATA2LSB)
+    byte_order = BFD_ENDIAN_LITTLE;
+  else
+    return {};
+
+  auto get = [byte_order] (const unsigned char *field, int size)
+    {
+      return extract_unsigned_integer (field, size, byte_order);
+    };
+
+  ULONGEST phoff;
+  ULONGEST phentsize;
+  ULONGEST phnum;
+  if (is_64)
+    {
+      if (!read_target_file (fd, ehdr, sizeof (Elf64_External_Ehdr), 0))
+	return {};
+
+      auto *hdr = (Elf64_External_Ehdr *) ehdr;
+      phoff = get (hdr->e_phoff, 8);
+      phentsize = get (hdr->e_phentsize, 2);
+      phnum = get (hdr->e_phnum, 2);
+      if (phentsize < sizeof (Elf64_External_Phdr))
+	return {};
+    }
+  else
+    {
+      auto *hdr = (Elf32_External_Ehdr *) ehdr;
+      phoff = get (hdr->e_phoff, 4);
+      phentsize = get (hdr->e_phentsize, 2);
+      phnum = get (hdr->e_phnum, 2);
+      if (phentsize < sizeof (Elf32_External_Phdr))
+	return {};
+    }
+
+  /* PN_XNUM and other unusual counts are not worth handling here; such
+     files are found by name instead.  */
+  if (phnum == 0 || phnum >= PN_XNUM)
+    return {};
+
+  gdb::byte_vector phdrs (phnum * phentsize);
+  if (!read_target_file (fd, phdrs.data (), phdrs.size (), phoff))
+    return {};
+
+  for (ULONGEST i = 0; i < phnum; i++)
+    {
+      const gdb_byte *phdr = phdrs.data () + i * phentsize;
+      ULONGEST type, offset, size, align;
+
+      if (is_64)
+	{
+	  auto *p = (const Elf64_External_Phdr *) phdr;
+	  type = get (p->p_type, 4);
+	  offset = get (p->p_offset, 8);
+	  size = get (p->p_filesz, 8);
+	  align = get (p->p_align, 8);
+	}
+      else
+	{
+	  auto *p = (const Elf32_External_Phdr *) phdr;
+	  type = get (p->p_type, 4);
+	  offset = get (p->p_offset, 4);
+	  size = get (p->p_filesz, 4);
+	  align = get (p->p_align, 4);
+	}
+
+      /* Notes are small; anything big is not what we are after.  */
+      if (type != PT_NOTE || size > 0x10000)
+	continue;
+
+      gdb::byte_vector notes (size);
+      if (!read_target_file (fd, notes.data (), size, offset))
+	return {};
+
+      /* Note entries are padded to 8 bytes in segments aligned to 8,
+	 and to 4 bytes otherwise.  */
+      ULONGEST pad = align == 8 ? 8 : 4;
+      ULONGEST pos = 0;
+      while (pos + 12 <= size)
+	{
+	  auto *note = (const Elf_External_Note *) &notes[pos];
+	  ULONGEST namesz = get (note->namesz, 4);
+	  ULONGEST descsz = get (note->descsz, 4);
+	  ULONGEST note_type = get (note->type, 4);
+	  ULONGEST name_pos = pos + 12;
+	  ULONGEST desc_pos = name_pos + align_up (namesz, pad);
+
+	  if (namesz > size || descsz > size || desc_pos + descsz > size)
+	    break;
+
+	  if (note_type == NT_GNU_BUILD_ID
+	      && namesz == 4
+	      && memcmp (&notes[name_pos], "GNU", 4) == 0
+	      && descsz > 0)
+	    return bin2hex (&notes[desc_pos], descsz);
+
+	  pos = desc_pos + align_up (descsz, pad);
+	}
+    }
+
+  return {};
+}
+
+/* Return the name under which a file without build-id is kept in the
+   cache: its base name, a checksum of its full name, and its size and
+   modification time.  */
+
+static std::string
+make_stat_key (const char *filename, const struct stat &st)
+{
+  unsigned long crc
+    = bfd_calc_gnu_debuglink_crc32 (0, (const bfd_byte *) filename,
+				    strlen (filename));
+
+  return string_printf ("%s-%08lx-%s-%s", lbasename (filename), crc,
+			pulongest (st.st_size), plongest (st.st_mtime));
+}
+
+/* Return true if FILENAME is a regular host file of SIZE bytes.  */
+
+static bool
+cached_file_ok (const std::string &filename, ULONGEST size)
+{
+  struct stat st;
+
+  return (stat (filename.c_str (), &st) == 0
+	  && S_ISREG (st.st_mode)
+	  && (ULONGEST) st.st_size == size);
+}
+
+/* Create the subdirectory SUBDIR of the cache directory, and return
+   the name of FILE in it.  Throw an error on failure.  */
+
+static std::string
+cache_file_name (const char *subdir, const std::string &file)
+{
+  std::string dir = target_file_cache_directory + SLASH_STRING + subdir;
+
+  if (!mkdir_recursive (dir.c_str ()))
+    perror_with_name (string_printf (_("Couldn't create `%s'"),
+				     dir.c_str ()).c_str ());
+
+  return dir + SLASH_STRING + file;
+}
+
+/* A file being written into the cache.  It is written to a temporary
+   name first, and renamed by "finalize", so that other GDB sessions
+   sharing the cache never see a partial file.  If "finalize" isn't
+   called, the temporary file is deleted.  */
+
+struct cache_wip_file
+{
+  explicit cache_wip_file (const std::string &filename)
+    : m_filename (filename),
+      m_filename_temp (make_temp_filename (filename))
+  {
+    m_fd = gdb_mkostemp_cloexec (m_filename_temp.data (), O_BINARY);
+    if (m_fd.get () == -1)
+      perror_with_name (string_printf (_("Couldn't open `%s'"),
+				       m_filename_temp.data ()).c_str ());
+    m_unlink_file.emplace (m_filename_temp.data ());
+  }
+
+  /* Append LEN bytes of BUF to the file.  */
+
+  void write (const gdb_byte *buf, size_t len)
+  {
+    while (len > 0)
+      {
+	ssize_t n = ::write (m_fd.get (), buf, len);
+	if (n < 0)
+	  perror_with_name (m_filename_temp.data ());
+	buf += n;
+	len -= n;
+      }
+  }
+
+  void finalize ()
+  {
+    if (close (m_fd.release ()) != 0)
+      perror_with_name (m_filename_temp.data ());
+    m_unlink_file->keep ();
+    m_unlink_file.reset ();
+    if (rename (m_filename_temp.data (), m_filename.c_str ()) != 0)
+      perror_with_name (("rename"));
+  }
+
+private:
+
+  std::string m_filename;
+  gdb::char_vector m_filename_temp;
+
+  /* As in index-write.c, the file must be closed before it is
+     unlinked, for MS-Windows.  */
+  std::optional<gdb::unlinker> m_unlink_file;
+  scoped_fd m_fd;
+};
+
+/* Transfer SIZE bytes of the target file FD to the cache file
+   FILENAME.  Throw an error on failure.  */
+
+static void
+transfer_target_file (int fd, ULONGEST size, const std::string &filename)
+{
+  cache_wip_file file (filename);
+  gdb::byte_vector buf (std::min (size, transfer_chunk_size));
+
+  for (ULONGEST offset = 0; offset < size; )
+    {
+      QUIT;
+
+      ULONGEST len = std::min (size - offset, transfer_chunk_size);
+      if (!read_target_file (fd, buf.data (), len, offset))
+	error (_("Couldn't read %s bytes at offset %s"),
+	       pulongest (len), pulongest (offset));
+
+      file.write (buf.data (), len);
+      offset += len;
+      target_file_cache_bytes_transferred += len;
+    }
+
+  file.finalize ();
+}
+
+/* Implementation of target_file_cache_lookup, which may throw.  */
+
+static std::string
+lookup_or_transfer (int fd, const char *filename)
+{
+  fileio_error target_errno;
+  struct stat st;
+
+  if (target_fileio_fstat (fd, &st, &target_errno) != 0
+      || !S_ISREG (st.st_mode))
+    return {};
+
+  /* Files with a build-id are found by it.  It is read from the
+     target every time, so a rebuilt file is never mistaken for the
+     cached one.  Other files are found by name, size and modification
+     time.  */
+  std::string build_id = target_file_build_id (fd);
+  std::string cached
+    = (build_id.empty ()
+       ? cache_file_name ("files", make_stat_key (filename, st))
+       : cache_file_name ("build-id", build_id));
+
+  if (cached_file_ok (cached, st.st_size))
+    {
+      target_file_cache_debug ("%s: found %s", filename, cached.c_str ());
+      target_file_cache_hits++;
+    }
+  else
+    {
+      target_file_cache_debug ("%s: transferring to %s", filename,
+			       cached.c_str ());
+      target_file_cache_misses++;
+      transfer_target_file (fd, st.st_size, cached);
+    }
+
+  return cached;
+}
+
+/* See target-file-cache.h.  */
+
+std::string
+target_file_cache_lookup (int fd, const char *filename)
+{
+  if (!target_file_cache_enabled || target_file_cache_directory.empty ())
+    return {};
+
+  try
+    {
+      return lookup_or_transfer (fd, filename);
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      target_file_cache_debug ("%s: couldn't use the cache: %s",
+			       filename, ex.what ());
+    }
+
+  return {};
+}
+
+/* True when we are executing "show target-file-cache".  This is used to
+   improve the printout a little bit.  */
+static bool in_show_target_file_cache_command = false;
+
+/* "show target-file-cache" handler.  */
+
+static void
+show_target_file_cache_command (const char *arg, int from_tty)
+{
+  auto restore_flag
+    = make_scoped_restore (&in_show_target_file_cache_command, true);
+
+  cmd_show_list (show_target_file_cache_prefix_list, from_tty);
+}
+
+/* "set/show target-file-cache enabled" show callback.  */
+
+static void
+show_target_file_cache_enabled (ui_file *stream, int from_tty,
+				cmd_list_element *cmd, const char *value)
+{
+  gdb_printf (stream, _("The target file cache is %s.\n"), value);
+}
+
+/* "set target-file-cache directory" handler.  */
+
+static void
+set_target_file_cache_directory (const char *arg, int from_tty,
+				 cmd_list_element *element)
+{
+  /* Make sure the directory is absolute and tilde-expanded.  */
+  if (!target_file_cache_directory.empty ())
+    target_file_cache_directory = gdb_abspath (target_file_cache_directory);
+}
+
+/* "show target-file-cache stats" handler.  */
+
+static void
+show_target_file_cache_stats (const char *arg, int from_tty)
+{
+  const char *indent = "";
+
+  if (in_show_target_file_cache_command)
+    {
+      indent = "  ";
+      gdb_printf ("\n");
+    }
+
+  gdb_printf (_("%s     Cache hits (this session): %u\n"),
+	      indent, target_file_cache_hits);
+  gdb_printf (_("%s   Cache misses (this session): %u\n"),
+	      indent, target_file_cache_misses);
+  gdb_printf (_("%sBytes transferred (this session): %s\n"),
+	      indent, pulongest (target_file_cache_bytes_transferred));
+}
+
+void _initialize_target_file_cache ();
+void
+_initialize_target_file_cache ()
+{
+  std::string cache_dir = get_standard_cache_dir ();
+  if (!cache_dir.empty ())
+    target_file_cache_directory = cache_dir + SLASH_STRING + "target-files";
+
+  add_basic_prefix_cmd ("target-file-cache", class_files,
+			_("Set target file cache options."),
+			&set_target_file_cache_prefix_list,
+			false, &setlist);
+
+  add_prefix_cmd ("target-file-cache", class_files,
+		  show_target_file_cache_command,
+		  _("Show target file cache options."),
+		  &show_target_file_cache_prefix_list,
+		  false, &showlist);
+
+  add_setshow_boolean_cmd ("enabled", class_files,
+			   &target_file_cache_enabled,
+			   _("Enable the target file cache."),
+			   _("Show whether the target file cache is enabled."),
+			   _("\
+When on, files that GDB reads from the target filesystem, for instance\n\
+because the sysroot is \"target:\", are copied to a host directory the\n\
+first time, and read from there afterwards, as long as they are unchanged\n\
+on the target.  The default is off."),
+			   nullptr, show_target_file_cache_enabled,
+			   &set_target_file_cache_prefix_list,
+			   &show_target_file_cache_prefix_list);
+
+  add_setshow_filename_cmd ("directory", class_files,
+			    &target_file_cache_directory,
+			    _("Set the directory of the target file cache."),
+			    _("Show the directory of the target file cache."),
+			    nullptr,
+			    set_target_file_cache_directory, nullptr,
+			    &set_target_file_cache_prefix_list,
+			    &show_target_file_cache_prefix_list);
+
+  add_cmd ("stats", class_files, show_target_file_cache_stats,
+	   _("Show some stats about the target file cache."),
+	   &show_target_file_cache_prefix_list);
+
+  add_setshow_boolean_cmd ("target-file-cache", class_maintenance,
+			   &debug_target_file_cache,
+			   _("Set display of target file cache debug messages."),
+			   _("Show display of target file cache debug messages."),
+			   _("\
+When on, debugging output for the target file cache is displayed."),
+			   nullptr, nullptr,
+			   &setdebuglist, &showdebuglist);
+}
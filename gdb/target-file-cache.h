@@ -0,0 +1,38 @@
+/* Local cache of files read from the target filesystem.
+
+   Copyright (C) 2025 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef GDB_TARGET_FILE_CACHE_H
+#define GDB_TARGET_FILE_CACHE_H
+
+/* Files that GDB reads through the target, for instance when the
+   sysroot is "target:", can be kept in a directory on the host, so
+   that they need not be transferred again on the next connection.
+   Files are found in the cache by their GNU build-id, or, for files
+   that have none, by their name, size and modification time.  */
+
+/* Return the name of a host file holding the contents of the target
+   file FILENAME, which is open as target file descriptor FD,
+   transferring the file into the cache if it isn't there yet.  Return
+   an empty string if the cache is disabled or could not be used, in
+   which case the caller should read the file through the target.
+   This does not throw.  */
+
+extern std::string target_file_cache_lookup (int fd, const char *filename);
+
+#endif /* GDB_TARGET_FILE_CACHE_H */
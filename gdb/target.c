@@ -1486,6 +1486,10 @@ raw_memory_xfer_partial (struct target_ops *ops, gdb_byte *readbuf,
     }
   while (ops != NULL);
 
+  /* Let host-side copies of target memory know they may be stale.  */
+  if (writebuf != NULL && res == TARGET_XFER_OK)
+    target_dcache_note_memory_write (memaddr, *xfered_len);
+
   /* The cache works at the raw memory level.  Make sure the cache
      gets updated with raw contents no matter what kind of memory
      object was originally being written.  Note we do write-through
@@ -1506,6 +1510,12 @@ raw_memory_xfer_partial (struct target_ops *ops, gdb_byte *readbuf,
   return res;
 }
 
+/* The innermost live scoped_memory_read_recorder and
+   scoped_memory_prefetch, if any.  */
+
+static scoped_memory_read_recorder *current_read_recorder;
+static scoped_memory_prefetch *current_prefetch;
+
 /* Perform a partial memory transfer.
    For docs see target.h, to_xfer_partial.  */
 
@@ -1569,6 +1579,17 @@ memory_xfer_partial_1 (struct target_ops *ops, enum target_object object,
   else
     inf = NULL;
 
+  /* Try memory that was read ahead of time.  */
+  if (inf != NULL
+      && readbuf != NULL
+      && current_prefetch != nullptr
+      && get_traceframe_number () == -1
+      && current_prefetch->read (memaddr, readbuf, reg_len))
+    {
+      *xfered_len = reg_len;
+      return TARGET_XFER_OK;
+    }
+
   if (inf != NULL
       && readbuf != NULL
       /* The dcache reads whole cache lines; that doesn't play well
@@ -1706,6 +1727,15 @@ target_xfer_partial (struct target_ops *ops,
     retval = ops->xfer_partial (object, annex, readbuf,
 				writebuf, offset, len, xfered_len);
 
+  if (current_read_recorder != nullptr
+      && readbuf != nullptr
+      && retval == TARGET_XFER_OK
+      && (object == TARGET_OBJECT_MEMORY
+	  || object == TARGET_OBJECT_STACK_MEMORY
+	  || object == TARGET_OBJECT_CODE_MEMORY
+	  || object == TARGET_OBJECT_RAW_MEMORY))
+    current_read_recorder->record (offset, *xfered_len);
+
   if (targetdebug)
     {
       const unsigned char *myaddr = NULL;
@@ -1874,6 +1904,143 @@ target_write_raw_memory (CORE_ADDR memaddr, const gdb_byte *myaddr, ssize_t len)
     return -1;
 }
 
+/* See target.h.  */
+
+scoped_memory_read_recorder::scoped_memory_read_recorder ()
+  : m_prev (current_read_recorder)
+{
+  current_read_recorder = this;
+}
+
+scoped_memory_read_recorder::~scoped_memory_read_recorder ()
+{
+  current_read_recorder = m_prev;
+  if (m_prev != nullptr)
+    m_prev->m_ranges.insert (m_prev->m_ranges.end (),
+			     m_ranges.begin (), m_ranges.end ());
+}
+
+/* See target.h.  */
+
+void
+scoped_memory_read_recorder::record (CORE_ADDR addr, ULONGEST len)
+{
+  /* mem_range lengths are ints.  */
+  while (len > 0)
+    {
+      int chunk = std::min (len, (ULONGEST) INT_MAX / 2);
+
+      /* Values are usually read in several consecutive pieces; merge
+	 them right away so that the list stays short.  */
+      if (!m_ranges.empty ()
+	  && m_ranges.back ().start + m_ranges.back ().length == addr
+	  && m_ranges.back ().length <= INT_MAX / 2)
+	m_ranges.back ().length += chunk;
+      else
+	m_ranges.emplace_back (addr, chunk);
+
+      addr += chunk;
+      len -= chunk;
+    }
+}
+
+/* See target.h.  */
+
+std::vector<mem_range>
+scoped_memory_read_recorder::ranges ()
+{
+  normalize_mem_ranges (&m_ranges);
+  return m_ranges;
+}
+
+/* scoped_memory_prefetch reads ranges that are at most this many bytes
+   apart with a single request...  */
+
+static constexpr CORE_ADDR prefetch_max_gap = 256;
+
+/* ... as long as the resulting block is no bigger than this.  */
+
+static constexpr CORE_ADDR prefetch_max_block = 64 * 1024;
+
+/* See target.h.  */
+
+scoped_memory_prefetch::scoped_memory_prefetch (std::vector<mem_range> ranges)
+  : m_inf (current_inferior ()),
+    m_generation (target_dcache_generation ()),
+    m_prev (current_prefetch)
+{
+  normalize_mem_ranges (&ranges);
+
+  for (size_t i = 0; i < ranges.size (); )
+    {
+      CORE_ADDR start = ranges[i].start;
+      CORE_ADDR end = start + ranges[i].length;
+      size_t j = i + 1;
+
+      while (j < ranges.size ()
+	     && ranges[j].start - end <= prefetch_max_gap
+	     && ranges[j].start + ranges[j].length - start <= prefetch_max_block)
+	{
+	  end = ranges[j].start + ranges[j].length;
+	  ++j;
+	}
+
+      block whole { start, gdb::byte_vector (end - start) };
+      if (target_read_raw_memory (start, whole.contents.data (),
+				  end - start) == 0)
+	m_blocks.push_back (std::move (whole));
+      else
+	{
+	  /* Some of the memory between the ranges may not be readable;
+	     try the ranges one at a time.  */
+	  for (size_t k = i; k < j; ++k)
+	    {
+	      block one { ranges[k].start,
+			  gdb::byte_vector (ranges[k].length) };
+	      if (target_read_raw_memory (one.start, one.contents.data (),
+					  ranges[k].length) == 0)
+		m_blocks.push_back (std::move (one));
+	    }
+	}
+
+      i = j;
+    }
+
+  current_prefetch = this;
+}
+
+scoped_memory_prefetch::~scoped_memory_prefetch ()
+{
+  current_prefetch = m_prev;
+}
+
+/* See target.h.  */
+
+bool
+scoped_memory_prefetch::read (CORE_ADDR addr, gdb_byte *buf,
+			      ULONGEST len) const
+{
+  if (current_inferior () != m_inf
+      || target_dcache_generation () != m_generation)
+    return false;
+
+  auto it = std::upper_bound (m_blocks.begin (), m_blocks.end (), addr,
+			      [] (CORE_ADDR a, const block &b)
+			      {
+				return a < b.start;
+			      });
+  if (it == m_blocks.begin ())
+    return false;
+  --it;
+
+  if (addr - it->start > it->contents.size ()
+      || len > it->contents.size () - (addr - it->start))
+    return false;
+
+  memcpy (buf, it->contents.data () + (addr - it->start), len);
+  return true;
+}
+
 /* Fetch the target's memory map.  */
 
 std::vector<mem_region>
@@ -2784,6 +2951,28 @@ default_search_memory (struct target_ops *self,
 			       pattern, pattern_len, found_addrp);
 }
 
+/* Default implementation of searching memory for several patterns.  */
+
+static int
+default_search_memory_multi (struct target_ops *self,
+			     CORE_ADDR start_addr, ULONGEST search_space_len,
+			     gdb::array_view<const search_pattern> patterns,
+			     ULONGEST align, CORE_ADDR *found_addrp,
+			     size_t *found_indexp)
+{
+  auto read_memory = [=] (CORE_ADDR addr, gdb_byte *result, size_t len)
+    {
+      return target_read (current_inferior ()->top_target (),
+			  TARGET_OBJECT_MEMORY, NULL,
+			  result, addr, len) == len;
+    };
+
+  /* Start over from the top of the target stack.  */
+  return simple_search_memory_multi (read_memory, start_addr,
+				     search_space_len, patterns, align,
+				     found_addrp, found_indexp);
+}
+
 /* Search SEARCH_SPACE_LEN bytes beginning at START_ADDR for the
    sequence of bytes in PATTERN with length PATTERN_LEN.
 
@@ -2802,6 +2991,21 @@ target_search_memory (CORE_ADDR start_addr, ULONGEST search_space_len,
 				pattern_len, found_addrp);
 }
 
+/* See target.h.  */
+
+int
+target_search_memory_multi (CORE_ADDR start_addr, ULONGEST search_space_len,
+			    gdb::array_view<const search_pattern> patterns,
+			    ULONGEST align, CORE_ADDR *found_addrp,
+			    size_t *found_indexp)
+{
+  target_ops *target = current_inferior ()->top_target ();
+
+  return target->search_memory_multi (start_addr, search_space_len,
+				      patterns, align, found_addrp,
+				      found_indexp);
+}
+
 /* Look through the currently pushed targets.  If none of them will
    be able to restart the currently running process, issue an error
    message.  */
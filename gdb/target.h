@@ -77,6 +77,7 @@ typedef const gdb_byte const_gdb_byte;
 #include "bfd.h"
 #include "symtab.h"
 #include "memattr.h"
+#include "memrange.h"
 #include "gdbsupport/gdb_signals.h"
 #include "btrace.h"
 #include "record.h"
@@ -84,6 +85,8 @@ typedef const gdb_byte const_gdb_byte;
 #include "disasm-flags.h"
 #include "tracepoint.h"
 #include "gdbsupport/fileio.h"
+#include "gdbsupport/search.h"
+#include "gdbsupport/byte-vector.h"
 #include "gdbsupport/x86-xstate.h"
 
 #include "gdbsupport/break-common.h"
@@ -894,6 +897,15 @@ struct target_ops
     virtual const struct target_desc *read_description ()
 	 TARGET_DEFAULT_RETURN (NULL);
 
+    /* Return a string that identifies the contents of the XML target
+       description that would be read from this target, that is, of the
+       "target.xml" TARGET_OBJECT_AVAILABLE_FEATURES object and of the
+       documents it includes, for instance a hash of them.  Different
+       descriptions must have different identifiers.  Return an empty
+       string if the target can't tell.  */
+    virtual std::string read_description_hash ()
+	 TARGET_DEFAULT_RETURN (std::string ());
+
     /* Build the PTID of the thread on which a given task is running,
        based on LWP and THREAD.  These values are extracted from the
        task Private_Data section of the Ada Task Control Block, and
@@ -920,6 +932,24 @@ struct target_ops
 			       CORE_ADDR *found_addrp)
       TARGET_DEFAULT_FUNC (default_search_memory);
 
+    /* Search SEARCH_SPACE_LEN bytes beginning at START_ADDR for the
+       lowest address that is a multiple of ALIGN at which one of the
+       given patterns starts.
+
+       The result is 1 if found, 0 if not found, and -1 if there was an
+       error requiring halting of the search (e.g. memory read error).
+       If found, the address is recorded in FOUND_ADDRP, and the index
+       of the pattern in FOUND_INDEXP.  If several patterns start at
+       that address, the first one is reported.  */
+    virtual int search_memory_multi (CORE_ADDR start_addr,
+				     ULONGEST search_space_len,
+				     gdb::array_view<const search_pattern>
+				       TARGET_DEBUG_PRINTER (target_debug_print_search_patterns),
+				     ULONGEST align,
+				     CORE_ADDR *found_addrp,
+				     size_t *found_indexp)
+      TARGET_DEFAULT_FUNC (default_search_memory_multi);
+
     /* Can target execute in reverse?  */
     virtual bool can_execute_reverse ()
       TARGET_DEFAULT_RETURN (false);
@@ -1652,6 +1682,73 @@ extern int target_read_code (CORE_ADDR memaddr, gdb_byte *myaddr, ssize_t len);
 extern int target_write_raw_memory (CORE_ADDR memaddr, const gdb_byte *myaddr,
 				    ssize_t len);
 
+/* While an object of this type is alive, the ranges of target memory
+   that GDB reads successfully are recorded in it.  Recorders can be
+   nested; the ranges recorded by an inner one are also recorded by the
+   outer one.  */
+
+class scoped_memory_read_recorder
+{
+public:
+  scoped_memory_read_recorder ();
+  ~scoped_memory_read_recorder ();
+
+  DISABLE_COPY_AND_ASSIGN (scoped_memory_read_recorder);
+
+  /* Note that LEN bytes at ADDR were read.  */
+  void record (CORE_ADDR addr, ULONGEST len);
+
+  /* Return the ranges read so far, sorted and merged.  */
+  std::vector<mem_range> ranges ();
+
+private:
+  std::vector<mem_range> m_ranges;
+  scoped_memory_read_recorder *m_prev;
+};
+
+/* While an object of this type is alive, reads of target memory of the
+   current inferior that fall entirely within one of the blocks read by
+   the constructor are served from the copy it made, instead of going
+   to the target.  The copy is dropped as soon as target memory may
+   have changed, for instance when GDB writes to memory or the inferior
+   resumes.  This lets code that is going to do many small reads, whose
+   addresses are known in advance, do few large ones instead.  */
+
+class scoped_memory_prefetch
+{
+public:
+  /* Read RANGES of the memory of the current inferior, merging ranges
+     that are close to each other into a single read.  Ranges that
+     can't be read are skipped.  */
+  explicit scoped_memory_prefetch (std::vector<mem_range> ranges);
+  ~scoped_memory_prefetch ();
+
+  DISABLE_COPY_AND_ASSIGN (scoped_memory_prefetch);
+
+  /* If the LEN bytes at ADDR are in the copy, and it is still current,
+     copy them to BUF and return true.  Otherwise return false.  */
+  bool read (CORE_ADDR addr, gdb_byte *buf, ULONGEST len) const;
+
+private:
+  /* A block of memory that was read.  */
+  struct block
+  {
+    CORE_ADDR start;
+    gdb::byte_vector contents;
+  };
+
+  /* Blocks, sorted by address, not overlapping.  */
+  std::vector<block> m_blocks;
+
+  /* The inferior whose memory was read.  */
+  inferior *m_inf;
+
+  /* The value of target_dcache_generation when the memory was read.  */
+  ULONGEST m_generation;
+
+  scoped_memory_prefetch *m_prev;
+};
+
 /* Fetches the target's memory map.  If one is found it is sorted
    and returned, after some consistency checking.  Otherwise, NULL
    is returned.  */
@@ -2215,6 +2312,14 @@ extern int target_search_memory (CORE_ADDR start_addr,
 				 ULONGEST pattern_len,
 				 CORE_ADDR *found_addrp);
 
+/* Search memory for the first of several patterns.  See
+   target_ops::search_memory_multi.  */
+
+extern int target_search_memory_multi
+  (CORE_ADDR start_addr, ULONGEST search_space_len,
+   gdb::array_view<const search_pattern> patterns, ULONGEST align,
+   CORE_ADDR *found_addrp, size_t *found_indexp);
+
 /* Target file operations.  */
 
 /* Return true if the filesystem seen by the current inferior
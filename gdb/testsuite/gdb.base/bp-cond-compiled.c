@@ -0,0 +1,53 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2025 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+struct item
+{
+  int id;
+  short flags;
+  struct item *next;
+};
+
+#define NITEMS 100
+
+struct item items[NITEMS];
+
+volatile int sink;
+
+static void
+process (struct item *x)
+{
+  sink += x->id;	/* break here */
+}
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < NITEMS; i++)
+    {
+      items[i].id = i * 3;
+      items[i].flags = -i;
+      items[i].next = i + 1 < NITEMS ? &items[i + 1] : 0;
+    }
+
+  for (i = 0; i < NITEMS; i++)
+    process (&items[i]);
+
+  return 0;
+}
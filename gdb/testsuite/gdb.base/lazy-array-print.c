@@ -0,0 +1,68 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2025 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* An array type much larger than the memory that backs it.  */
+typedef int big_array_t[16 * 1024 * 1024];
+
+/* Points to one readable page, followed by inaccessible memory.  */
+big_array_t *big;
+
+/* The same for characters, which are printed as strings.  */
+typedef char big_text_t[16 * 1024 * 1024];
+big_text_t *text;
+
+/* The last two characters of TEXT's page.  The page after it is
+   unmapped, which, unlike a PROT_NONE page, GDB can't read either.  */
+char *text_tail;
+
+int
+main (void)
+{
+  long page_size = sysconf (_SC_PAGESIZE);
+  int *p;
+  char *t;
+  int i;
+
+  p = mmap (NULL, 2 * page_size, PROT_READ | PROT_WRITE,
+	    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (p == MAP_FAILED)
+    return 1;
+  if (mprotect ((char *) p + page_size, page_size, PROT_NONE) != 0)
+    return 1;
+
+  for (i = 0; i < page_size / sizeof (int); i++)
+    p[i] = i;
+  big = (big_array_t *) p;
+
+  t = mmap (NULL, 2 * page_size, PROT_READ | PROT_WRITE,
+	    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (t == MAP_FAILED)
+    return 1;
+  if (munmap (t + page_size, page_size) != 0)
+    return 1;
+
+  /* A run of 100 'x', then the alphabet over and over.  */
+  for (i = 0; i < page_size; i++)
+    t[i] = i < 100 ? 'x' : 'a' + (i - 100) % 26;
+  text = (big_text_t *) t;
+  text_tail = t + page_size - 2;
+
+  return 0;	/* break here */
+}
@@ -0,0 +1,56 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2025 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <wchar.h>
+
+/* Arrays of integers, with runs of repeated elements.  */
+
+int ints[] = { 0, 1, 2, 3,
+	       7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+	       -1, -1,
+	       5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5 };
+
+short shorts[] = { -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, -2, 300 };
+
+unsigned long long ulls[] = { 1, 0xffffffffffffffffULL,
+			      0xffffffffffffffffULL, 0 };
+
+typedef unsigned int count_t;
+count_t counts[] = { 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9, 9 };
+
+int matrix[3][12] = {
+  { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
+  { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
+  { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2 },
+};
+
+/* Strings, with runs of repeated characters.  */
+
+char text[] = "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxabc";
+unsigned char bytes[] = { 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+			  0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 'a', 0 };
+wchar_t wtext[] = L"yyyyyyyyyyyyyyyyyyyyyyyyyyyyyyyz";
+
+/* In UTF-7, the bytes of the first character are repeated, but they
+   convert to other characters, as they are read in base64 mode.  */
+char text7[] = "+AGE+AGE+AGE+AGE-";
+
+int
+main (void)
+{
+  return 0;
+}
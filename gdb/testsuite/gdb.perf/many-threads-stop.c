@@ -0,0 +1,74 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2025 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#ifndef NUM_THREADS
+#define NUM_THREADS 1000
+#endif
+
+static pthread_barrier_t barrier;
+volatile int done;
+
+static void *
+thread_function (void *arg)
+{
+  pthread_barrier_wait (&barrier);
+
+  /* Half of the threads sleep in the kernel, the other half spin, so
+     that stopping them exercises both interrupted system calls and
+     running threads.  */
+  if (((long) arg) % 2 == 0)
+    while (!done)
+      usleep (1000);
+  else
+    while (!done)
+      ;
+
+  return NULL;
+}
+
+void
+stop_here (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_t threads[NUM_THREADS];
+  long i;
+
+  pthread_barrier_init (&barrier, NULL, NUM_THREADS + 1);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    if (pthread_create (&threads[i], NULL, thread_function, (void *) i) != 0)
+      abort ();
+
+  pthread_barrier_wait (&barrier);
+
+  /* Each call stops, and then resumes, all the threads.  */
+  while (!done)
+    stop_here ();
+
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_join (threads[i], NULL);
+
+  return 0;
+}
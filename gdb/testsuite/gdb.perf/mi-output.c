@@ -0,0 +1,46 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright (C) 2025 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <string.h>
+
+unsigned char buffer[MI_OUTPUT_BUFFER_SIZE];
+
+static void
+stop_here (void)
+{
+}
+
+static void
+recurse (int depth, const char *name, long count, double ratio)
+{
+  int local_int = depth * 3;
+  char local_string[32] = "some \"quoted\" text\n";
+  unsigned long local_array[8] = { 1, 22, 333, 4444, 55555, 666666 };
+
+  if (depth < MI_OUTPUT_DEPTH)
+    recurse (depth + 1, name, count + local_int, ratio / 2);
+  else
+    stop_here ();
+}
+
+int
+main (void)
+{
+  memset (buffer, 0xa5, sizeof (buffer));
+  recurse (0, "recurse", 0, 1.0);
+  return 0;
+}
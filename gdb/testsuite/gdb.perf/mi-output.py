@@ -0,0 +1,39 @@
+# Copyright (C) 2025 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+from perftest import perftest
+
+
+class MiOutput(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, buffer_size):
+        super(MiOutput, self).__init__("mi-output")
+        self.commands = {
+            "read-memory": "-data-read-memory-bytes buffer %d" % buffer_size,
+            "list-frames": "-stack-list-frames",
+            "list-arguments": "-stack-list-arguments --all-values",
+        }
+
+    def _run(self, command, count):
+        for _ in range(0, count):
+            gdb.execute('interpreter-exec mi "%s"' % command, False, True)
+
+    def warm_up(self):
+        for command in self.commands.values():
+            self._run(command, 1)
+
+    def execute_test(self):
+        for name, command in self.commands.items():
+            func = lambda: self._run(command, 10)
+            self.measure.measure(func, name)
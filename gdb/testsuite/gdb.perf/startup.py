@@ -0,0 +1,56 @@
+# Copyright (C) 2025 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import subprocess
+
+from perftest import perftest
+
+
+class Startup(perftest.TestCaseWithBasicMeasurements):
+    def __init__(self, gdb_program, count):
+        super(Startup, self).__init__("startup")
+        self.count = count
+        self.gdb_command = [
+            gdb_program,
+            "-nx",
+            "-batch",
+            "-data-directory",
+            gdb.parameter("data-directory"),
+        ]
+        self.all_architectures = []
+        for name in gdb.architecture_names():
+            self.all_architectures += ["-ex", "set architecture %s" % name]
+
+    def _run(self, extra_args):
+        for _ in range(0, self.count):
+            subprocess.run(
+                self.gdb_command + extra_args,
+                stdin=subprocess.DEVNULL,
+                stdout=subprocess.DEVNULL,
+                stderr=subprocess.DEVNULL,
+                check=True,
+            )
+
+    def warm_up(self):
+        self._run([])
+
+    def execute_test(self):
+        tests = {
+            "quit": [],
+            "all-architectures": self.all_architectures,
+        }
+        for name, extra_args in tests.items():
+            func = lambda: self._run(extra_args)
+            self.measure.measure(func, name)
@@ -0,0 +1,30 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2025 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Only the odd values of this type are pretty-printed.  */
+typedef int odd_t;
+odd_t odds[] = { 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 3 };
+
+/* All the values of this type are pretty-printed.  */
+typedef int tagged_t;
+tagged_t tags[] = { 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 5 };
+
+int
+main (void)
+{
+  return 0;
+}
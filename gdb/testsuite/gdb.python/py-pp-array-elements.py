@@ -0,0 +1,43 @@
+# Copyright (C) 2025 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+import gdb
+
+
+class OddPrinter:
+    def __init__(self, val):
+        self.val = val
+
+    def to_string(self):
+        return "odd %d" % int(self.val)
+
+
+class TagPrinter:
+    def __init__(self, val):
+        self.val = val
+
+    def to_string(self):
+        return "tag(%d)" % int(self.val)
+
+
+def lookup(val):
+    if val.type.name == "odd_t" and int(val) % 2 == 1:
+        return OddPrinter(val)
+    if val.type.name == "tagged_t":
+        return TagPrinter(val)
+    return None
+
+
+gdb.pretty_printers.append(lookup)
@@ -0,0 +1,59 @@
+# Copyright (C) 2025 Free Software Foundation, Inc.
+
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# This file is part of the GDB testsuite.  It tests the pretty-printer
+# lookup cache.
+
+import gdb
+import gdb.printing
+
+
+class FooPrinter(gdb.ValuePrinter):
+    def __init__(self, val):
+        self.__val = val
+
+    def to_string(self):
+        return "foo=" + str(self.__val["a"])
+
+
+class BarPrinter(gdb.ValuePrinter):
+    def __init__(self, val):
+        self.__val = val
+
+    def to_string(self):
+        return "bar=" + str(self.__val["b"])
+
+
+# A lookup function that accepts nothing, and counts how often it is
+# called.
+class CountingLookup(object):
+    def __init__(self, name, type_keyed):
+        self.name = name
+        self.enabled = True
+        self.type_keyed = type_keyed
+        self.calls = 0
+
+    def __call__(self, val):
+        self.calls += 1
+        return None
+
+
+keyed_lookup = CountingLookup("keyed", True)
+unkeyed_lookup = CountingLookup("unkeyed", False)
+
+pp = gdb.printing.RegexpCollectionPrettyPrinter("pp-cache-test")
+pp.add_printer("foo", "^foo$", FooPrinter)
+gdb.printing.register_pretty_printer(gdb.current_progspace(), pp)
+gdb.printing.register_pretty_printer(None, keyed_lookup)
@@ -0,0 +1,57 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2025 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* A function in Arm state whose first instruction the test replaces
+   with the instruction at REPLACEMENT, which changes a different
+   register.  */
+
+extern void patch_me (void);
+
+asm (".text\n"
+     ".arm\n"
+     ".align 2\n"
+     ".global patch_me\n"
+     ".type patch_me, %function\n"
+     "patch_me:\n"
+     "  mov r1, #1\n"
+     "  bx lr\n"
+     ".size patch_me, .-patch_me\n"
+     ".align 2\n"
+     ".global replacement\n"
+     "replacement:\n"
+     "  mov r2, #1\n");
+
+static int __attribute__ ((noinline))
+step (int x)
+{
+  return x * 3 + 1;
+}
+
+int
+main (void)
+{
+  int sum = 0;
+  int i;
+
+  for (i = 0; i < 100; i++)	/* loop start */
+    sum += step (i);
+
+  patch_me ();			/* first call */
+  patch_me ();			/* second call */
+
+  return sum;			/* return */
+}
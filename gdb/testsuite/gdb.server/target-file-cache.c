@@ -0,0 +1,42 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2025 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* 256 KiB of data using every byte value, including those that must be
+   escaped in the remote protocol, so that the executable takes several
+   vFile:pread packets to transfer.  */
+
+#define D1(x) (unsigned char) ((x) * 167u + 13u)
+#define D4(x) D1 (x), D1 ((x) + 1), D1 ((x) + 2), D1 ((x) + 3)
+#define D16(x) D4 (x), D4 ((x) + 4), D4 ((x) + 8), D4 ((x) + 12)
+#define D64(x) D16 (x), D16 ((x) + 16), D16 ((x) + 32), D16 ((x) + 48)
+#define D256(x) D64 (x), D64 ((x) + 64), D64 ((x) + 128), D64 ((x) + 192)
+#define D1K(x) D256 (x), D256 ((x) + 256), D256 ((x) + 512), D256 ((x) + 768)
+#define D4K(x) D1K (x), D1K ((x) + 1024), D1K ((x) + 2048), D1K ((x) + 3072)
+#define D16K(x) D4K (x), D4K ((x) + 4096), D4K ((x) + 8192), \
+  D4K ((x) + 12288)
+#define D64K(x) D16K (x), D16K ((x) + 16384), D16K ((x) + 32768), \
+  D16K ((x) + 49152)
+#define D256K(x) D64K (x), D64K ((x) + 65536), D64K ((x) + 131072), \
+  D64K ((x) + 196608)
+
+const unsigned char data[] = { D256K (0) };
+
+int
+main (void)
+{
+  return data[0];
+}
@@ -0,0 +1,88 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2025 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define NUM_THREADS 8
+
+static pthread_barrier_t start_barrier;
+static pthread_barrier_t exit_barrier;
+
+static void *
+thread_function (void *arg)
+{
+  long idx = (long) arg;
+
+  pthread_barrier_wait (&start_barrier);
+
+  /* The first half of the threads exit when told to, the others stay
+     around until the process exits.  */
+  if (idx < NUM_THREADS / 2)
+    pthread_barrier_wait (&exit_barrier);
+  else
+    while (1)
+      sleep (1);
+
+  return NULL;
+}
+
+static void
+all_started (void)
+{
+}
+
+static void
+thread_renamed (void)
+{
+}
+
+static void
+half_exited (void)
+{
+}
+
+int
+main (void)
+{
+  pthread_t threads[NUM_THREADS];
+  int i;
+
+  pthread_barrier_init (&start_barrier, NULL, NUM_THREADS + 1);
+  pthread_barrier_init (&exit_barrier, NULL, NUM_THREADS / 2 + 1);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    if (pthread_create (&threads[i], NULL, thread_function, (void *) (long) i) != 0)
+      abort ();
+
+  pthread_barrier_wait (&start_barrier);
+  all_started ();
+
+  /* Rename one of the threads that stay around, after GDB listed it.  */
+  pthread_setname_np (threads[NUM_THREADS - 1], "renamed");
+  thread_renamed ();
+
+  /* Let half of the threads exit.  */
+  pthread_barrier_wait (&exit_barrier);
+  for (i = 0; i < NUM_THREADS / 2; i++)
+    pthread_join (threads[i], NULL);
+  half_exited ();
+
+  return 0;
+}
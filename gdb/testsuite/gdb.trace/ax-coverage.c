@@ -0,0 +1,67 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2025 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+struct inner
+{
+  int kind;
+  union
+  {
+    int ival;
+    short sval;
+  };
+  struct
+  {
+    char tag;
+    long count;
+  };
+};
+
+struct inner objs[4];
+int table[16];
+char idx = 3;
+unsigned char uidx = 5;
+short sidx = 7;
+
+int
+counter (void)
+{
+  static int calls;
+
+  return ++calls;
+}
+
+int
+main (void)
+{
+  int i;
+
+  for (i = 0; i < 16; i++)
+    table[i] = i * 10;
+
+  for (i = 0; i < 4; i++)
+    {
+      objs[i].kind = i;
+      objs[i].ival = 100 + i;
+      objs[i].tag = 'a' + i;
+      objs[i].count = 1000 + i;
+    }
+
+  counter ();
+  counter ();
+
+  return 0;  /* set breakpoint here */
+}
@@ -52,6 +52,7 @@
 #include "frame.h"
 #include "gdbsupport/gdb_select.h"
 #include "gdbsupport/scope-exit.h"
+#include "gdbsupport/trace-events.h"
 #include "gdbarch.h"
 #include "gdbsupport/pathstuff.h"
 #include "cli/cli-style.h"
@@ -479,6 +480,10 @@ execute_command (const char *p, int from_tty)
 
       line = p;
 
+      gdb::trace_events::scoped_event trace_event ("command", "command");
+      if (trace_event.active ())
+	trace_event.set_detail (p);
+
       /* If trace-commands is set then this will print this command.  */
       print_command_trace ("%s", p);
 
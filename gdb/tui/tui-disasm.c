@@ -37,7 +37,9 @@
 #include "cli/cli-style.h"
 #include "tui/tui-location.h"
 #include "gdbsupport/selftest.h"
+#include "gdbsupport/unordered_map.h"
 #include "inferior.h"
+#include "observable.h"
 
 struct tui_asm_line
 {
@@ -80,13 +82,108 @@ len_without_escapes (const std::string &str)
   return len;
 }
 
+/* A disassembled instruction, as cached by tui_disassemble.  */
+
+struct tui_disasm_cache_entry
+{
+  /* The architecture and program space the instruction was
+     disassembled for.  */
+  struct gdbarch *gdbarch;
+  program_space *pspace;
+
+  /* Whether the text is styled.  */
+  bool term_out;
+
+  /* The bytes of the instruction.  */
+  gdb::byte_vector bytes;
+
+  /* As in tui_asm_line.  */
+  std::string insn;
+  std::string addr_string;
+  size_t addr_size;
+};
+
+/* The disassembly windows are refilled after each step, and finding
+   the start of the window disassembles much more than what is shown,
+   so instructions are cached here, keyed by address.  An entry is
+   only used if the instruction's bytes are still the same in memory.
+   Anything else that changes how instructions are shown -- symbols,
+   settings, styling -- starts a new code generation, which empties
+   the cache.  */
+
+static gdb::unordered_map<CORE_ADDR, tui_disasm_cache_entry> tui_disasm_cache;
+
+/* The cache is emptied when it holds more instructions than this.  */
+
+#define TUI_DISASM_CACHE_MAX_ENTRIES 4096
+
+/* Start a new code generation.  */
+
+static void
+tui_disasm_cache_invalidate ()
+{
+  tui_disasm_cache.clear ();
+}
+
+/* Return the cached disassembly of the instruction at PC, or nullptr if
+   there is none that is still valid.  The result is only valid until
+   the next change to the cache.  */
+
+static const tui_disasm_cache_entry *
+tui_disasm_cache_lookup (struct gdbarch *gdbarch, CORE_ADDR pc,
+			 bool term_out)
+{
+  auto iter = tui_disasm_cache.find (pc);
+  if (iter == tui_disasm_cache.end ())
+    return nullptr;
+
+  const tui_disasm_cache_entry &entry = iter->second;
+  if (entry.gdbarch != gdbarch
+      || entry.pspace != current_program_space
+      || entry.term_out != term_out)
+    return nullptr;
+
+  gdb::byte_vector bytes (entry.bytes.size ());
+  if (target_read_code (pc, bytes.data (), bytes.size ()) != 0
+      || bytes != entry.bytes)
+    return nullptr;
+
+  return &entry;
+}
+
+/* Enter the instruction at TAL.ADDR, which is LENGTH bytes long, in
+   the disassembly cache.  */
+
+static void
+tui_disasm_cache_insert (struct gdbarch *gdbarch, const tui_asm_line &tal,
+			 int length, bool term_out)
+{
+  if (length <= 0)
+    return;
+
+  tui_disasm_cache_entry entry;
+  entry.bytes.resize (length);
+  if (target_read_code (tal.addr, entry.bytes.data (), length) != 0)
+    return;
+
+  if (tui_disasm_cache.size () >= TUI_DISASM_CACHE_MAX_ENTRIES)
+    tui_disasm_cache_invalidate ();
+
+  entry.gdbarch = gdbarch;
+  entry.pspace = current_program_space;
+  entry.term_out = term_out;
+  entry.insn = tal.insn;
+  entry.addr_string = tal.addr_string;
+  entry.addr_size = tal.addr_size;
+  tui_disasm_cache.insert_or_assign (tal.addr, std::move (entry));
+}
+
 /* Function to disassemble up to COUNT instructions starting from address
    PC into the ASM_LINES vector (which will be emptied of any previous
    contents).  Return the address of the COUNT'th instruction after pc.
    When ADDR_SIZE is non-null then place the maximum size of an address and
-   label into the value pointed to by ADDR_SIZE, and set the addr_size
-   field on each item in ASM_LINES, otherwise the addr_size fields within
-   ASM_LINES are undefined.
+   label into the value pointed to by ADDR_SIZE.  The addr_size field is
+   set on each item in ASM_LINES.
 
    It is worth noting that ASM_LINES might not have COUNT entries when this
    function returns.  If the disassembly is truncated for some other
@@ -110,40 +207,53 @@ tui_disassemble (struct gdbarch *gdbarch,
       tui_asm_line tal;
       CORE_ADDR orig_pc = pc;
 
-      try
+      const tui_disasm_cache_entry *cached
+	= tui_disasm_cache_lookup (gdbarch, pc, term_out);
+      if (cached != nullptr)
 	{
-	  pc = pc + gdb_print_insn (gdbarch, pc, &gdb_dis_out, NULL);
+	  tal.addr = orig_pc;
+	  tal.insn = cached->insn;
+	  tal.addr_string = cached->addr_string;
+	  tal.addr_size = cached->addr_size;
+	  pc += cached->bytes.size ();
 	}
-      catch (const gdb_exception_error &except)
+      else
 	{
-	  /* If PC points to an invalid address then we'll catch a
-	     MEMORY_ERROR here, this should stop the disassembly, but
-	     otherwise is fine.  */
-	  if (except.error != MEMORY_ERROR)
-	    throw;
-	  return pc;
-	}
-
-      /* Capture the disassembled instruction.  */
-      tal.insn = gdb_dis_out.release ();
+	  int length;
+	  try
+	    {
+	      length = gdb_print_insn (gdbarch, pc, &gdb_dis_out, NULL);
+	      pc = pc + length;
+	    }
+	  catch (const gdb_exception_error &except)
+	    {
+	      /* If PC points to an invalid address then we'll catch a
+		 MEMORY_ERROR here, this should stop the disassembly, but
+		 otherwise is fine.  */
+	      if (except.error != MEMORY_ERROR)
+		throw;
+	      return pc;
+	    }
 
-      /* And capture the address the instruction is at.  */
-      tal.addr = orig_pc;
-      print_address (gdbarch, orig_pc, &gdb_dis_out);
-      tal.addr_string = gdb_dis_out.release ();
+	  /* Capture the disassembled instruction.  */
+	  tal.insn = gdb_dis_out.release ();
 
-      if (addr_size != nullptr)
-	{
-	  size_t new_size;
+	  /* And capture the address the instruction is at.  */
+	  tal.addr = orig_pc;
+	  print_address (gdbarch, orig_pc, &gdb_dis_out);
+	  tal.addr_string = gdb_dis_out.release ();
 
 	  if (term_out)
-	    new_size = len_without_escapes (tal.addr_string);
+	    tal.addr_size = len_without_escapes (tal.addr_string);
 	  else
-	    new_size = tal.addr_string.size ();
-	  *addr_size = std::max (*addr_size, new_size);
-	  tal.addr_size = new_size;
+	    tal.addr_size = tal.addr_string.size ();
+
+	  tui_disasm_cache_insert (gdbarch, tal, length, term_out);
 	}
 
+      if (addr_size != nullptr)
+	*addr_size = std::max (*addr_size, tal.addr_size);
+
       asm_lines.push_back (std::move (tal));
     }
   return pc;
@@ -487,28 +597,29 @@ tui_disasm_window::addr_is_displayed (CORE_ADDR addr) const
 void
 tui_disasm_window::maybe_update (struct gdbarch *gdbarch, symtab_and_line sal)
 {
-  CORE_ADDR low;
-
-  if (find_pc_partial_function (sal.pc, NULL, &low, NULL) == 0)
+  if (!addr_is_displayed (sal.pc))
     {
-      /* There is no symbol available for current PC.  There is no
-	 safe way how to "disassemble backwards".  */
-      low = sal.pc;
-    }
-  else
-    low = tui_get_low_disassembly_address (gdbarch, low, sal.pc);
+      CORE_ADDR low;
 
-  struct tui_line_or_address a;
+      /* Only look for the start of the window when it must move, as
+	 that disassembles backward from the PC.  */
+      if (find_pc_partial_function (sal.pc, NULL, &low, NULL) == 0)
+	{
+	  /* There is no symbol available for current PC.  There is no
+	     safe way how to "disassemble backwards".  */
+	  low = sal.pc;
+	}
+      else
+	low = tui_get_low_disassembly_address (gdbarch, low, sal.pc);
 
-  a.loa = LOA_ADDRESS;
-  a.u.addr = low;
-  if (!addr_is_displayed (sal.pc))
-    {
       sal.pc = low;
       update_source_window (gdbarch, sal);
     }
   else
     {
+      struct tui_line_or_address a;
+
+      a.loa = LOA_ADDRESS;
       a.u.addr = sal.pc;
       set_is_exec_point_at (a);
     }
@@ -550,6 +661,15 @@ void _initialize_tui_disasm ();
 void
 _initialize_tui_disasm ()
 {
+  gdb::observers::new_objfile.attach
+    ([] (struct objfile *) { tui_disasm_cache_invalidate (); }, "tui-disasm");
+  gdb::observers::free_objfile.attach
+    ([] (struct objfile *) { tui_disasm_cache_invalidate (); }, "tui-disasm");
+  gdb::observers::styling_changed.attach (tui_disasm_cache_invalidate,
+					  "tui-disasm");
+  gdb::observers::setting_changed.attach (tui_disasm_cache_invalidate,
+					  "tui-disasm");
+
 #if GDB_SELF_TEST
   selftests::register_test ("tui-disasm", selftests::tui::disasm::run_tests);
 #endif
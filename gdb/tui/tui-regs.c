@@ -35,6 +35,7 @@
 #include "completer.h"
 
 #include "gdb_curses.h"
+#include "observable.h"
 
 /* A subclass of string_file that expands tab characters.  */
 class tab_expansion_file : public string_file
@@ -95,15 +96,56 @@ tui_register_format (const frame_info_ptr &frame, int regnum)
   return str;
 }
 
+/* The formatting generation.  This changes whenever something other
+   than a register's value may change how it is formatted.  */
+
+static unsigned int tui_register_format_generation = 1;
+
+/* Start a new formatting generation.  */
+
+static void
+tui_register_format_invalidate ()
+{
+  ++tui_register_format_generation;
+}
+
 /* Compute the register value from the given frame and format it for
    the display.  Update 'content' and set 'm_highlight' if the
    contents changed.  */
 void
 tui_register_info::update (const frame_info_ptr &frame)
 {
+  /* Formatting a register costs much more than fetching its value, so
+     don't format it again if neither the value nor the formatting
+     generation changed.  */
+  value_ref_ptr new_value;
+  try
+    {
+      value *val = get_frame_register_value (frame, m_regno);
+      if (val->lazy ())
+	val->fetch_lazy ();
+      new_value = release_value (val);
+    }
+  catch (const gdb_exception_error &except)
+    {
+      /* Formatting the register will show the error.  */
+    }
+
+  if (new_value != nullptr
+      && m_value != nullptr
+      && m_format_generation == tui_register_format_generation
+      && new_value->type () == m_value->type ()
+      && new_value->contents_eq (m_value.get ()))
+    {
+      m_highlight = false;
+      return;
+    }
+
   std::string new_content = tui_register_format (frame, m_regno);
   m_highlight = content != new_content;
   content = std::move (new_content);
+  m_value = std::move (new_value);
+  m_format_generation = tui_register_format_generation;
 }
 
 /* See tui-regs.h.  */
@@ -574,6 +616,17 @@ _initialize_tui_regs ()
 
   tuicmd = tui_get_cmd_list ();
 
+  gdb::observers::new_objfile.attach
+    ([] (struct objfile *) { tui_register_format_invalidate (); },
+     "tui-regs");
+  gdb::observers::free_objfile.attach
+    ([] (struct objfile *) { tui_register_format_invalidate (); },
+     "tui-regs");
+  gdb::observers::styling_changed.attach (tui_register_format_invalidate,
+					  "tui-regs");
+  gdb::observers::setting_changed.attach (tui_register_format_invalidate,
+					  "tui-regs");
+
   cmd = add_cmd ("reg", class_tui, tui_reg_command, _("\
 TUI command to control the register window.\n\
 Usage: tui reg NAME\n\
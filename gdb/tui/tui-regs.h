@@ -25,6 +25,7 @@
 #include "gdbsupport/gdb-checked-static-cast.h"
 #include "tui/tui-data.h"
 #include "reggroups.h"
+#include "value.h"
 
 /* Information about the display of a single register.  */
 
@@ -60,6 +61,12 @@ struct tui_register_info
   /* True if currently highlighted.  */
   bool m_highlight = false;
 
+  /* The value CONTENT was formatted from, if it could be fetched,
+     and the formatting generation at the time.  CONTENT is only
+     formatted again when either changed.  */
+  value_ref_ptr m_value;
+  unsigned int m_format_generation = 0;
+
   /* The register number.  */
   const int m_regno;
 };
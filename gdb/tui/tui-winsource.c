@@ -139,6 +139,9 @@ tui_copy_source_line (const char **ptr, int *length)
 void
 tui_source_window_base::style_changed ()
 {
+  /* The same text may now be drawn differently.  */
+  m_drawn.clear ();
+
   if (tui_active && is_visible ())
     refill ();
 }
@@ -387,6 +390,7 @@ tui_source_window_base::show_source_content ()
 	    {
 	      /* Try to allocate a new pad.  */
 	      m_pad.reset (newpad (required_pad_height, pad_width));
+	      m_drawn.clear ();
 
 	      if (m_pad == nullptr)
 		{
@@ -405,9 +409,39 @@ tui_source_window_base::show_source_content ()
     }
 
   gdb_assert (m_pad != nullptr);
-  werase (m_pad.get ());
+
+  /* Lines are drawn at an offset into the pad; if that changed, all
+     of them must be drawn again.  */
+  if (m_drawn_pad_offset != m_pad_offset)
+    {
+      m_drawn.clear ();
+      m_drawn_pad_offset = m_pad_offset;
+    }
+  if (m_drawn.empty ())
+    werase (m_pad.get ());
+
+  /* An empty pad line is the same as a drawn empty line, so the new
+     entries need not be drawn unless they have content.  */
+  if (m_drawn.size () < m_content.size ())
+    m_drawn.resize (m_content.size ());
+
+  /* Only draw the lines that changed since they were last drawn.  */
   for (int lineno = 0; lineno < m_content.size (); lineno++)
-    show_source_line (lineno);
+    {
+      const tui_source_element &element = m_content[lineno];
+      drawn_line &drawn = m_drawn[lineno];
+
+      if (drawn.is_exec_point == element.is_exec_point
+	  && drawn.line == element.line)
+	continue;
+
+      wmove (m_pad.get (), lineno, 0);
+      wclrtoeol (m_pad.get ());
+      show_source_line (lineno);
+
+      drawn.line = element.line;
+      drawn.is_exec_point = element.is_exec_point;
+    }
 
   /* Calling check_and_display_highlight_if_needed will call
      refresh_window.  */
@@ -434,6 +468,7 @@ tui_source_window_base::~tui_source_window_base ()
 void
 tui_source_window_base::update_tab_width ()
 {
+  m_drawn.clear ();
   werase (handle.get ());
   rerender ();
 }
@@ -589,8 +624,14 @@ tui_source_window_base::set_is_exec_point_at (struct tui_line_or_address l)
 	}
       i++;
     }
+
+  /* Only the lines whose exec point status changed are drawn again;
+     the rest of the content is still valid.  */
   if (changed)
-    refill ();
+    {
+      update_exec_info (false);
+      show_source_content ();
+    }
 }
 
 /* See tui-winsource.h.  */
@@ -136,6 +136,20 @@ struct tui_source_window_base : public tui_win_info
   /* Length of longest line to be displayed.  */
   int m_max_length;
 
+  /* What show_source_content last drew on a line of the pad.  */
+  struct drawn_line
+  {
+    std::string line;
+    bool is_exec_point = false;
+  };
+
+  /* The lines as drawn on the pad, used to draw only the lines that
+     changed.  Empty if the whole pad must be drawn again.  */
+  std::vector<drawn_line> m_drawn;
+
+  /* The value of M_PAD_OFFSET when M_DRAWN was drawn.  */
+  int m_drawn_pad_offset = 0;
+
 public:
 
   /* Refill the source window's source cache and update it.  If this
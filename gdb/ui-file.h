@@ -220,6 +220,7 @@ class string_file : public ui_file
   size_t size () const { return m_string.size (); }
   bool empty () const { return m_string.empty (); }
   void clear () { return m_string.clear (); }
+  void reserve (size_t size) { m_string.reserve (size); }
 
 private:
   /* The internal buffer.  */
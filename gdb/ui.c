@@ -163,8 +163,11 @@ void
 ui::register_file_handler ()
 {
   if (input_fd != -1)
-    add_file_handler (input_fd, stdin_event_handler, this,
-		      string_printf ("ui-%d", num), true);
+    {
+      add_file_handler (input_fd, stdin_event_handler, this,
+			string_printf ("ui-%d", num), true);
+      input_fd_registered = true;
+    }
 }
 
 /* See top.h.  */
@@ -174,6 +177,7 @@ ui::unregister_file_handler ()
 {
   if (input_fd != -1)
     delete_file_handler (input_fd);
+  input_fd_registered = false;
 }
 
 /* Open file named NAME for read/write, making sure not to make it the
@@ -128,6 +128,10 @@ struct ui
      registration.  */
   int input_fd;
 
+  /* Whether input_fd is currently registered with the event loop,
+     see register_file_handler.  */
+  bool input_fd_registered = false;
+
   /* Whether ISATTY returns true on input_fd.  Cached here because
      quit_force needs to know this _after_ input_fd might be
      closed.  */
@@ -125,6 +125,47 @@ string_vappendf_tests ()
   test_appendf_func (string_vappendf_wrapper);
 }
 
+/* Check count_repeated_units against a unit-by-unit count, for runs
+   ending at every position and for several unit sizes.  */
+
+static void
+count_repeated_units_tests ()
+{
+  for (size_t unit_len : { 1, 2, 3, 4, 8 })
+    {
+      const size_t count = 3000;
+      std::vector<gdb_byte> buffer (count * unit_len);
+      std::vector<gdb_byte> unit (unit_len);
+
+      for (size_t i = 0; i < unit_len; i++)
+	unit[i] = 0x40 + i;
+      for (size_t i = 0; i < count; i++)
+	memcpy (&buffer[i * unit_len], unit.data (), unit_len);
+
+      SELF_CHECK (count_repeated_units (unit.data (), unit_len,
+					buffer.data (), count) == count);
+      SELF_CHECK (count_repeated_units (unit.data (), unit_len,
+					buffer.data (), 0) == 0);
+
+      for (size_t end : { (size_t) 0, (size_t) 1, (size_t) 2, (size_t) 7,
+			  (size_t) 64, (size_t) 1023, (size_t) 2999 })
+	{
+	  /* Change one byte of unit END, the last one, or the first
+	     one, which must all stop the run there.  */
+	  for (size_t byte : { (size_t) 0, unit_len - 1 })
+	    {
+	      gdb_byte *p = &buffer[end * unit_len + byte];
+	      gdb_byte saved = *p;
+
+	      *p ^= 1;
+	      SELF_CHECK (count_repeated_units (unit.data (), unit_len,
+						buffer.data (), count) == end);
+	      *p = saved;
+	    }
+	}
+    }
+}
+
 } /* namespace selftests */
 
 void _initialize_common_utils_selftests ();
@@ -136,4 +177,6 @@ _initialize_common_utils_selftests ()
   selftests::register_test ("string_appendf", selftests::string_appendf_tests);
   selftests::register_test ("string_vappendf",
 			    selftests::string_vappendf_tests);
+  selftests::register_test ("count_repeated_units",
+			    selftests::count_repeated_units_tests);
 }
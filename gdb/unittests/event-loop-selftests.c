@@ -0,0 +1,344 @@
+/* Self tests for the event loop.
+
+   Copyright (C) 2025 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "gdbsupport/selftest.h"
+#include "gdbsupport/event-loop.h"
+#include "gdbsupport/filestuff.h"
+#include "gdbsupport/scope-exit.h"
+#include "ui.h"
+#include <chrono>
+
+namespace selftests {
+namespace event_loop_tests {
+
+#if (defined (HAVE_PIPE) || defined (HAVE_PIPE2)) && !defined (USE_WIN32API)
+
+/* A pipe whose read end is monitored by the event loop.  */
+
+struct test_pipe
+{
+  test_pipe ()
+  {
+    SELF_CHECK (gdb_pipe_cloexec (fds) == 0);
+  }
+
+  ~test_pipe ()
+  {
+    if (registered)
+      delete_file_handler (fds[0]);
+    close (fds[0]);
+    close (fds[1]);
+  }
+
+  DISABLE_COPY_AND_ASSIGN (test_pipe);
+
+  /* Make the read end readable.  */
+  void write_byte ()
+  {
+    char c = 0;
+    SELF_CHECK (write (fds[1], &c, 1) == 1);
+  }
+
+  int fds[2];
+
+  /* The number of times the handler was called.  */
+  int calls = 0;
+
+  /* If set, the handler deletes this pipe's file handler.  */
+  test_pipe *to_delete = nullptr;
+
+  /* Whether the read end is registered with the event loop.  */
+  bool registered = false;
+};
+
+/* The order in which pipe handlers were called.  */
+
+static std::vector<test_pipe *> call_order;
+
+/* File handler for test pipes.  Consume one byte.  */
+
+static void
+pipe_handler (int err, gdb_client_data client_data)
+{
+  test_pipe *p = (test_pipe *) client_data;
+  char c;
+
+  SELF_CHECK (err == 0);
+  SELF_CHECK (read (p->fds[0], &c, 1) == 1);
+  p->calls++;
+  call_order.push_back (p);
+
+  if (p->to_delete != nullptr)
+    {
+      delete_file_handler (p->to_delete->fds[0]);
+      p->to_delete->registered = false;
+    }
+}
+
+/* Create NUM pipes and register their read ends.  */
+
+static std::vector<std::unique_ptr<test_pipe>>
+make_pipes (int num)
+{
+  std::vector<std::unique_ptr<test_pipe>> pipes;
+
+  for (int i = 0; i < num; i++)
+    {
+      pipes.emplace_back (new test_pipe);
+      test_pipe *p = pipes.back ().get ();
+      add_file_handler (p->fds[0], pipe_handler, p,
+			string_printf ("event-loop-test-%d", i));
+      p->registered = true;
+    }
+
+  return pipes;
+}
+
+/* While this is alive, GDB's own input is not handled by the event
+   loop.  The tests run in the middle of a command, when readline is
+   not ready to read a new one.  The UI's handler is registered again
+   afterwards only if it was registered before.  */
+
+struct scoped_ignore_ui_input
+{
+  scoped_ignore_ui_input ()
+    : m_ui (current_ui),
+      m_was_registered (m_ui->input_fd_registered)
+  {
+    if (m_was_registered)
+      m_ui->unregister_file_handler ();
+  }
+
+  ~scoped_ignore_ui_input ()
+  {
+    if (m_was_registered)
+      m_ui->register_file_handler ();
+  }
+
+  DISABLE_COPY_AND_ASSIGN (scoped_ignore_ui_input);
+
+private:
+  struct ui *m_ui;
+  bool m_was_registered;
+};
+
+/* Run the event loop without blocking until TOTAL pipe handler calls
+   were made, or nothing is left to do.  */
+
+static void
+run_until (size_t total)
+{
+  while (call_order.size () < total)
+    if (gdb_do_one_event (0) <= 0)
+      break;
+}
+
+/* Check that events on many descriptors are all delivered, and that
+   descriptors that stay ready are served in turn.  */
+
+static void
+test_many_fds ()
+{
+  scoped_ignore_ui_input ignore_input;
+  call_order.clear ();
+  auto pipes = make_pipes (200);
+
+  for (auto &p : pipes)
+    p->write_byte ();
+  run_until (pipes.size ());
+
+  SELF_CHECK (call_order.size () == pipes.size ());
+  for (auto &p : pipes)
+    SELF_CHECK (p->calls == 1);
+
+  /* Two descriptors with several pending bytes each.  Each handler
+     call only consumes one, so both stay ready: they must
+     alternate.  */
+  call_order.clear ();
+  test_pipe *a = pipes[17].get ();
+  test_pipe *b = pipes[123].get ();
+  for (int i = 0; i < 3; i++)
+    {
+      a->write_byte ();
+      b->write_byte ();
+    }
+  run_until (6);
+
+  SELF_CHECK (call_order.size () == 6);
+  for (size_t i = 1; i < call_order.size (); i++)
+    SELF_CHECK (call_order[i] != call_order[i - 1]);
+}
+
+/* Check that a handler deleted by another handler is not called, even
+   though its descriptor is ready.  */
+
+static void
+test_delete_from_handler ()
+{
+  scoped_ignore_ui_input ignore_input;
+  call_order.clear ();
+  auto pipes = make_pipes (2);
+  test_pipe *a = pipes[0].get ();
+  test_pipe *b = pipes[1].get ();
+
+  a->to_delete = b;
+  b->to_delete = a;
+  a->write_byte ();
+  b->write_byte ();
+  run_until (2);
+
+  SELF_CHECK (call_order.size () == 1);
+  SELF_CHECK (a->calls + b->calls == 1);
+}
+
+/* File handler that counts its calls in the int CLIENT_DATA points
+   to.  */
+
+static void
+count_handler (int err, gdb_client_data client_data)
+{
+  SELF_CHECK (err == 0);
+  (*(int *) client_data)++;
+}
+
+/* Check that registering a descriptor again is effective even if it
+   was closed and reused in the meantime, without its handler being
+   deleted.  */
+
+static void
+test_reused_fd ()
+{
+  scoped_ignore_ui_input ignore_input;
+  call_order.clear ();
+  auto pipes = make_pipes (1);
+  test_pipe *a = pipes[0].get ();
+  test_pipe b;
+
+  /* Replace A's read end by B's.  */
+  SELF_CHECK (dup2 (b.fds[0], a->fds[0]) == a->fds[0]);
+  std::swap (a->fds[1], b.fds[1]);
+  add_file_handler (a->fds[0], pipe_handler, a, "event-loop-test-0");
+
+  a->write_byte ();
+  run_until (1);
+
+  SELF_CHECK (call_order.size () == 1);
+  SELF_CHECK (a->calls == 1);
+}
+
+/* Check that a descriptor that epoll doesn't support, like a regular
+   file, is still monitored, without starving the others.  */
+
+static void
+test_regular_file ()
+{
+  scoped_ignore_ui_input ignore_input;
+  call_order.clear ();
+  auto pipes = make_pipes (2);
+
+  gdb_file_up file (tmpfile ());
+  SELF_CHECK (file != nullptr);
+  int fd = fileno (file.get ());
+  int calls = 0;
+
+  /* A regular file is always readable.  */
+  add_file_handler (fd, count_handler, &calls, "event-loop-test-file");
+  SCOPE_EXIT { delete_file_handler (fd); };
+
+  for (auto &p : pipes)
+    for (int i = 0; i < 3; i++)
+      p->write_byte ();
+
+  for (int i = 0; i < 20 && call_order.size () < 6; i++)
+    SELF_CHECK (gdb_do_one_event (0) > 0);
+
+  SELF_CHECK (call_order.size () == 6);
+  SELF_CHECK (calls > 0);
+
+  /* Adding the file's handler again keeps it monitored.  */
+  add_file_handler (fd, count_handler, &calls, "event-loop-test-file");
+  int before = calls;
+  SELF_CHECK (gdb_do_one_event (0) > 0);
+  SELF_CHECK (calls == before + 1);
+}
+
+/* Measure how long it takes to dispatch events when many descriptors
+   are monitored but only one is ready at a time.  This exercises the
+   cost of a wakeup as a function of the number of monitored
+   descriptors.  The result is not checked, only that every event is
+   delivered; run "maint selftest -verbose event-loop-dispatch" to see
+   the timing.  */
+
+static void
+test_dispatch_latency ()
+{
+  scoped_ignore_ui_input ignore_input;
+  const int num_fds = 500;
+  const int num_events = 20000;
+
+  call_order.clear ();
+  call_order.reserve (num_events);
+  auto pipes = make_pipes (num_fds);
+
+  using namespace std::chrono;
+  steady_clock::time_point start = steady_clock::now ();
+
+  for (int i = 0; i < num_events; i++)
+    {
+      /* Spread the events over the descriptors, without a regular
+	 pattern.  */
+      pipes[(i * 7919) % num_fds]->write_byte ();
+      run_until (i + 1);
+    }
+
+  steady_clock::duration elapsed = steady_clock::now () - start;
+
+  SELF_CHECK (call_order.size () == num_events);
+
+  if (run_verbose ())
+    debug_printf ("event-loop-dispatch: %d events over %d descriptors: "
+		  "%.3f us per event\n", num_events, num_fds,
+		  duration_cast<nanoseconds> (elapsed).count ()
+		  / 1000.0 / num_events);
+}
+
+#endif
+
+} /* namespace event_loop_tests */
+} /* namespace selftests */
+
+void _initialize_event_loop_selftests ();
+void
+_initialize_event_loop_selftests ()
+{
+#if (defined (HAVE_PIPE) || defined (HAVE_PIPE2)) && !defined (USE_WIN32API)
+  selftests::register_test ("event-loop",
+			    [] ()
+			    {
+			      selftests::event_loop_tests::test_many_fds ();
+			      selftests::event_loop_tests
+				::test_delete_from_handler ();
+			      selftests::event_loop_tests::test_reused_fd ();
+			      selftests::event_loop_tests::test_regular_file ();
+			    });
+  selftests::register_test
+    ("event-loop-dispatch",
+     selftests::event_loop_tests::test_dispatch_latency);
+#endif
+}
@@ -19,6 +19,9 @@
 
 #include "gdbsupport/selftest.h"
 #include "gdbsupport/rsp-low.h"
+#include "gdbsupport/gdb-safe-ctype.h"
+#include <chrono>
+#include <random>
 
 namespace selftests {
 namespace rsp_low {
@@ -57,6 +60,328 @@ static void test_hex2str ()
   SELF_CHECK (hex2str ("") == "");
 }
 
+/* Byte-wise reference implementations of the conversion routines,
+   which may process several bytes at a time.  */
+
+static std::string
+reference_bin2hex (const gdb_byte *bin, int count)
+{
+  std::string ret;
+
+  for (int i = 0; i < count; i++)
+    {
+      ret += tohex ((bin[i] >> 4) & 0xf);
+      ret += tohex (bin[i] & 0xf);
+    }
+  return ret;
+}
+
+static bool
+reference_needs_escaping (gdb_byte b)
+{
+  return b == '$' || b == '#' || b == '}' || b == '*';
+}
+
+static int
+reference_escape (const gdb_byte *buffer, int len_units, int unit_size,
+		  gdb_byte *out_buf, int *out_len_units, int out_maxlen)
+{
+  int unit, out = 0;
+
+  for (unit = 0; unit < len_units; unit++)
+    {
+      const gdb_byte *p = buffer + unit * unit_size;
+      int needed = unit_size;
+
+      for (int i = 0; i < unit_size; i++)
+	needed += reference_needs_escaping (p[i]);
+      if (out + needed > out_maxlen)
+	break;
+
+      for (int i = 0; i < unit_size; i++)
+	if (reference_needs_escaping (p[i]))
+	  {
+	    out_buf[out++] = '}';
+	    out_buf[out++] = p[i] ^ 0x20;
+	  }
+	else
+	  out_buf[out++] = p[i];
+    }
+
+  *out_len_units = unit;
+  return out;
+}
+
+/* Return the output length of unescaping BUFFER, or -1 if that would
+   be an error.  */
+
+static int
+reference_unescape (const gdb_byte *buffer, int len, gdb_byte *out_buf,
+		    int out_maxlen)
+{
+  int out = 0;
+  bool escaped = false;
+
+  for (int i = 0; i < len; i++)
+    {
+      if (out + 1 > out_maxlen)
+	return -1;
+      if (escaped)
+	{
+	  out_buf[out++] = buffer[i] ^ 0x20;
+	  escaped = false;
+	}
+      else if (buffer[i] == '}')
+	escaped = true;
+      else
+	out_buf[out++] = buffer[i];
+    }
+
+  return escaped ? -1 : out;
+}
+
+/* Return LEN bytes of random data.  If SPECIAL, about one byte in
+   eight is one of the characters that need escaping.  */
+
+static gdb::byte_vector
+random_bytes (std::minstd_rand &gen, size_t len, bool special)
+{
+  static const char special_chars[] = "$#}*";
+  gdb::byte_vector ret (len);
+
+  for (gdb_byte &b : ret)
+    if (special && gen () % 8 == 0)
+      b = special_chars[gen () % 4];
+    else
+      b = gen () & 0xff;
+
+  return ret;
+}
+
+/* Check the hex encoding and decoding routines against the reference
+   code, for all the lengths and alignments that matter.  */
+
+static void
+test_hex_codecs ()
+{
+  std::minstd_rand gen (1);
+  gdb::byte_vector data = random_bytes (gen, 120, false);
+
+  for (int offset = 0; offset < 4; offset++)
+    for (int len = 0; offset + len <= data.size (); len++)
+      {
+	const gdb_byte *bin = data.data () + offset;
+	std::string expected = reference_bin2hex (bin, len);
+
+	SELF_CHECK (bin2hex (bin, len) == expected);
+
+	std::vector<char> hex (len * 2 + 1, 'x');
+	SELF_CHECK (bin2hex (bin, hex.data (), len) == len);
+	SELF_CHECK (hex[len * 2] == '\0');
+	SELF_CHECK (expected == hex.data ());
+
+	/* Decoding accepts both cases.  */
+	for (int i = 0; i < len * 2; i += 3)
+	  hex[i] = TOUPPER (hex[i]);
+
+	gdb::byte_vector decoded (len + 1, 0xaa);
+	SELF_CHECK (hex2bin (hex.data (), decoded.data (), len) == len);
+	SELF_CHECK (memcmp (decoded.data (), bin, len) == 0);
+	SELF_CHECK (decoded[len] == 0xaa);
+
+	/* Asking for more bytes than there are stops at the end of the
+	   string, including when it has an odd length.  */
+	SELF_CHECK (hex2bin (hex.data (), decoded.data (), len + 20) == len);
+	if (len > 0)
+	  {
+	    hex[len * 2 - 1] = '\0';
+	    SELF_CHECK (hex2bin (hex.data (), decoded.data (), len + 20)
+			== len - 1);
+	  }
+      }
+
+  /* An invalid digit is an error, and the bytes before it are
+     converted.  */
+  std::string hex = reference_bin2hex (data.data (), 40);
+  for (int bad : { 0, 5, 31, 32, 33, 63, 70 })
+    {
+      std::string copy = hex;
+      gdb::byte_vector decoded (40, 0);
+      bool threw = false;
+
+      copy[bad] = 'g';
+      try
+	{
+	  hex2bin (copy.c_str (), decoded.data (), 40);
+	}
+      catch (const gdb_exception_error &ex)
+	{
+	  threw = true;
+	}
+      SELF_CHECK (threw);
+      SELF_CHECK (memcmp (decoded.data (), data.data (), bad / 2) == 0);
+    }
+}
+
+/* Check binary escaping and unescaping against the reference code,
+   including when the output buffer is too small.  */
+
+static void
+test_escape_codecs ()
+{
+  std::minstd_rand gen (2);
+
+  for (bool special : { false, true })
+    for (int len = 0; len < 70; len++)
+      {
+	gdb::byte_vector data = random_bytes (gen, len, special);
+	int maxlen = len * 2 + 1;
+
+	for (int unit_size : { 1, 2 })
+	  for (int out_maxlen = 0; out_maxlen <= maxlen; out_maxlen++)
+	    {
+	      int units = len / unit_size;
+	      gdb::byte_vector expected (maxlen), actual (maxlen);
+	      int expected_units, actual_units;
+
+	      int expected_len
+		= reference_escape (data.data (), units, unit_size,
+				    expected.data (), &expected_units,
+				    out_maxlen);
+	      int actual_len
+		= remote_escape_output (data.data (), units, unit_size,
+					actual.data (), &actual_units,
+					out_maxlen);
+	      SELF_CHECK (actual_len == expected_len);
+	      SELF_CHECK (actual_units == expected_units);
+	      SELF_CHECK (memcmp (actual.data (), expected.data (),
+				  expected_len) == 0);
+	    }
+
+	/* Unescape the escaped data, or random data, which may have an
+	   unmatched escape character at the end.  */
+	gdb::byte_vector escaped (maxlen);
+	int units;
+	int escaped_len = reference_escape (data.data (), len, 1,
+					    escaped.data (), &units, maxlen);
+
+	for (bool use_data : { false, true })
+	  {
+	    const gdb_byte *in = use_data ? data.data () : escaped.data ();
+	    int in_len = use_data ? len : escaped_len;
+
+	    for (int out_maxlen = 0; out_maxlen <= in_len + 1; out_maxlen++)
+	      {
+		gdb::byte_vector expected (in_len + 1), actual (in_len + 1);
+		int expected_len = reference_unescape (in, in_len,
+						       expected.data (),
+						       out_maxlen);
+		int actual_len;
+
+		try
+		  {
+		    actual_len = remote_unescape_input (in, in_len,
+							actual.data (),
+							out_maxlen);
+		  }
+		catch (const gdb_exception_error &ex)
+		  {
+		    actual_len = -1;
+		  }
+
+		SELF_CHECK (actual_len == expected_len);
+		if (expected_len > 0)
+		  SELF_CHECK (memcmp (actual.data (), expected.data (),
+				      expected_len) == 0);
+	      }
+	  }
+      }
+}
+
+/* Check the packet checksum.  */
+
+static void
+test_packet_checksum ()
+{
+  std::minstd_rand gen (3);
+  gdb::byte_vector data = random_bytes (gen, 300, false);
+  const char *buf = (const char *) data.data ();
+
+  for (int offset = 0; offset < 4; offset++)
+    for (int len = 0; offset + len <= data.size (); len++)
+      {
+	unsigned char expected = 0;
+
+	for (int i = 0; i < len; i++)
+	  expected += buf[offset + i];
+	SELF_CHECK (remote_packet_checksum (buf + offset, len) == expected);
+      }
+}
+
+/* Measure the throughput of the conversion routines, on a buffer the
+   size of a large memory transfer.  Run "maint selftest -verbose
+   rsp-low-throughput" to see the results.  */
+
+static void
+test_throughput ()
+{
+  const int size = 1024 * 1024;
+  const int iterations = 8;
+  std::minstd_rand gen (4);
+  gdb::byte_vector data = random_bytes (gen, size, true);
+  std::vector<char> hex (size * 2 + 1);
+  gdb::byte_vector escaped (size * 2), decoded (size);
+  int escaped_len = 0, units;
+
+  using namespace std::chrono;
+
+  auto measure = [&] (const char *name, gdb::function_view<void ()> func)
+    {
+      steady_clock::time_point start = steady_clock::now ();
+
+      for (int i = 0; i < iterations; i++)
+	func ();
+
+      double secs = duration<double> (steady_clock::now () - start).count ();
+      if (run_verbose ())
+	debug_printf ("rsp-low-throughput: %s: %.1f MB/s\n", name,
+		      secs > 0 ? size * (double) iterations / secs / 1e6 : 0);
+    };
+
+  measure ("bin2hex", [&] ()
+    {
+      bin2hex (data.data (), hex.data (), size);
+    });
+  measure ("hex2bin", [&] ()
+    {
+      hex2bin (hex.data (), decoded.data (), size);
+    });
+  SELF_CHECK (decoded == data);
+
+  measure ("remote_escape_output", [&] ()
+    {
+      escaped_len = remote_escape_output (data.data (), size, 1,
+					  escaped.data (), &units,
+					  escaped.size ());
+    });
+  SELF_CHECK (units == size);
+  measure ("remote_unescape_input", [&] ()
+    {
+      remote_unescape_input (escaped.data (), escaped_len, decoded.data (),
+			     decoded.size ());
+    });
+  SELF_CHECK (decoded == data);
+
+  unsigned char csum = 0, expected = 0;
+  measure ("remote_packet_checksum", [&] ()
+    {
+      csum = remote_packet_checksum (hex.data (), size * 2);
+    });
+  for (int i = 0; i < size * 2; i++)
+    expected += hex[i];
+  SELF_CHECK (csum == expected);
+}
+
 } /* namespace rsp_low */
 } /* namespace selftests */
 
@@ -68,4 +393,12 @@ _initialize_rsp_low_selftests ()
 			    selftests::rsp_low::test_hex2bin_byte_vector);
   selftests::register_test ("hex2str",
 			    selftests::rsp_low::test_hex2str);
+  selftests::register_test ("rsp-low-hex-codecs",
+			    selftests::rsp_low::test_hex_codecs);
+  selftests::register_test ("rsp-low-escape-codecs",
+			    selftests::rsp_low::test_escape_codecs);
+  selftests::register_test ("rsp-low-packet-checksum",
+			    selftests::rsp_low::test_packet_checksum);
+  selftests::register_test ("rsp-low-throughput",
+			    selftests::rsp_low::test_throughput);
 }
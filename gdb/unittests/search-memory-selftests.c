@@ -85,6 +85,107 @@ run_tests ()
   SELF_CHECK (addr == found_addr);
 }
 
+/* Return the lowest address in DATA, based at BASE, at which one of
+   PATTERNS starts at an address that is a multiple of ALIGN, the
+   slow way.  */
+
+static bool
+brute_force_search (const std::vector<gdb_byte> &data, CORE_ADDR base,
+		    gdb::array_view<const search_pattern> patterns,
+		    ULONGEST align, CORE_ADDR *addrp, size_t *indexp)
+{
+  for (size_t off = 0; off < data.size (); off++)
+    {
+      if ((base + off) % align != 0)
+	continue;
+      for (size_t i = 0; i < patterns.size (); i++)
+	if (off + patterns[i].size () <= data.size ()
+	    && memcmp (&data[off], patterns[i].data (),
+		       patterns[i].size ()) == 0)
+	  {
+	    *addrp = base + off;
+	    *indexp = i;
+	    return true;
+	  }
+    }
+  return false;
+}
+
+/* Check simple_search_memory_multi against a brute force search, over
+   data where the patterns are frequent, with small chunk sizes so that
+   matches straddle chunk boundaries.  */
+
+static void
+run_multi_tests ()
+{
+  const CORE_ADDR base = 0x1003;
+  std::vector<gdb_byte> data (5000);
+
+  /* A small alphabet, so that the patterns below occur often.  */
+  unsigned int seed = 1;
+  for (gdb_byte &b : data)
+    {
+      seed = seed * 1103515245 + 12345;
+      b = "abcd"[(seed >> 16) % 4];
+    }
+
+  auto read_memory = [&] (CORE_ADDR from, gdb_byte *out, size_t len)
+    {
+      SELF_CHECK (from >= base && from + len <= base + data.size ());
+      memcpy (out, &data[from - base], len);
+      return true;
+    };
+
+  static const gdb_byte p1[] = { 'a', 'b', 'c', 'd', 'a' };
+  static const gdb_byte p2[] = { 'd', 'd', 'd' };
+  static const gdb_byte p3[] = { 'c', 'a', 'b', 'b', 'a', 'd', 'c' };
+  const search_pattern patterns[] = { p1, p2, p3 };
+
+  for (size_t chunk_size : { 1, 7, 64, 4096 })
+    for (ULONGEST align : { 1, 2, 8 })
+      {
+	/* Walk through all the matches, the way "find" does.  */
+	CORE_ADDR start = base;
+	while (start < base + data.size ())
+	  {
+	    std::vector<gdb_byte> rest (data.begin () + (start - base),
+					data.end ());
+	    CORE_ADDR expected_addr = 0;
+	    size_t expected_index = 0;
+	    bool expected = brute_force_search (rest, start, patterns, align,
+						&expected_addr,
+						&expected_index);
+
+	    CORE_ADDR addr = 0;
+	    size_t index = 0;
+	    int result
+	      = simple_search_memory_multi (read_memory, start,
+					    base + data.size () - start,
+					    patterns, align, &addr, &index,
+					    chunk_size);
+	    SELF_CHECK (result == (expected ? 1 : 0));
+	    if (!expected)
+	      break;
+	    SELF_CHECK (addr == expected_addr);
+	    SELF_CHECK (index == expected_index);
+
+	    /* Stepping over many matches is slow with tiny chunks; take
+	       bigger strides there.  */
+	    start = addr + (chunk_size < 64 ? 397 : 1);
+	  }
+      }
+
+  /* A failing read is reported.  */
+  auto read_fail = [] (CORE_ADDR, gdb_byte *, size_t)
+    {
+      return false;
+    };
+  CORE_ADDR addr;
+  size_t index;
+  SELF_CHECK (simple_search_memory_multi (read_fail, base, data.size (),
+					  patterns, 1, &addr, &index) == -1);
+}
+
 } /* namespace search_memory_tests */
 } /* namespace selftests */
 
@@ -95,4 +196,6 @@ _initialize_search_memory_selftests ()
 {
   selftests::register_test ("search_memory",
 			    selftests::search_memory_tests::run_tests);
+  selftests::register_test ("search_memory_multi",
+			    selftests::search_memory_tests::run_multi_tests);
 }
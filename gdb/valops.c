@@ -1364,15 +1364,13 @@ value_repeat (struct value *arg1, int count)
   if (count < 1)
     error (_("Invalid number %d of repetitions."), count);
 
-  val = allocate_repeat_value (arg1->enclosing_type (), count);
+  /* Do not read the memory yet: only the elements that are used, for
+     instance the ones that are printed, need to be fetched.  */
+  val = allocate_repeat_value (arg1->enclosing_type (), count, true);
 
   val->set_lval (lval_memory);
   val->set_address (arg1->address ());
 
-  read_value_memory (val, 0, val->stack (), val->address (),
-		     val->contents_all_raw ().data (),
-		     type_length_units (val->enclosing_type ()));
-
   return val;
 }
 
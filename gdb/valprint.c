@@ -1098,6 +1098,68 @@ generic_value_print (struct value *val, struct ui_file *stream, int recurse,
     }
 }
 
+/* Return true if LANGUAGE prints arrays with c_value_print_array,
+   which prints the elements of non-string arrays with
+   value_print_array_elements, and integers with c_value_print_int.  */
+
+static bool
+c_like_array_language_p (const struct language_defn *language)
+{
+  switch (language->la_language)
+    {
+    case language_c:
+    case language_objc:
+    case language_cplus:
+    case language_d:
+    case language_go:
+    case language_asm:
+    case language_minimal:
+    case language_opencl:
+      return true;
+    default:
+      return false;
+    }
+}
+
+/* See valprint.h.  */
+
+bool
+val_print_array_lazily_p (struct value *val,
+			  const struct value_print_options *options,
+			  const struct language_defn *language)
+{
+  if (!val->lazy ()
+      || val->lval () != lval_memory
+      || val->bitsize () != 0
+      || val->embedded_offset () != 0)
+    return false;
+
+  /* Other languages may look at the contents of the whole array
+     before printing its elements.  */
+  if (!c_like_array_language_p (language))
+    return false;
+
+  struct type *type = check_typedef (val->type ());
+  if (type->code () != TYPE_CODE_ARRAY)
+    return false;
+
+  ULONGEST eltlen = check_typedef (type->target_type ())->length ();
+  if (eltlen == 0
+      || (type->bit_stride () != 0
+	  && type->bit_stride () != eltlen * TARGET_CHAR_BIT))
+    return false;
+
+  /* Arrays of characters printed as strings are limited by "set
+     print characters" instead.  */
+  unsigned int print_max
+    = (c_textual_element_type (type->target_type (), options->format)
+       ? get_print_max_chars (options) : options->print_max);
+  if (print_max == UINT_MAX)
+    return false;
+
+  return type->length () / eltlen > print_max;
+}
+
 /* Print using the given LANGUAGE the value VAL onto stream STREAM according
    to OPTIONS.
 
@@ -1116,7 +1178,7 @@ common_val_print (struct value *value, struct ui_file *stream, int recurse,
        get a fixed representation of our value.  */
     value = ada_to_fixed_value (value);
 
-  if (value->lazy ())
+  if (value->lazy () && !val_print_array_lazily_p (value, options, language))
     value->fetch_lazy ();
 
   struct value_print_options local_opts = *options;
@@ -1205,7 +1267,13 @@ value_check_printable (struct value *val, struct ui_file *stream,
       return 0;
     }
 
-  if (val->entirely_optimized_out ())
+  /* Whether a value is optimized out or unavailable is only known
+     once it is read.  Arrays that are read as they are printed report
+     this for each element instead.  */
+  bool lazy_array = val_print_array_lazily_p (val, options,
+					      current_language);
+
+  if (!lazy_array && val->entirely_optimized_out ())
     {
       if (options->summary && !val_print_scalar_type_p (val->type ()))
 	gdb_printf (stream, "...");
@@ -1214,7 +1282,7 @@ value_check_printable (struct value *val, struct ui_file *stream,
       return 0;
     }
 
-  if (val->entirely_unavailable ())
+  if (!lazy_array && val->entirely_unavailable ())
     {
       if (options->summary && !val_print_scalar_type_p (val->type ()))
 	gdb_printf (stream, "...");
@@ -2004,6 +2072,82 @@ maybe_print_array_index (struct type *index_type, LONGEST index,
   current_language->print_array_index (index_type, index, stream, options);
 }
 
+/* When printing an array that was not fetched beforehand (see
+   val_print_array_lazily_p), value_print_array_elements reads it from
+   the target in windows of at most this many bytes.  */
+
+static const ULONGEST array_print_window_max = 64 * 1024;
+
+/* If the elements of an array of ELTTYPE can be printed according to
+   OPTIONS straight from the contents of the array, return the format
+   to print them with: 'd' or 'u' for signed or unsigned decimal, or
+   'x'.  Return 0 if each element has to be printed as a value.
+
+   This is the case for plain integers printed by c_value_print_int,
+   in the formats for which print_scalar_formatted only looks at the
+   bytes of the integer.  */
+
+static char
+array_scalar_format (struct type *elttype,
+		     const struct value_print_options *options)
+{
+  if (!c_like_array_language_p (current_language))
+    return 0;
+
+  struct type *type = check_typedef (elttype);
+  if (type->code () != TYPE_CODE_INT
+      || type->length () == 0
+      || type->length () > sizeof (ULONGEST)
+      || type->bit_size_differs_p ())
+    return 0;
+
+  char format = options->format ? options->format : options->output_format;
+  if (c_textual_element_type (elttype, format))
+    return 0;
+
+  switch (format)
+    {
+    case 0:
+      return type->is_unsigned () ? 'u' : 'd';
+    case 'd':
+    case 'u':
+    case 'x':
+      return format;
+    default:
+      return 0;
+    }
+}
+
+/* Print the integer of LEN bytes at VALADDR to STREAM in FORMAT, as
+   returned by array_scalar_format.  The output is the same as that of
+   print_scalar_formatted.  */
+
+static void
+print_array_scalar (struct ui_file *stream, const gdb_byte *valaddr,
+		    int len, enum bfd_endian byte_order, char format)
+{
+  switch (format)
+    {
+    case 'd':
+      gdb_puts (plongest (extract_signed_integer (valaddr, len, byte_order)),
+		stream);
+      break;
+    case 'u':
+      gdb_puts (pulongest (extract_unsigned_integer (valaddr, len,
+						     byte_order)),
+		stream);
+      break;
+    case 'x':
+      gdb_puts ("0x", stream);
+      gdb_puts (phex_nz (extract_unsigned_integer (valaddr, len, byte_order),
+			 len),
+		stream);
+      break;
+    default:
+      gdb_assert_not_reached ("unexpected array element format");
+    }
+}
+
 /* See valprint.h.  */
 
 void
@@ -2051,6 +2195,98 @@ value_print_array_elements (struct value *val, struct ui_file *stream,
       len = 0;
     }
 
+  /* If VAL has not been fetched, read consecutive elements with a
+     single memory access.  The first window covers what can still be
+     printed, plus one element to look for repeats; the following ones
+     are only needed to count long runs of repeated elements, and grow
+     geometrically.  */
+  value_ref_ptr window;
+  unsigned int window_start = 0;
+  unsigned int window_len = 0;
+  ULONGEST window_bytes = 0;
+
+  /* Make sure the window contains element IDX.  */
+  auto load_window = [&] (unsigned int idx)
+    {
+      if (window != nullptr
+	  && idx >= window_start
+	  && idx < window_start + window_len)
+	return;
+
+      ULONGEST eltlen = bit_stride / TARGET_CHAR_BIT;
+      ULONGEST budget = (options->print_max > things_printed
+			 ? options->print_max - things_printed : 0);
+
+      window_bytes = std::max ((budget + 1) * eltlen, 2 * window_bytes);
+      window_bytes = std::min (window_bytes, array_print_window_max);
+      window_start = idx;
+      window_len = std::max<ULONGEST> (window_bytes / eltlen, 1);
+      window_len = std::min (window_len, len - idx);
+
+      struct type *window_type
+	= lookup_array_range_type (elttype, 0, window_len - 1);
+      window = value_ref_ptr::new_reference
+	(value_from_component (val, window_type,
+			       (LONGEST) window_start * eltlen));
+      window->fetch_lazy ();
+    };
+
+  auto element_at = [&] (unsigned int idx) -> struct value *
+    {
+      if (!val->lazy ())
+	return val->from_component_bitsize (elttype, bit_stride * idx,
+					    bit_stride);
+
+      load_window (idx);
+      return window->from_component_bitsize (elttype,
+					     (bit_stride
+					      * (idx - window_start)),
+					     bit_stride);
+    };
+
+  /* Arrays of plain integers are printed straight from their
+     contents, without creating a value for each element, and runs of
+     repeated elements are found by comparing the contents in bulk.
+     This needs all the elements in VAL, or in the current window, to
+     be available.  */
+  char scalar_format = 0;
+  int eltlen = bit_stride / TARGET_CHAR_BIT;
+  if (bit_stride % TARGET_CHAR_BIT == 0
+      && eltlen == check_typedef (elttype)->length ())
+    scalar_format = array_scalar_format (elttype, options);
+  enum bfd_endian byte_order = type_byte_order (elttype);
+
+  /* Return a pointer to the contents of element IDX, and store in
+     *COUNT the number of elements that follow it in the same buffer,
+     including itself.  Return nullptr if not all of those are
+     available.  */
+  auto element_contents = [&] (unsigned int idx, unsigned int *count)
+    -> const gdb_byte *
+    {
+      struct value *whole = val;
+      unsigned int start = 0;
+      unsigned int num = len;
+
+      if (val->lazy ())
+	{
+	  load_window (idx);
+	  whole = window.get ();
+	  start = window_start;
+	  num = window_len;
+	}
+
+      LONGEST offset = whole->embedded_offset () + (LONGEST) start * eltlen;
+      LONGEST length = (LONGEST) num * eltlen;
+      if (!whole->bytes_available (offset, length)
+	  || whole->bits_any_optimized_out (offset * TARGET_CHAR_BIT,
+					    length * TARGET_CHAR_BIT))
+	return nullptr;
+
+      *count = start + num - idx;
+      return (whole->contents_for_printing ().data () + offset
+	      + (LONGEST) (idx - start) * eltlen);
+    };
+
   annotate_array_section_begin (i, elttype);
 
   for (; i < len && things_printed < options->print_max; i++)
@@ -2076,14 +2312,56 @@ value_print_array_elements (struct value *val, struct ui_file *stream,
       maybe_print_array_index (index_type, i + low_bound,
 			       stream, options);
 
-      struct value *element = val->from_component_bitsize (elttype,
-							   bit_stride * i,
-							   bit_stride);
+      /* The contents of element I, if it is printed directly.  */
+      gdb_byte scalar[sizeof (ULONGEST)];
+      bool print_scalar = false;
+      unsigned int count;
+
+      if (scalar_format != 0)
+	{
+	  const gdb_byte *contents = element_contents (i, &count);
+	  if (contents != nullptr)
+	    {
+	      memcpy (scalar, contents, eltlen);
+	      print_scalar = true;
+	    }
+	}
+
+      struct value *element = print_scalar ? nullptr : element_at (i);
       rep1 = i + 1;
       reps = 1;
+
+      /* Count the repeats of a scalar by comparing contents, for as
+	 long as they are available.  */
+      bool scan_values = options->repeat_count_threshold < UINT_MAX;
+      if (scan_values && print_scalar)
+	{
+	  while (rep1 < len)
+	    {
+	      const gdb_byte *contents = element_contents (rep1, &count);
+	      if (contents == nullptr)
+		break;
+
+	      size_t n = count_repeated_units (scalar, eltlen,
+					       contents, count);
+	      reps += n;
+	      rep1 += n;
+	      if (n < count)
+		{
+		  scan_values = false;
+		  break;
+		}
+	    }
+
+	  if (rep1 == len)
+	    scan_values = false;
+	  else if (scan_values)
+	    element = element_at (i);
+	}
+
       /* Only check for reps if repeat_count_threshold is not set to
 	 UINT_MAX (unlimited).  */
-      if (options->repeat_count_threshold < UINT_MAX)
+      if (scan_values)
 	{
 	  bool unavailable = element->entirely_unavailable ();
 	  bool available = element->entirely_available ();
@@ -2094,10 +2372,7 @@ value_print_array_elements (struct value *val, struct ui_file *stream,
 		 clean up temporary values asap to prevent allocating a large
 		 amount of them.  */
 	      scoped_value_mark free_values_inner;
-	      struct value *rep_elt
-		= val->from_component_bitsize (elttype,
-					       rep1 * bit_stride,
-					       bit_stride);
+	      struct value *rep_elt = element_at (rep1);
 	      bool repeated = ((available
 				&& rep_elt->entirely_available ()
 				&& element->contents_eq (rep_elt))
@@ -2110,8 +2385,28 @@ value_print_array_elements (struct value *val, struct ui_file *stream,
 	    }
 	}
 
-      common_val_print (element, stream, recurse + 1, options,
-			current_language);
+      /* A pretty-printer lookup function may accept only some values
+	 of a type, so each element is offered to the extension
+	 languages, as common_val_print would.  */
+      bool printed = false;
+      if (print_scalar && !options->raw)
+	printed = apply_ext_lang_val_pretty_printer (element != nullptr
+						     ? element
+						     : element_at (i),
+						     stream, recurse + 1,
+						     options,
+						     current_language);
+
+      if (printed)
+	{
+	  /* An extension language printed the element.  */
+	}
+      else if (print_scalar)
+	print_array_scalar (stream, scalar, eltlen, byte_order,
+			    scalar_format);
+      else
+	common_val_print (element, stream, recurse + 1, options,
+			  current_language);
 
       if (reps > options->repeat_count_threshold)
 	{
@@ -2382,6 +2677,15 @@ count_next_character (wchar_iterator *iter,
       struct converted_character d;
       int repeat;
 
+      /* Skip over a run of identical input bytes that convert to
+	 identical characters without converting each one.  */
+      if (current->result == wchar_iterate_ok
+	  || current->result == wchar_iterate_invalid)
+	current->repeat_count += iter->skip_repeats (current->buf,
+						     current->buflen,
+						     current->chars,
+						     current->num_chars);
+
       d.repeat_count = 0;
 
       while (1)
@@ -2700,6 +3004,38 @@ generic_printstr (struct ui_file *stream, struct type *type,
   gdb_puts ((const char *) obstack_base (&output), stream);
 }
 
+/* See valprint.h.  */
+
+bool
+generic_printstr_prefix_p (struct type *type, const gdb_byte *string,
+			   unsigned int length, const char *encoding,
+			   const struct value_print_options *options)
+{
+  int width = type->length ();
+  wchar_iterator iter (string, length * width, encoding, width);
+  std::vector<converted_character> converted_chars;
+
+  /* Go through the characters as generic_printstr does.  */
+  unsigned int i = 0;
+  unsigned int print_max_chars = get_print_max_chars (options);
+  while (i < print_max_chars)
+    {
+      int r = count_next_character (&iter, &converted_chars);
+
+      /* The prefix ended before printing did.  */
+      if (r < 0)
+	return false;
+
+      i += r;
+    }
+
+  /* The last element is the character after the last run printed.
+     If it is complete, that run was counted in full.  */
+  const converted_character &next = converted_chars.back ();
+  return (next.result == wchar_iterate_ok
+	  || next.result == wchar_iterate_invalid);
+}
+
 /* Print a string from the inferior, starting at ADDR and printing up to LEN
    characters, of WIDTH bytes a piece, to STREAM.  If LEN is -1, printing
    stops at the first null byte, otherwise printing proceeds (including null
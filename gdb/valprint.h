@@ -266,6 +266,17 @@ extern void generic_printstr (struct ui_file *stream, struct type *type,
 			      int quote_char, int c_style_terminator,
 			      const struct value_print_options *options);
 
+/* Return true if printing the first LENGTH characters of STRING with
+   generic_printstr prints the same as printing a longer string that
+   starts with them would, apart from the ellipsis.  TYPE and ENCODING
+   are as for generic_printstr.  */
+
+extern bool generic_printstr_prefix_p (struct type *type,
+				       const gdb_byte *string,
+				       unsigned int length,
+				       const char *encoding,
+				       const struct value_print_options *options);
+
 /* Run the "output" command.  ARGS and FROM_TTY are the usual
    arguments passed to all command implementations, except ARGS is
    const.  */
@@ -320,6 +331,17 @@ extern int build_address_symbolic (struct gdbarch *,
 				   int *line,
 				   int *unmapped);
 
+/* Return true if VAL, to be printed according to OPTIONS using
+   LANGUAGE, is an array in target memory that has more elements than
+   will be printed.  Such arrays are not fetched as a whole before
+   being printed; instead value_print_array_elements reads the
+   elements as it prints them, so that only the part of the array
+   that is displayed is transferred from the target.  */
+
+extern bool val_print_array_lazily_p (struct value *val,
+				      const struct value_print_options *options,
+				      const struct language_defn *language);
+
 /* Check to see if RECURSE is greater than or equal to the allowed
    printing max-depth (see 'set print max-depth').  If it is then print an
    ellipsis expression to STREAM and return true, otherwise return false.
@@ -1011,10 +1011,12 @@ value::allocate_register (const frame_info_ptr &next_frame, int regnum,
 }
 
 /* Allocate a  value  that has the correct length
-   for COUNT repetitions of type TYPE.  */
+   for COUNT repetitions of type TYPE.  If LAZY, the contents are not
+   allocated, and the caller must give the value a location to fetch
+   them from.  */
 
 struct value *
-allocate_repeat_value (struct type *type, int count)
+allocate_repeat_value (struct type *type, int count, bool lazy)
 {
   /* Despite the fact that we are really creating an array of TYPE here, we
      use the string lower bound as the array lower bound.  This seems to
@@ -1025,6 +1027,8 @@ allocate_repeat_value (struct type *type, int count)
   struct type *array_type
     = lookup_array_range_type (type, low_bound, count + low_bound - 1);
 
+  if (lazy)
+    return value::allocate_lazy (array_type);
   return value::allocate (array_type);
 }
 
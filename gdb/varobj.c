@@ -32,6 +32,7 @@
 #include "gdbarch.h"
 #include <algorithm>
 #include "observable.h"
+#include "target-dcache.h"
 
 #if HAVE_PYTHON
 #include "python/python.h"
@@ -57,6 +58,14 @@ const char *varobj_format_string[] =
 /* True if we want to allow Python-based pretty-printing.  */
 static bool pretty_printing = false;
 
+/* If true, -var-update skips root varobjs whose memory footprint was
+   not written to since they were last updated.  */
+static bool varobj_track_footprints = true;
+
+/* The most ranges a footprint may have; varobjs that read more memory
+   than this are always updated.  */
+static constexpr size_t max_footprint_ranges = 64;
+
 void
 varobj_enable_pretty_printing (void)
 {
@@ -110,6 +119,21 @@ struct varobj_root
 
   /* The varobj for this root node.  */
   struct varobj *rootvar = NULL;
+
+  /* True if FOOTPRINT holds all the target memory that the last update
+     of this varobj and its children read, in which case the update
+     need not be redone until some of that memory may have changed.  */
+  bool footprint_valid = false;
+
+  /* The value of target_dcache_generation when the footprint was
+     recorded.  */
+  ULONGEST footprint_generation = 0;
+
+  /* The inferior whose memory FOOTPRINT describes.  */
+  inferior *footprint_inf = nullptr;
+
+  /* The memory read by the last update, sorted and merged.  */
+  std::vector<mem_range> footprint;
 };
 
 /* Dynamic part of varobj.  */
@@ -209,6 +233,28 @@ is_root_p (const struct varobj *var)
   return (var->root->rootvar == var);
 }
 
+/* Forget the memory footprint of the varobj tree VAR is part of, so
+   that the next update re-evaluates it.  */
+
+static void
+invalidate_footprint (struct varobj *var)
+{
+  var->root->footprint_valid = false;
+  var->root->footprint.clear ();
+}
+
+/* Forget the memory footprints of all varobjs.  */
+
+static void
+invalidate_all_footprints ()
+{
+  for (varobj_root *root : rootlist)
+    {
+      root->footprint_valid = false;
+      root->footprint.clear ();
+    }
+}
+
 #ifdef HAVE_PYTHON
 
 /* See python-internal.h.  */
@@ -554,6 +600,7 @@ varobj_set_frozen (struct varobj *var, bool frozen)
      should do -var-update anyway.  It would be bad to have different
      client-size logic for structure and other types.  */
   var->frozen = frozen;
+  invalidate_footprint (var);
 }
 
 bool
@@ -1385,6 +1432,7 @@ varobj_set_visualizer (struct varobj *var, const char *visualizer)
     }
 
   construct_visualizer (var, constructor.get ());
+  invalidate_footprint (var);
 
   /* If there are any children now, wipe them.  */
   varobj_delete (var, 1 /* children only */);
@@ -1445,8 +1493,8 @@ varobj_value_has_mutated (const struct varobj *var, struct value *new_value,
    returns TYPE_CHANGED, then it has done this and VARP will be modified
    to point to the new varobj.  */
 
-std::vector<varobj_update_result>
-varobj_update (struct varobj **varp, bool is_explicit)
+static std::vector<varobj_update_result>
+varobj_update_1 (struct varobj **varp, bool is_explicit)
 {
   bool type_changed = false;
   struct value *newobj;
@@ -1649,6 +1697,134 @@ varobj_update (struct varobj **varp, bool is_explicit)
   return result;
 }
 
+/* Return true if whether the varobj VAR and its children changed only
+   depends on the target memory they read.  That isn't so of varobjs
+   that use a pretty-printer, which may do anything.  */
+
+static bool
+footprint_trackable_p (const struct varobj *var)
+{
+  if (varobj_is_dynamic_p (var))
+    return false;
+
+  for (const varobj *child : var->children)
+    if (child != nullptr && !footprint_trackable_p (child))
+      return false;
+
+  return true;
+}
+
+/* Return true if the memory footprint of ROOT is valid, and none of
+   that memory may have changed since it was recorded.  */
+
+static bool
+footprint_unchanged_p (const varobj_root *root)
+{
+  if (!root->footprint_valid
+      || root->footprint_inf != current_inferior ())
+    return false;
+
+  /* Running threads may write anywhere.  */
+  for (thread_info *tp : root->footprint_inf->non_exited_threads ())
+    if (tp->executing ())
+      return false;
+
+  bool written = false;
+  auto check_write = [&] (CORE_ADDR addr, ULONGEST len)
+    {
+      for (const mem_range &r : root->footprint)
+	if (addr < r.start + r.length && r.start < addr + len)
+	  written = true;
+    };
+
+  return (target_dcache_writes_since (root->footprint_generation,
+				      check_write)
+	  && !written);
+}
+
+/* Update the varobj *VARP and its children, like varobj_update_1, but
+   skip root varobjs none of whose memory may have changed since their
+   last update.  */
+
+std::vector<varobj_update_result>
+varobj_update (struct varobj **varp, bool is_explicit)
+{
+  struct varobj *var = *varp;
+
+  if (!varobj_track_footprints
+      || !is_root_p (var)
+      || !var->root->is_valid
+      || (!is_explicit && var->frozen))
+    return varobj_update_1 (varp, is_explicit);
+
+  /* None of the memory that the varobj read last time changed, so
+     neither did its value nor its children's.  */
+  if (footprint_unchanged_p (var->root))
+    return {};
+
+  invalidate_footprint (var);
+
+  ULONGEST generation = target_dcache_generation ();
+  inferior *inf = current_inferior ();
+  scoped_memory_read_recorder recorder;
+
+  std::vector<varobj_update_result> result
+    = varobj_update_1 (varp, is_explicit);
+
+  /* The footprint is only useful if the update read target memory and
+     nothing else that may change without the inferior running: not
+     convenience variables, not registers of another inferior's thread,
+     not the current frame.  Also, evaluating the expression must not
+     have called a function in the inferior.  */
+  varobj_root *root = (*varp)->root;
+  if (target_dcache_generation () != generation
+      || current_inferior () != inf
+      || !root->is_valid
+      || root->floating
+      || (*varp)->name.find ('$') != std::string::npos
+      || !footprint_trackable_p (*varp))
+    return result;
+
+  if (root->valid_block != nullptr && root->thread_id != 0)
+    {
+      thread_info *tp = find_thread_global_id (root->thread_id);
+
+      if (tp == nullptr || tp->inf != inf)
+	return result;
+    }
+
+  std::vector<mem_range> footprint = recorder.ranges ();
+  if (footprint.size () > max_footprint_ranges)
+    return result;
+
+  root->footprint = std::move (footprint);
+  root->footprint_generation = generation;
+  root->footprint_inf = inf;
+  root->footprint_valid = true;
+
+  return result;
+}
+
+/* See varobj.h.  */
+
+std::vector<mem_range>
+varobj_stale_footprints ()
+{
+  std::vector<mem_range> ranges;
+
+  if (!varobj_track_footprints)
+    return ranges;
+
+  for (const varobj_root *root : rootlist)
+    if (root->footprint_valid
+	&& root->footprint_inf == current_inferior ()
+	&& !footprint_unchanged_p (root))
+      ranges.insert (ranges.end (), root->footprint.begin (),
+		     root->footprint.end ());
+
+  return ranges;
+}
+
 /* Helper functions */
 
 /*
@@ -1772,6 +1948,9 @@ create_child_with_value (struct varobj *parent, int index,
 {
   varobj *child = new varobj (parent->root);
 
+  /* The new child's memory is not part of the footprint yet.  */
+  invalidate_footprint (parent);
+
   /* NAME is allocated by caller.  */
   std::swap (child->name, item->name);
   child->index = index;
@@ -2366,6 +2545,8 @@ varobj_invalidate_if_uses_objfile (struct objfile *objfile)
 
   all_root_varobjs ([objfile] (struct varobj *var)
     {
+      invalidate_footprint (var);
+
       if (var->root->valid_block != nullptr)
 	{
 	  struct objfile *bl_objfile = var->root->valid_block->objfile ();
@@ -2439,6 +2620,24 @@ _initialize_varobj ()
 			     NULL, show_varobjdebug,
 			     &setdebuglist, &showdebuglist);
 
+  add_setshow_boolean_cmd ("varobj-footprints", class_maintenance,
+			   &varobj_track_footprints, _("\
+Set whether -var-update skips varobjs whose memory is unchanged."), _("\
+Show whether -var-update skips varobjs whose memory is unchanged."), _("\
+When on, GDB records the target memory read when updating each root\n\
+variable object, and -var-update does not re-evaluate a variable object\n\
+until some of that memory may have been written, either by GDB or by the\n\
+inferior running."),
+			   NULL, NULL,
+			   &maintenance_set_cmdlist, &maintenance_show_cmdlist);
+
   gdb::observers::free_objfile.attach (varobj_invalidate_if_uses_objfile,
 				       "varobj");
+  gdb::observers::new_objfile.attach
+    ([] (struct objfile *) { invalidate_all_footprints (); }, "varobj");
+  gdb::observers::register_changed.attach
+    ([] (const frame_info_ptr &, int) { invalidate_all_footprints (); },
+     "varobj");
+  gdb::observers::setting_changed.attach (invalidate_all_footprints,
+					  "varobj");
 }
@@ -20,6 +20,7 @@
 #include "symtab.h"
 #include "gdbtypes.h"
 #include "value.h"
+#include "memrange.h"
 
 /* Enumeration for the format types */
 enum varobj_display_formats
@@ -314,6 +315,13 @@ extern void all_root_varobjs (gdb::function_view<void (struct varobj *var)>);
 extern std::vector<varobj_update_result>
   varobj_update (struct varobj **varp, bool is_explicit);
 
+/* Return the target memory last read by the root varobjs of the
+   current inferior that the next -var-update will have to evaluate
+   again because that memory may have changed.  Reading it all ahead
+   of time, with few large reads, makes that faster.  */
+
+extern std::vector<mem_range> varobj_stale_footprints ();
+
 /* Try to recreate any global or floating varobj.  This is called after
    changing symbol files.  */
 
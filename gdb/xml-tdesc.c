@@ -25,6 +25,10 @@
 #include "xml-tdesc.h"
 #include "osabi.h"
 #include "filenames.h"
+#include "gdbsupport/filestuff.h"
+#include "gdbsupport/gdb_unlinker.h"
+#include "gdbsupport/pathstuff.h"
+#include "gdbsupport/scoped_fd.h"
 #include "gdbsupport/unordered_map.h"
 #include <string>
 
@@ -40,7 +44,8 @@
    an XML parser.  */
 
 static struct target_desc *
-tdesc_parse_xml (const char *document, xml_fetch_another fetcher)
+tdesc_parse_xml (const char *document, xml_fetch_another fetcher,
+		 std::string *expanded_text_out = nullptr)
 {
   static int have_warned;
 
@@ -612,10 +617,13 @@ static const struct gdb_xml_element tdesc_elements[] = {
   { NULL, NULL, NULL, GDB_XML_EF_NONE, NULL, NULL }
 };
 
-/* Parse DOCUMENT into a target description and return it.  */
+/* Parse DOCUMENT into a target description and return it.  If
+   EXPANDED_TEXT_OUT is not NULL, set it to the text of DOCUMENT with
+   all its includes expanded.  */
 
 static struct target_desc *
-tdesc_parse_xml (const char *document, xml_fetch_another fetcher)
+tdesc_parse_xml (const char *document, xml_fetch_another fetcher,
+		 std::string *expanded_text_out = nullptr)
 {
   struct tdesc_parsing_data data;
 
@@ -630,6 +638,9 @@ tdesc_parse_xml (const char *document, xml_fetch_another fetcher)
       return NULL;
     }
 
+  if (expanded_text_out != nullptr)
+    *expanded_text_out = expanded_text;
+
   /* Check for an exact match in the list of descriptions we have
      previously parsed.  */
   const auto it = xml_cache.find (expanded_text);
@@ -697,12 +708,132 @@ fetch_available_features_from_target (const char *name, target_ops *ops)
 }
 
 
+/* See xml-tdesc.h.  */
+
+bool tdesc_cache_enabled = true;
+
+/* See xml-tdesc.h.  */
+
+std::string tdesc_cache_directory;
+
+/* The descriptions read from targets that reported a hash for them,
+   indexed by that hash.  Like the descriptions in xml_cache, these
+   are never discarded.  */
+
+static gdb::unordered_map<std::string, const target_desc *> tdesc_hash_cache;
+
+/* Return the name of the file holding the description with hash HASH
+   in the cache directory, or an empty string if there is no cache
+   directory.  */
+
+static std::string
+tdesc_cache_file_name (const std::string &hash)
+{
+  if (tdesc_cache_directory.empty ())
+    return {};
+
+  return tdesc_cache_directory + SLASH_STRING + hash + ".xml";
+}
+
+/* Return the description with hash HASH from the cache directory, or
+   NULL if it isn't there.  */
+
+static const target_desc *
+tdesc_cache_read_file (const std::string &hash)
+{
+  std::string filename = tdesc_cache_file_name (hash);
+  if (filename.empty ())
+    return nullptr;
+
+  std::optional<gdb::char_vector> text
+    = xml_fetch_content_from_file (filename.c_str (), nullptr);
+  if (!text)
+    return nullptr;
+
+  /* The cached text has its includes expanded already.  */
+  return tdesc_parse_xml (text->data (), [] (const char *href)
+    {
+      return std::optional<gdb::char_vector> ();
+    });
+}
+
+/* Save TEXT, the expanded text of the description with hash HASH, in
+   the cache directory.  The file is written under a temporary name
+   and then renamed, so that other sessions sharing the directory
+   never see a partial file.  */
+
+static void
+tdesc_cache_write_file (const std::string &hash, const std::string &text)
+{
+  std::string filename = tdesc_cache_file_name (hash);
+  if (filename.empty ())
+    return;
+
+  try
+    {
+      if (!mkdir_recursive (tdesc_cache_directory.c_str ()))
+	perror_with_name (tdesc_cache_directory.c_str ());
+
+      gdb::char_vector temp_name = make_temp_filename (filename);
+
+      /* As in index-write.c, the file must be closed before it is
+	 unlinked, for MS-Windows.  */
+      std::optional<gdb::unlinker> unlink_file;
+      {
+	scoped_fd fd (gdb_mkostemp_cloexec (temp_name.data (), O_BINARY));
+	if (fd.get () == -1)
+	  perror_with_name (temp_name.data ());
+	unlink_file.emplace (temp_name.data ());
+
+	const char *p = text.data ();
+	size_t left = text.size ();
+	while (left > 0)
+	  {
+	    ssize_t n = write (fd.get (), p, left);
+	    if (n < 0)
+	      perror_with_name (temp_name.data ());
+	    p += n;
+	    left -= n;
+	  }
+      }
+
+      if (rename (temp_name.data (), filename.c_str ()) != 0)
+	perror_with_name (filename.c_str ());
+      unlink_file->keep ();
+    }
+  catch (const gdb_exception_error &ex)
+    {
+      warning (_("Could not save the target description in the cache: %s"),
+	       ex.what ());
+    }
+}
+
 /* Read an XML target description using OPS.  Parse it, and return the
    parsed description.  */
 
 const struct target_desc *
 target_read_description_xml (struct target_ops *ops)
 {
+  /* If the target can tell which description it has, we may have
+     read it before.  */
+  std::string hash;
+  if (tdesc_cache_enabled)
+    hash = ops->read_description_hash ();
+
+  if (!hash.empty ())
+    {
+      auto it = tdesc_hash_cache.find (hash);
+      if (it != tdesc_hash_cache.end ())
+	return it->second;
+
+      const target_desc *tdesc = tdesc_cache_read_file (hash);
+      if (tdesc != nullptr)
+	{
+	  tdesc_hash_cache.emplace (hash, tdesc);
+	  return tdesc;
+	}
+    }
+
   std::optional<gdb::char_vector> tdesc_str
     = fetch_available_features_from_target ("target.xml", ops);
   if (!tdesc_str)
@@ -713,7 +844,19 @@ target_read_description_xml (struct target_ops *ops)
       return fetch_available_features_from_target (name, ops);
     };
 
-  return tdesc_parse_xml (tdesc_str->data (), fetch_another);
+  if (hash.empty ())
+    return tdesc_parse_xml (tdesc_str->data (), fetch_another);
+
+  std::string expanded_text;
+  const target_desc *tdesc
+    = tdesc_parse_xml (tdesc_str->data (), fetch_another, &expanded_text);
+  if (tdesc != nullptr)
+    {
+      tdesc_hash_cache.emplace (hash, tdesc);
+      tdesc_cache_write_file (hash, expanded_text);
+    }
+
+  return tdesc;
 }
 
 /* Fetches an XML target description using OPS,  processing
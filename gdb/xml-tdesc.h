@@ -34,10 +34,24 @@ struct target_desc;
 const struct target_desc *file_read_description_xml (const char *filename);
 
 /* Read an XML target description using OPS.  Parse it, and return the
-   parsed description.  */
+   parsed description.  If OPS reports a hash for its description, and
+   a description with that hash was read before, in this session or,
+   through the cache directory, in an earlier one, return it without
+   reading the XML again.  */
 
 const struct target_desc *target_read_description_xml (struct target_ops *);
 
+/* Whether target descriptions are looked up by the hash the target
+   reports, for "set/show tdesc cache".  */
+
+extern bool tdesc_cache_enabled;
+
+/* The directory where descriptions that have a hash are saved, for
+   "set/show tdesc cache-directory".  If empty, they are only kept in
+   memory.  */
+
+extern std::string tdesc_cache_directory;
+
 /* Fetches an XML target description using OPS, processing includes,
    but not parsing it.  Used to dump whole tdesc as a single XML file.
    Returns the description on success, and a disengaged optional
@@ -1461,5 +1461,7 @@ void
 _initialize_z80_tdep ()
 {
   gdbarch_register (bfd_arch_z80, z80_gdbarch_init);
-  initialize_tdesc_z80 ();
+
+  /* Create the target description the first time it is needed.  */
+  gdbarch_register_lazy_init (bfd_arch_z80, initialize_tdesc_z80);
 }
@@ -58,6 +58,9 @@
 #include "gdbsupport/rsp-low.h"
 
 #include "getopt.h"
+#include <chrono>
+#include <thread>
+#include <vector>
 
 #ifndef HAVE_SOCKLEN_T
 typedef int socklen_t;
@@ -72,6 +75,56 @@ static int remote_desc_out;
    gdbreplay.  */
 bool debug_logging = false;
 
+/* The emulated link between GDB and the target.  Each reply is held
+   back until LINK_LATENCY has passed since the link was last used,
+   plus, if LINK_BANDWIDTH is not zero, the time needed to transfer
+   the request and the reply at LINK_BANDWIDTH bytes per second.  */
+static std::chrono::microseconds link_latency;
+static unsigned long link_bandwidth;
+
+/* When the link was last used, and the number of bytes GDB sent over
+   it since the last reply.  */
+static std::chrono::steady_clock::time_point link_idle_since;
+static size_t link_pending_bytes;
+
+/* What the session exchanged while GDB executed one command, as
+   logged by GDB.  */
+
+struct replay_command
+{
+  /* The command, or an empty string for the exchanges that happened
+     before GDB logged any command, typically while connecting.  */
+  std::string command;
+
+  /* The time from the end of the previous command's last exchange to
+     the end of this command's last one.  */
+  std::chrono::steady_clock::duration time {};
+
+  /* The number of lines of the log GDB sent and received, and their
+     size.  */
+  size_t requests = 0;
+  size_t replies = 0;
+  size_t bytes_from_gdb = 0;
+  size_t bytes_to_gdb = 0;
+};
+
+/* The timing of the whole replay.  */
+
+struct replay_stats
+{
+  /* The time from GDB connecting to the end of the log.  */
+  std::chrono::steady_clock::duration time {};
+
+  /* The time spent waiting for GDB to send requests, and the time
+     replies were held back to emulate the link.  */
+  std::chrono::steady_clock::duration gdb_time {};
+  std::chrono::steady_clock::duration delay {};
+
+  std::vector<replay_command> commands;
+};
+
+static replay_stats stats;
+
 static void
 sync_error (FILE *fp, const char *desc, int expect, int got)
 {
@@ -370,13 +423,15 @@ gdbchar (int desc)
 }
 
 /* Accept input from gdb and match with chars from fp (after skipping one
-   blank) up until a \n is read from fp (which is not matched) */
+   blank) up until a \n is read from fp (which is not matched).  Return
+   the number of characters read from gdb.  */
 
-static void
+static size_t
 expect (FILE *fp)
 {
   int fromlog;
   int fromgdb;
+  size_t count = 0;
 
   if ((fromlog = logchar (fp, false)) != ' ')
     {
@@ -391,6 +446,7 @@ expect (FILE *fp)
       fromgdb = gdbchar (remote_desc_in);
       if (fromgdb < 0)
 	remote_error ("Error during read from gdb");
+      count++;
     }
   while (fromlog == fromgdb);
 
@@ -399,6 +455,34 @@ expect (FILE *fp)
       sync_error (fp, "Sync error during read of gdb packet from log", fromlog,
 		  fromgdb);
     }
+
+  return count;
+}
+
+/* Wait until a reply of REPLY_SIZE bytes would have reached GDB over
+   the emulated link.  */
+
+static void
+emulate_link (size_t reply_size)
+{
+  using namespace std::chrono;
+
+  if (link_latency.count () == 0 && link_bandwidth == 0)
+    return;
+
+  steady_clock::time_point deadline = link_idle_since + link_latency;
+  if (link_bandwidth != 0)
+    {
+      uint64_t bytes = link_pending_bytes + reply_size;
+      deadline += microseconds (bytes * 1000000 / link_bandwidth);
+    }
+
+  steady_clock::time_point now = steady_clock::now ();
+  if (deadline > now)
+    {
+      std::this_thread::sleep_until (deadline);
+      stats.delay += deadline - now;
+    }
 }
 
 /* Calculate checksum for the packet stored in buffer buf.  Store
@@ -417,9 +501,10 @@ recalculate_csum (const std::string &buf, int off, unsigned char *checksum_hex)
 }
 
 /* Play data back to gdb from fp (after skipping leading blank) up until a
-   \n is read from fp (which is discarded and not sent to gdb). */
+   \n is read from fp (which is discarded and not sent to gdb).  Return
+   the number of characters sent to gdb.  */
 
-static void
+static size_t
 play (FILE *fp)
 {
   int fromlog;
@@ -454,8 +539,96 @@ play (FILE *fp)
   line.push_back (checksum[0]);
   line.push_back (checksum[1]);
 
+  emulate_link (line.size ());
+
   if (write (remote_desc_out, line.data (), line.size ()) != line.size ())
     remote_error ("Error during write to gdb");
+
+  return line.size ();
+}
+
+/* Append STR to OUT as a JSON string.  */
+
+static void
+append_json_string (std::string &out, const std::string &str)
+{
+  out += '"';
+  for (unsigned char c : str)
+    {
+      if (c == '"' || c == '\\')
+	{
+	  out += '\\';
+	  out += c;
+	}
+      else if (c < 0x20)
+	out += string_printf ("\\u%04x", c);
+      else
+	out += c;
+    }
+  out += '"';
+}
+
+/* Return D in microseconds.  */
+
+static long long
+to_usec (std::chrono::steady_clock::duration d)
+{
+  return std::chrono::duration_cast<std::chrono::microseconds> (d).count ();
+}
+
+/* Write the timing of the replay of LOGFILE to the file FILENAME, as a
+   JSON object.  */
+
+static void
+write_results (const char *filename, const char *logfile)
+{
+  size_t requests = 0, replies = 0;
+  size_t bytes_from_gdb = 0, bytes_to_gdb = 0;
+  std::string commands;
+
+  for (const replay_command &cmd : stats.commands)
+    {
+      requests += cmd.requests;
+      replies += cmd.replies;
+      bytes_from_gdb += cmd.bytes_from_gdb;
+      bytes_to_gdb += cmd.bytes_to_gdb;
+
+      if (!commands.empty ())
+	commands += ",";
+      commands += "\n    {\"command\": ";
+      append_json_string (commands, cmd.command);
+      commands += string_printf (", \"time_us\": %lld, \"requests\": %zu, "
+				 "\"replies\": %zu, \"bytes_from_gdb\": %zu, "
+				 "\"bytes_to_gdb\": %zu}",
+				 to_usec (cmd.time), cmd.requests, cmd.replies,
+				 cmd.bytes_from_gdb, cmd.bytes_to_gdb);
+    }
+
+  std::string out = "{\n  \"logfile\": ";
+  append_json_string (out, logfile);
+  out += string_printf (",\n  \"latency_us\": %lld,\n"
+			"  \"bandwidth\": %lu,\n"
+			"  \"time_us\": %lld,\n"
+			"  \"gdb_time_us\": %lld,\n"
+			"  \"delay_us\": %lld,\n"
+			"  \"requests\": %zu,\n"
+			"  \"replies\": %zu,\n"
+			"  \"bytes_from_gdb\": %zu,\n"
+			"  \"bytes_to_gdb\": %zu,\n"
+			"  \"commands\": [",
+			(long long) link_latency.count (), link_bandwidth,
+			to_usec (stats.time), to_usec (stats.gdb_time),
+			to_usec (stats.delay), requests, replies,
+			bytes_from_gdb, bytes_to_gdb);
+  out += commands;
+  out += "\n  ]\n}\n";
+
+  FILE *fp = fopen (filename, "w");
+  if (fp == NULL)
+    perror_with_name (filename);
+  if (fwrite (out.data (), 1, out.size (), fp) != out.size ()
+      || fclose (fp) != 0)
+    perror_with_name (filename);
 }
 
 static void
@@ -489,6 +662,13 @@ gdbreplay_help ()
 
   printf ("Options:\n\n");
   printf ("  --debug-logging       Show packets as they are processed.\n");
+  printf ("  --latency=USEC        Delay each reply by USEC microseconds, to emulate\n"
+	  "                        the round-trip latency of a slow link.\n");
+  printf ("  --bandwidth=BYTES     Also delay each reply by the time needed to\n"
+	  "                        transfer the request and the reply at BYTES\n"
+	  "                        bytes per second.\n");
+  printf ("  --results=FILE        Write the time taken by the session, and by\n"
+	  "                        each command, to FILE as JSON.\n");
   printf ("  --help                Print this message and then exit.\n");
   printf ("  --version             Display version information and then exit.\n");
   if (REPORT_BUGS_TO[0])
@@ -506,12 +686,20 @@ captured_main (int argc, char *argv[])
 {
   FILE *fp;
   int ch, optc;
-  enum opts { OPT_VERSION = 1, OPT_HELP, OPT_LOGGING };
+  const char *results_file = nullptr;
+  enum opts
+    {
+      OPT_VERSION = 1, OPT_HELP, OPT_LOGGING, OPT_LATENCY, OPT_BANDWIDTH,
+      OPT_RESULTS
+    };
   static struct option longopts[] =
     {
 	{"version", no_argument, nullptr, OPT_VERSION},
 	{"help", no_argument, nullptr, OPT_HELP},
 	{"debug-logging", no_argument, nullptr, OPT_LOGGING},
+	{"latency", required_argument, nullptr, OPT_LATENCY},
+	{"bandwidth", required_argument, nullptr, OPT_BANDWIDTH},
+	{"results", required_argument, nullptr, OPT_RESULTS},
 	{nullptr, no_argument, nullptr, 0}
     };
 
@@ -528,6 +716,28 @@ captured_main (int argc, char *argv[])
 	case OPT_LOGGING:
 	  debug_logging = true;
 	  break;
+	case OPT_LATENCY:
+	case OPT_BANDWIDTH:
+	  {
+	    char *end;
+	    errno = 0;
+	    unsigned long value = strtoul (optarg, &end, 10);
+	    if (*optarg == '\0' || *optarg == '-' || *end != '\0'
+		|| errno != 0)
+	      {
+		fprintf (stderr, "Invalid value for --%s: '%s'\n",
+			 optc == OPT_LATENCY ? "latency" : "bandwidth", optarg);
+		exit (1);
+	      }
+	    if (optc == OPT_LATENCY)
+	      link_latency = std::chrono::microseconds (value);
+	    else
+	      link_bandwidth = value;
+	  }
+	  break;
+	case OPT_RESULTS:
+	  results_file = optarg;
+	  break;
 
 	case '?':
 	  fprintf (stderr,
@@ -547,26 +757,62 @@ captured_main (int argc, char *argv[])
       perror_with_name (argv[optind]);
     }
   remote_open (argv[optind + 1]);
+
+  using clock = std::chrono::steady_clock;
+  clock::time_point session_start = clock::now ();
+  clock::time_point command_start = session_start;
+  link_idle_since = session_start;
+  stats.commands.emplace_back ();
+
   while ((ch = logchar (fp, false)) != EOF)
     {
       switch (ch)
 	{
 	case 'w':
-	  /* data sent from gdb to gdbreplay, accept and match it */
-	  expect (fp);
+	  {
+	    /* data sent from gdb to gdbreplay, accept and match it */
+	    clock::time_point start = clock::now ();
+	    size_t count = expect (fp);
+	    link_idle_since = clock::now ();
+	    link_pending_bytes += count;
+	    stats.gdb_time += link_idle_since - start;
+	    stats.commands.back ().requests++;
+	    stats.commands.back ().bytes_from_gdb += count;
+	  }
 	  break;
 	case 'r':
-	  /* data sent from gdbreplay to gdb, play it */
-	  play (fp);
+	  {
+	    /* data sent from gdbreplay to gdb, play it */
+	    size_t count = play (fp);
+	    link_idle_since = clock::now ();
+	    link_pending_bytes = 0;
+	    stats.commands.back ().replies++;
+	    stats.commands.back ().bytes_to_gdb += count;
+	  }
 	  break;
 	case 'c':
-	  /* We want to always print the command executed by GDB.  */
-	  if (!debug_logging)
-	    {
-	      fprintf (stderr, "\n");
-	      fprintf (stderr, "Command expected from GDB:\n");
-	    }
-	  while ((ch = logchar (fp, true)) != EOL);
+	  {
+	    /* We want to always print the command executed by GDB.  */
+	    if (!debug_logging)
+	      {
+		fprintf (stderr, "\n");
+		fprintf (stderr, "Command expected from GDB:\n");
+	      }
+
+	    /* The previous command ended with its last exchange.  */
+	    if (link_idle_since > command_start)
+	      {
+		stats.commands.back ().time = link_idle_since - command_start;
+		command_start = link_idle_since;
+	      }
+
+	    replay_command cmd;
+	    if ((ch = logchar (fp, true)) == ' ')
+	      ch = logchar (fp, true);
+	    for (; ch != EOL && ch != EOF; ch = logchar (fp, true))
+	      cmd.command.push_back (ch);
+	    stats.commands.push_back (std::move (cmd));
+	  }
 	  break;
 	case 'E':
 	  if (!debug_logging)
@@ -575,7 +821,20 @@ captured_main (int argc, char *argv[])
 	  break;
 	}
     }
+
+  if (link_idle_since > command_start)
+    stats.commands.back ().time = link_idle_since - command_start;
+  stats.time = link_idle_since - session_start;
+
+  /* Drop the exchanges before the first command if there were
+     none.  */
+  if (stats.commands.front ().requests == 0
+      && stats.commands.front ().replies == 0)
+    stats.commands.erase (stats.commands.begin ());
+
   remote_close ();
+  if (results_file != nullptr)
+    write_results (results_file, argv[optind]);
   exit (0);
 }
 
@@ -87,6 +87,10 @@ struct thread_info : public intrusive_list_node<thread_info>
 
   /* Thread options GDB requested with QThreadOptions.  */
   gdb_thread_options thread_options = 0;
+
+  /* The XML element describing this thread in the last thread list
+     sent to GDB, used to notice when its attributes change.  */
+  std::string listed_description;
   
 private:
   process_info *m_process;
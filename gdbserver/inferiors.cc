@@ -23,6 +23,7 @@
 #include "gdbsupport/owning_intrusive_list.h"
 #include "gdbthread.h"
 #include "dll.h"
+#include <deque>
 
 owning_intrusive_list<process_info> all_processes;
 
@@ -38,6 +39,131 @@ thread_info *current_thread;
    Empty if not specified.  */
 static std::string current_inferior_cwd;
 
+/* See inferiors.h.  */
+
+ULONGEST thread_list_generation;
+
+/* The kinds of thread list changes.  */
+
+enum class thread_list_change_kind
+{
+  /* The thread was added.  */
+  added,
+
+  /* The thread was removed.  */
+  removed,
+
+  /* The thread's attributes changed.  */
+  changed,
+};
+
+/* A thread being added to or removed from a thread list, or having
+   its attributes changed.  */
+
+struct thread_list_change
+{
+  /* The generation this change created.  */
+  ULONGEST generation;
+
+  /* The thread's ptid.  */
+  ptid_t ptid;
+
+  thread_list_change_kind kind;
+};
+
+/* The most recent thread list changes, oldest first.  Only a bounded
+   number of changes is kept; a client asking for changes older than
+   that gets the full list.  */
+
+static std::deque<thread_list_change> thread_list_changes;
+
+/* The maximum length of THREAD_LIST_CHANGES.  */
+
+static const size_t max_thread_list_changes = 4096;
+
+/* Record a change of kind KIND to the thread PTID.  */
+
+static void
+record_thread_list_change (ptid_t ptid, thread_list_change_kind kind)
+{
+  ++thread_list_generation;
+
+  if (thread_list_changes.size () == max_thread_list_changes)
+    thread_list_changes.pop_front ();
+  thread_list_changes.push_back ({ thread_list_generation, ptid, kind });
+}
+
+/* See inferiors.h.  */
+
+void
+record_thread_attributes_change (thread_info *thread)
+{
+  record_thread_list_change (thread->id, thread_list_change_kind::changed);
+}
+
+/* See inferiors.h.  */
+
+bool
+thread_list_changes_since (ULONGEST since,
+			   std::vector<thread_info *> *listed,
+			   std::vector<ptid_t> *removed)
+{
+  if (since > thread_list_generation)
+    return false;
+
+  /* Generation SINCE must either be the current one, or the one just
+     before a change we still have.  */
+  if (since < thread_list_generation
+      && (thread_list_changes.empty ()
+	  || thread_list_changes.front ().generation > since + 1))
+    return false;
+
+  /* The net effect of the changes on each thread.  A thread added and
+     then removed again does not appear at all, and a thread added and
+     then changed counts as added.  */
+  gdb::unordered_map<ptid_t, thread_list_change_kind> net;
+  std::vector<ptid_t> order;
+
+  for (const thread_list_change &change : thread_list_changes)
+    {
+      if (change.generation <= since)
+	continue;
+
+      auto it = net.find (change.ptid);
+      if (it == net.end ())
+	{
+	  net.emplace (change.ptid, change.kind);
+	  order.push_back (change.ptid);
+	}
+      else if (it->second == thread_list_change_kind::added
+	       && change.kind == thread_list_change_kind::removed)
+	net.erase (it);
+      else if (it->second != thread_list_change_kind::added)
+	it->second = change.kind;
+    }
+
+  for (ptid_t ptid : order)
+    {
+      auto it = net.find (ptid);
+      if (it == net.end ())
+	continue;
+
+      if (it->second != thread_list_change_kind::removed)
+	{
+	  thread_info *thread = find_thread_ptid (ptid);
+	  if (thread != nullptr)
+	    listed->push_back (thread);
+	}
+      else
+	removed->push_back (ptid);
+
+      /* A ptid can appear more than once in ORDER.  */
+      net.erase (it);
+    }
+
+  return true;
+}
+
 thread_info *
 process_info::add_thread (ptid_t id, void *target_data)
 {
@@ -47,6 +173,8 @@ process_info::add_thread (ptid_t id, void *target_data)
   /* A thread with this ptid should not exist in the map yet.  */
   gdb_assert (inserted);
 
+  record_thread_list_change (id, thread_list_change_kind::added);
+
   if (current_thread == NULL)
     switch_to_thread (&new_thread);
 
@@ -109,6 +237,8 @@ process_info::remove_thread (thread_info *thread)
   int num_erased = m_ptid_thread_map.erase (thread->id);
   gdb_assert (num_erased > 0);
 
+  record_thread_list_change (thread->id, thread_list_change_kind::removed);
+
   m_thread_list.erase (m_thread_list.iterator_to (*thread));
 }
 
@@ -158,4 +158,26 @@ void switch_to_process (process_info *proc);
    the directory.  */
 void set_inferior_cwd (std::string cwd);
 
+/* The thread list generation.  This is incremented every time a thread
+   is added or removed, in any process, or its attributes change.  */
+
+extern ULONGEST thread_list_generation;
+
+/* Record that the attributes of THREAD sent in thread lists, such as
+   its name or core, changed.  */
+
+extern void record_thread_attributes_change (thread_info *thread);
+
+/* Collect the changes made to the thread lists since generation SINCE.
+   Threads that were added or changed and are still alive are stored
+   in LISTED, in the order of their first change, and the ptids of
+   threads that existed at generation SINCE and have been removed since
+   are stored in REMOVED.  Return false if the changes since SINCE are
+   no longer known, in which case the caller must send the full thread
+   list instead.  */
+
+extern bool thread_list_changes_since (ULONGEST since,
+				       std::vector<thread_info *> *listed,
+				       std::vector<ptid_t> *removed);
+
 #endif /* GDBSERVER_INFERIORS_H */
@@ -927,8 +927,6 @@ getpkt (char *buf)
 
   while (1)
     {
-      csum = 0;
-
       while (1)
 	{
 	  c = readchar ();
@@ -959,9 +957,9 @@ getpkt (char *buf)
 	  if (c == '#')
 	    break;
 	  *bp++ = c;
-	  csum += c;
 	}
       *bp = 0;
+      csum = remote_packet_checksum (buf, bp - buf);
 
       c1 = fromhex (readchar ());
       c2 = fromhex (readchar ());
@@ -50,8 +50,10 @@
 #include "gdbsupport/gdb_select.h"
 #include "gdbsupport/scoped_restore.h"
 #include "gdbsupport/search.h"
+#include "gdbsupport/byte-vector.h"
 #include "gdbsupport/gdb_argv_vec.h"
 #include "gdbsupport/remote-args.h"
+#include "sha1.h"
 
 /* PBUFSIZ must also be at least as big as IPA_CMD_BUF_SIZE, because
    the client state data is passed directly to some agent
@@ -1159,6 +1161,67 @@ get_features_xml (const char *annex)
   return NULL;
 }
 
+/* Feed the target description document ANNEX, as returned by
+   get_features_xml, and the documents it includes, to CTX.  Return
+   false if one of them can't be found.  */
+
+static bool
+hash_features_xml (struct sha1_ctx *ctx, const char *annex, int depth)
+{
+  /* Same limit as GDB's xml_process_xincludes.  */
+  if (depth > 30)
+    return false;
+
+  const char *document = get_features_xml (annex);
+  if (document == NULL)
+    return false;
+
+  /* Include the terminating NUL, so that the boundaries between
+     documents are part of the hash.  */
+  sha1_process_bytes (document, strlen (document) + 1, ctx);
+
+  for (const char *p = strstr (document, "<xi:include");
+       p != NULL;
+       p = strstr (p + 1, "<xi:include"))
+    {
+      const char *href = strstr (p, "href=\"");
+      if (href == NULL)
+	return false;
+      href += strlen ("href=\"");
+
+      const char *end = strchr (href, '"');
+      if (end == NULL)
+	return false;
+
+      std::string name (href, end);
+      if (!hash_features_xml (ctx, name.c_str (), depth + 1))
+	return false;
+    }
+
+  return true;
+}
+
+/* Handle the qTDescHash packet: reply with the SHA-1 of the documents
+   that make up the current target description, so that GDB can tell
+   whether it has already read them.  */
+
+static void
+handle_tdesc_hash (char *own_buf)
+{
+  struct sha1_ctx ctx;
+  gdb_byte digest[20];
+
+  sha1_init_ctx (&ctx);
+  if (!hash_features_xml (&ctx, "target.xml", 0))
+    {
+      write_enn (own_buf);
+      return;
+    }
+  sha1_finish_ctx (&ctx, digest);
+
+  bin2hex (digest, own_buf, sizeof (digest));
+}
+
 static void
 monitor_show_help (void)
 {
@@ -1285,6 +1348,67 @@ handle_search_memory (char *own_buf, int packet_len)
   free (pattern);
 }
 
+/* Handle qSearch:memory-any packets.  The search is done here, in a
+   single pass over the inferior's memory, so that only the result
+   goes over the wire.  */
+
+static void
+handle_search_memory_any (char *own_buf)
+{
+  /* Read memory in large chunks: it does not have to fit in a
+     packet.  */
+  const size_t chunk_size = 256 * 1024;
+  const char *p = own_buf + sizeof ("qSearch:memory-any:") - 1;
+  ULONGEST start_addr, search_space_len, align;
+
+  p = unpack_varlen_hex (p, &start_addr);
+  if (*p == ';')
+    p = unpack_varlen_hex (p + 1, &search_space_len);
+  if (*p == ';')
+    p = unpack_varlen_hex (p + 1, &align);
+  if (*p != ';' || align == 0)
+    error ("Error in parsing qSearch:memory-any packet");
+
+  std::vector<gdb::byte_vector> bytes;
+  while (*p == ';')
+    {
+      const char *start = ++p;
+
+      p = strchr (start, ';');
+      if (p == nullptr)
+	p = start + strlen (start);
+      size_t hex_len = p - start;
+      if (hex_len == 0 || hex_len % 2 != 0)
+	error ("Error in parsing qSearch:memory-any packet");
+      bytes.emplace_back (hex_len / 2);
+      hex2bin (start, bytes.back ().data (), hex_len / 2);
+    }
+  if (*p != '\0')
+    error ("Error in parsing qSearch:memory-any packet");
+
+  std::vector<search_pattern> patterns (bytes.begin (), bytes.end ());
+
+  auto read_memory = [] (CORE_ADDR addr, gdb_byte *result, size_t len)
+    {
+      return gdb_read_memory (addr, result, len) == len;
+    };
+
+  CORE_ADDR found_addr;
+  size_t found_index;
+  int found = simple_search_memory_multi (read_memory, start_addr,
+					  search_space_len, patterns, align,
+					  &found_addr, &found_index,
+					  chunk_size);
+
+  if (found > 0)
+    sprintf (own_buf, "1,%s,%s", paddress (found_addr),
+	     phex_nz (found_index));
+  else if (found == 0)
+    strcpy (own_buf, "0");
+  else
+    strcpy (own_buf, "E00");
+}
+
 /* Handle the "D" packet.  */
 
 static void
@@ -1972,7 +2096,7 @@ handle_qxfer_siginfo (const char *annex,
 }
 
 /* Helper for handle_qxfer_threads_proper.
-   Emit the XML to describe the thread of INF.  */
+   Emit the XML to describe THREAD.  */
 
 static void
 handle_qxfer_threads_worker (thread_info *thread, std::string *buffer)
@@ -2020,14 +2144,14 @@ handle_qxfer_threads_worker (thread_info *thread, std::string *buffer)
   string_xml_appendf (*buffer, "/>\n");
 }
 
-/* Helper for handle_qxfer_threads.  Return true on success, false
-   otherwise.  */
+/* Helper for handle_qxfer_threads_proper.  Update the description of
+   every thread, and record a thread list change for those whose
+   description changed since the last thread list, so that their new
+   attributes are sent again in thread list deltas.  */
 
-static bool
-handle_qxfer_threads_proper (std::string *buffer)
+static void
+update_thread_descriptions ()
 {
-  *buffer += "<threads>\n";
-
   /* The target may need to access memory and registers (e.g. via
      libthread_db) to fetch thread properties.  Even if don't need to
      stop threads to access memory, we still will need to be able to
@@ -2038,13 +2162,65 @@ handle_qxfer_threads_proper (std::string *buffer)
   if (non_stop)
     target_pause_all (true);
 
-  for_each_thread ([&] (thread_info *thread)
+  for_each_thread ([] (thread_info *thread)
     {
-      handle_qxfer_threads_worker (thread, buffer);
+      std::string description;
+
+      handle_qxfer_threads_worker (thread, &description);
+      if (description != thread->listed_description)
+	{
+	  thread->listed_description = std::move (description);
+	  record_thread_attributes_change (thread);
+	}
     });
 
   if (non_stop)
     target_unpause_all (true);
+}
+
+/* Helper for handle_qxfer_threads.  If DELTA is true, describe only
+   the changes since thread list generation SINCE, if they are still
+   known.  Return true on success, false otherwise.  */
+
+static bool
+handle_qxfer_threads_proper (std::string *buffer, bool delta,
+			     ULONGEST since)
+{
+  std::vector<thread_info *> listed;
+  std::vector<ptid_t> removed;
+
+  update_thread_descriptions ();
+
+  if (delta && !thread_list_changes_since (since, &listed, &removed))
+    delta = false;
+
+  if (delta)
+    string_xml_appendf (*buffer,
+			"<threads generation=\"%s\" since=\"%s\">\n",
+			pulongest (thread_list_generation),
+			pulongest (since));
+  else
+    string_xml_appendf (*buffer, "<threads generation=\"%s\">\n",
+			pulongest (thread_list_generation));
+
+  if (delta)
+    {
+      for (thread_info *thread : listed)
+	*buffer += thread->listed_description;
+
+      for (ptid_t ptid : removed)
+	{
+	  char ptid_s[100];
+
+	  write_ptid (ptid_s, ptid);
+	  string_xml_appendf (*buffer, "<removed id=\"%s\"/>\n", ptid_s);
+	}
+    }
+  else
+    for_each_thread ([&] (thread_info *thread)
+      {
+	*buffer += thread->listed_description;
+      });
 
   *buffer += "</threads>\n";
   return true;
@@ -2062,8 +2238,19 @@ handle_qxfer_threads (const char *annex,
   if (writebuf != NULL)
     return -2;
 
+  /* A non-empty annex is the thread list generation GDB last saw, in
+     decimal, asking only for the changes since then.  */
+  bool delta = false;
+  ULONGEST since = 0;
+
   if (annex[0] != '\0')
-    return -1;
+    {
+      const char *end;
+      since = strtoulst (annex, &end, 10);
+      if (!isdigit (annex[0]) || *end != '\0')
+	return -1;
+      delta = true;
+    }
 
   if (offset == 0)
     {
@@ -2071,7 +2258,7 @@ handle_qxfer_threads (const char *annex,
 	 'result'.  Successive reads will be served off 'result'.  */
       result.clear ();
 
-      bool res = handle_qxfer_threads_proper (&result);
+      bool res = handle_qxfer_threads_proper (&result, delta, since);
 
       if (!res)
 	return -1;
@@ -2793,10 +2980,13 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 	 If we reported to GDB on startup that we don't support
 	 qXfer:feature:read at all, we will never be re-queried.  */
       strcat (own_buf, ";qXfer:features:read+");
+      strcat (own_buf, ";qTDescHash+");
 
       if (cs.transport_is_reliable)
 	strcat (own_buf, ";QStartNoAckMode+");
 
+      strcat (own_buf, ";pipelined-requests+");
+
       if (the_target->supports_qxfer_osdata ())
 	strcat (own_buf, ";qXfer:osdata:read+");
 
@@ -2819,6 +3009,7 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 	strcat (own_buf, ";QDisableRandomization+");
 
       strcat (own_buf, ";qXfer:threads:read+");
+      strcat (own_buf, ";threads-delta+");
 
       if (target_supports_tracepoints ())
 	{
@@ -3007,6 +3198,20 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
       return;
     }
 
+  if (strcmp (own_buf, "qTDescHash") == 0)
+    {
+      require_running_or_return (own_buf);
+      handle_tdesc_hash (own_buf);
+      return;
+    }
+
+  if (startswith (own_buf, "qSearch:memory-any:"))
+    {
+      require_running_or_return (own_buf);
+      handle_search_memory_any (own_buf);
+      return;
+    }
+
   if (strcmp (own_buf, "qAttached") == 0
       || startswith (own_buf, "qAttached:"))
     {
@@ -434,40 +434,6 @@ fromhex (int a)
 
 /* See gdbsupport/common-utils.h.  */
 
-int
-hex2bin (const char *hex, gdb_byte *bin, int count)
-{
-  int i;
-
-  for (i = 0; i < count; i++)
-    {
-      if (hex[0] == 0 || hex[1] == 0)
-	{
-	  /* Hex string is short, or of uneven length.
-	     Return the count that has been converted so far.  */
-	  return i;
-	}
-      *bin++ = fromhex (hex[0]) * 16 + fromhex (hex[1]);
-      hex += 2;
-    }
-  return i;
-}
-
-/* See gdbsupport/common-utils.h.  */
-
-gdb::byte_vector
-hex2bin (const char *hex)
-{
-  size_t bin_len = strlen (hex) / 2;
-  gdb::byte_vector bin (bin_len);
-
-  hex2bin (hex, bin.data (), bin_len);
-
-  return bin;
-}
-
-/* See gdbsupport/common-utils.h.  */
-
 std::string
 bytes_to_string (gdb::array_view<const gdb_byte> bytes)
 {
@@ -483,3 +449,39 @@ bytes_to_string (gdb::array_view<const gdb_byte> bytes)
 
   return ret;
 }
+
+/* See gdbsupport/common-utils.h.  */
+
+size_t
+count_repeated_units (const gdb_byte *unit, size_t unit_len,
+		      const gdb_byte *buffer, size_t count)
+{
+  if (count == 0 || memcmp (buffer, unit, unit_len) != 0)
+    return 0;
+
+  /* The first unit matches.  The following N units all match as well
+     if BUFFER compares equal to itself shifted by one unit over N
+     units; check that over blocks that grow geometrically, so that
+     long runs need few calls.  */
+  size_t n = 1;
+  size_t block = 1;
+  while (n < count)
+    {
+      size_t todo = std::min (block, count - n);
+
+      if (memcmp (buffer + (n - 1) * unit_len, buffer + n * unit_len,
+		  todo * unit_len) != 0)
+	{
+	  /* Some unit in this block differs; find the first one.  */
+	  while (memcmp (buffer + (n - 1) * unit_len, buffer + n * unit_len,
+			 unit_len) == 0)
+	    n++;
+	  return n;
+	}
+
+      n += todo;
+      block = std::min<size_t> (block * 2, 4096);
+    }
+
+  return n;
+}
@@ -235,6 +235,14 @@ static inline std::string bytes_to_string (const gdb_byte *buffer,
   return bytes_to_string ({buffer, length});
 }
 
+/* Return how many times the UNIT_LEN bytes at UNIT are repeated at the
+   start of BUFFER, which holds COUNT units of UNIT_LEN bytes each.  The
+   comparison is done with a few large memcmp calls rather than one
+   call per unit.  */
+
+extern size_t count_repeated_units (const gdb_byte *unit, size_t unit_len,
+				    const gdb_byte *buffer, size_t count);
+
 /* A fast hashing function.  This can be used to hash data in a fast way
    when the length is known.  If no fast hashing library is available, falls
    back to iterative_hash from libiberty.  START_VALUE can be set to
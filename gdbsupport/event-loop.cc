@@ -19,6 +19,7 @@
 
 #include "gdbsupport/event-loop.h"
 
+#include <algorithm>
 #include <chrono>
 
 #ifdef HAVE_POLL
@@ -29,6 +30,10 @@
 #endif
 #endif
 
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
+
 #include <sys/types.h>
 #include "gdbsupport/gdb_sys_time.h"
 #include "gdbsupport/gdb_select.h"
@@ -86,6 +91,206 @@ struct file_handler
 static bool use_poll = true;
 #endif
 
+#ifdef USE_EPOLL
+/* Do we use epoll?  When we do, file descriptors are registered with
+   the epoll instance when their handler is created and stay
+   registered until it is deleted, so waiting for an event does not
+   cost more with many monitored file descriptors.  The poll
+   descriptors are still maintained, so that we can fall back to poll
+   if the epoll instance can't be used.  Only meaningful if USE_POLL
+   is true.  */
+static bool use_epoll = true;
+
+/* The epoll instance, created on first use.  */
+static int epoll_fd = -1;
+
+/* The file handlers registered with EPOLL_FD, indexed by file
+   descriptor.  */
+static std::vector<file_handler *> epoll_handlers;
+
+/* The file handlers whose descriptor can't be registered with
+   EPOLL_FD, for example because it is a regular file.  They are
+   polled along with EPOLL_FD.  */
+static std::vector<file_handler *> epoll_other_handlers;
+
+/* The pollfds used to wait for EPOLL_FD and the descriptors of
+   EPOLL_OTHER_HANDLERS, kept to avoid reallocating them.  */
+static std::vector<struct pollfd> epoll_other_poll_fds;
+
+/* When both EPOLL_FD and some of EPOLL_OTHER_HANDLERS are ready,
+   they are served in turn: whether EPOLL_FD is next, and which of
+   EPOLL_OTHER_HANDLERS is looked at first.  */
+static bool epoll_fd_next;
+static size_t epoll_other_next;
+
+static void handle_file_event (file_handler *file_ptr, int ready_mask);
+
+/* The epoll event bits are the same as the poll ones, so the masks
+   can be passed along unchanged.  */
+static_assert (EPOLLIN == POLLIN && EPOLLPRI == POLLPRI
+	       && EPOLLOUT == POLLOUT && EPOLLERR == POLLERR
+	       && EPOLLHUP == POLLHUP);
+
+/* Stop using epoll, and use poll from now on.  */
+
+static void
+disable_epoll ()
+{
+  if (epoll_fd != -1)
+    close (epoll_fd);
+  epoll_fd = -1;
+  use_epoll = false;
+  epoll_handlers.clear ();
+  epoll_other_handlers.clear ();
+}
+
+/* Monitor FILE_PTR's descriptor by polling it along with EPOLL_FD.  */
+
+static void
+epoll_add_other_handler (file_handler *file_ptr)
+{
+  if ((size_t) file_ptr->fd < epoll_handlers.size ())
+    epoll_handlers[file_ptr->fd] = nullptr;
+  epoll_other_handlers.push_back (file_ptr);
+}
+
+/* Start monitoring the file descriptor of FILE_PTR with epoll.  If
+   that is not possible, fall back to poll.  */
+
+static void
+epoll_add_file_handler (file_handler *file_ptr)
+{
+  if (epoll_fd == -1)
+    {
+      epoll_fd = epoll_create1 (EPOLL_CLOEXEC);
+      if (epoll_fd == -1)
+	{
+	  disable_epoll ();
+	  return;
+	}
+    }
+
+  struct epoll_event event {};
+  event.events = file_ptr->mask;
+  event.data.fd = file_ptr->fd;
+  if (epoll_ctl (epoll_fd, EPOLL_CTL_ADD, file_ptr->fd, &event) != 0)
+    {
+      /* EPERM means that the file descriptor does not support epoll,
+	 but any error means that we would miss its events.  Only this
+	 descriptor is affected.  */
+      epoll_add_other_handler (file_ptr);
+      return;
+    }
+
+  if (epoll_handlers.size () <= (size_t) file_ptr->fd)
+    epoll_handlers.resize (file_ptr->fd + 1);
+  epoll_handlers[file_ptr->fd] = file_ptr;
+}
+
+/* Update the registration of FILE_PTR, which is being added again.
+   Its descriptor may have been closed and reused since it was first
+   added, in which case the kernel removed it from EPOLL_FD.  */
+
+static void
+epoll_update_file_handler (file_handler *file_ptr)
+{
+  if (std::find (epoll_other_handlers.begin (), epoll_other_handlers.end (),
+		 file_ptr) != epoll_other_handlers.end ())
+    return;
+
+  struct epoll_event event {};
+  event.events = file_ptr->mask;
+  event.data.fd = file_ptr->fd;
+  if (epoll_ctl (epoll_fd, EPOLL_CTL_MOD, file_ptr->fd, &event) == 0)
+    return;
+
+  if (errno == ENOENT)
+    epoll_add_file_handler (file_ptr);
+  else
+    {
+      epoll_ctl (epoll_fd, EPOLL_CTL_DEL, file_ptr->fd, nullptr);
+      epoll_add_other_handler (file_ptr);
+    }
+}
+
+/* Stop monitoring FD with epoll.  */
+
+static void
+epoll_delete_file_handler (int fd)
+{
+  auto it = std::find_if (epoll_other_handlers.begin (),
+			  epoll_other_handlers.end (),
+			  [=] (file_handler *file_ptr)
+			  {
+			    return file_ptr->fd == fd;
+			  });
+  if (it != epoll_other_handlers.end ())
+    {
+      epoll_other_handlers.erase (it);
+      return;
+    }
+
+  /* This can fail if FD was already closed, in which case the kernel
+     has removed it already.  */
+  epoll_ctl (epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+  if ((size_t) fd < epoll_handlers.size ())
+    epoll_handlers[fd] = nullptr;
+}
+
+/* Wait up to TIMEOUT milliseconds for EPOLL_FD or the descriptors of
+   EPOLL_OTHER_HANDLERS to be ready.  If one of the latter is served,
+   return true after calling its handler.  Otherwise, return false and
+   set *TIMEOUT to the time epoll_wait should still wait: 0 if
+   EPOLL_FD is ready, or -1 after an error or timeout, when nothing is
+   ready.  */
+
+static bool
+epoll_poll_other_handlers (int *timeout)
+{
+  size_t count = epoll_other_handlers.size ();
+
+  epoll_other_poll_fds.resize (count + 1);
+  epoll_other_poll_fds[0] = { epoll_fd, POLLIN, 0 };
+  for (size_t i = 0; i < count; i++)
+    epoll_other_poll_fds[i + 1] = { epoll_other_handlers[i]->fd,
+				    (short) epoll_other_handlers[i]->mask,
+				    0 };
+
+  int num_found = poll (epoll_other_poll_fds.data (), count + 1, *timeout);
+
+  /* Don't print anything if we get out of poll because of a
+     signal.  */
+  if (num_found == -1 && errno != EINTR)
+    perror_with_name (("poll"));
+
+  if (num_found <= 0)
+    {
+      *timeout = -1;
+      return false;
+    }
+
+  bool epoll_ready = epoll_other_poll_fds[0].revents != 0;
+  if (!epoll_ready || !epoll_fd_next)
+    for (size_t n = 0; n < count; n++)
+      {
+	size_t i = (epoll_other_next + n) % count;
+	int mask = epoll_other_poll_fds[i + 1].revents;
+
+	if (mask != 0)
+	  {
+	    epoll_other_next = i + 1;
+	    epoll_fd_next = true;
+	    handle_file_event (epoll_other_handlers[i], mask);
+	    return true;
+	  }
+      }
+
+  epoll_fd_next = false;
+  *timeout = 0;
+  return false;
+}
+#endif /* USE_EPOLL */
+
 #ifdef USE_WIN32API
 #include <windows.h>
 #include <io.h>
@@ -312,6 +517,7 @@ create_file_handler (int fd, int mask, handler_func * proc,
 		     bool is_ui)
 {
   file_handler *file_ptr;
+  bool is_new = false;
 
   /* Do we already have a file handler for this file?  (We may be
      changing its associated procedure).  */
@@ -327,6 +533,7 @@ create_file_handler (int fd, int mask, handler_func * proc,
   if (file_ptr == NULL)
     {
       file_ptr = new file_handler;
+      is_new = true;
       file_ptr->fd = fd;
       file_ptr->ready_mask = 0;
       file_ptr->next_file = gdb_notifier.first_file_handler;
@@ -370,6 +577,16 @@ create_file_handler (int fd, int mask, handler_func * proc,
   file_ptr->mask = mask;
   file_ptr->name = std::move (name);
   file_ptr->is_ui = is_ui;
+
+#ifdef USE_EPOLL
+  if (use_poll && use_epoll)
+    {
+      if (is_new)
+	epoll_add_file_handler (file_ptr);
+      else
+	epoll_update_file_handler (file_ptr);
+    }
+#endif
 }
 
 /* Return the next file handler to handle, and advance to the next
@@ -417,6 +634,11 @@ delete_file_handler (int fd)
   if (file_ptr == NULL)
     return;
 
+#ifdef USE_EPOLL
+  if (use_poll && use_epoll)
+    epoll_delete_file_handler (fd);
+#endif
+
 #ifdef HAVE_POLL
   if (use_poll)
     {
@@ -574,6 +796,61 @@ gdb_wait_for_event (int block)
   if (block)
     update_wait_timeout ();
 
+#ifdef USE_EPOLL
+  if (use_poll && use_epoll)
+    {
+      struct epoll_event event;
+      int timeout;
+
+      if (block)
+	timeout = gdb_notifier.timeout_valid ? gdb_notifier.poll_timeout : -1;
+      else
+	timeout = 0;
+
+      if (!epoll_other_handlers.empty ())
+	{
+	  if (epoll_poll_other_handlers (&timeout))
+	    return 1;
+	  if (timeout == -1)
+	    return 0;
+	}
+
+      /* Only ask for one event.  Since descriptors are level
+	 triggered, those we don't consume now are reported again by
+	 the next call, and the kernel moves a reported descriptor to
+	 the back of its ready list, so this serves the ready
+	 descriptors in a round-robin fashion, like the poll variant
+	 below.  */
+      num_found = epoll_wait (epoll_fd, &event, 1, timeout);
+
+      /* Don't print anything if we get out of epoll_wait because of
+	 a signal.  */
+      if (num_found == -1 && errno != EINTR)
+	perror_with_name (("epoll_wait"));
+
+      if (num_found <= 0)
+	return 0;
+
+      if ((size_t) event.data.fd < epoll_handlers.size ())
+	file_ptr = epoll_handlers[event.data.fd];
+      else
+	file_ptr = nullptr;
+
+      /* A descriptor that was closed before its handler was deleted
+	 stays registered as long as another process still has it
+	 open, and can't be removed any more.  Use poll from now
+	 on.  */
+      if (file_ptr == nullptr)
+	{
+	  disable_epoll ();
+	  return 0;
+	}
+
+      handle_file_event (file_ptr, event.events);
+      return 1;
+    }
+#endif /* USE_EPOLL */
+
 #ifdef HAVE_POLL
   if (use_poll)
     {
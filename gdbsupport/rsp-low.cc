@@ -19,6 +19,14 @@
 
 #include "rsp-low.h"
 
+#if defined (__SSE2__)
+#include <emmintrin.h>
+#define RSP_LOW_SSE2 1
+#elif defined (__aarch64__) && defined (__ARM_NEON)
+#include <arm_neon.h>
+#define RSP_LOW_NEON 1
+#endif
+
 /* See rsp-low.h.  */
 
 int
@@ -55,6 +63,197 @@ ishex (int ch, int *val)
   return 0;
 }
 
+/* The bulk conversion routines below process 16 bytes at a time with
+   SIMD instructions when the host has them (SSE2 on x86, Advanced
+   SIMD on AArch64), and handle what is left one byte at a time.  The
+   block routines must give the same results as the byte-wise loops;
+   see the selftests in gdb/unittests/rsp-low-selftests.c.  */
+
+#if defined (RSP_LOW_SSE2) || defined (RSP_LOW_NEON)
+
+/* Number of bytes processed by each block routine.  */
+
+static constexpr int rsp_block_size = 16;
+
+#if defined (RSP_LOW_SSE2)
+
+/* Convert each byte of NIB, a value in [0, 15], to its hex digit.  */
+
+static inline __m128i
+nibbles_to_hex (__m128i nib)
+{
+  __m128i above_9 = _mm_cmpgt_epi8 (nib, _mm_set1_epi8 (9));
+  __m128i digits = _mm_add_epi8 (nib, _mm_set1_epi8 ('0'));
+  return _mm_add_epi8 (digits, _mm_and_si128 (above_9,
+					      _mm_set1_epi8 ('a' - '0' - 10)));
+}
+
+/* Return a mask with 0xff for the bytes of X that are less than or
+   equal to LIMIT, as unsigned values.  */
+
+static inline __m128i
+bytes_le (__m128i x, __m128i limit)
+{
+  return _mm_cmpeq_epi8 (_mm_min_epu8 (x, limit), x);
+}
+
+/* Convert each hex digit in CHARS to its value.  Return false if one
+   of them is not a hex digit.  */
+
+static inline bool
+hex_to_nibbles (__m128i chars, __m128i *nib)
+{
+  __m128i digit = _mm_sub_epi8 (chars, _mm_set1_epi8 ('0'));
+  __m128i is_digit = bytes_le (digit, _mm_set1_epi8 (9));
+  __m128i alpha = _mm_sub_epi8 (_mm_or_si128 (chars, _mm_set1_epi8 (0x20)),
+				_mm_set1_epi8 ('a'));
+  __m128i is_alpha = bytes_le (alpha, _mm_set1_epi8 (5));
+
+  if (_mm_movemask_epi8 (_mm_or_si128 (is_digit, is_alpha)) != 0xffff)
+    return false;
+
+  alpha = _mm_add_epi8 (alpha, _mm_set1_epi8 (10));
+  *nib = _mm_or_si128 (_mm_and_si128 (is_digit, digit),
+		       _mm_and_si128 (is_alpha, alpha));
+  return true;
+}
+
+#else /* RSP_LOW_NEON */
+
+/* Convert each byte of NIB, a value in [0, 15], to its hex digit.  */
+
+static inline uint8x16_t
+nibbles_to_hex (uint8x16_t nib)
+{
+  return vqtbl1q_u8 (vld1q_u8 ((const uint8_t *) hexchars), nib);
+}
+
+/* Convert each hex digit in CHARS to its value.  Return false if one
+   of them is not a hex digit.  */
+
+static inline bool
+hex_to_nibbles (uint8x16_t chars, uint8x16_t *nib)
+{
+  uint8x16_t digit = vsubq_u8 (chars, vdupq_n_u8 ('0'));
+  uint8x16_t is_digit = vcleq_u8 (digit, vdupq_n_u8 (9));
+  uint8x16_t alpha = vsubq_u8 (vorrq_u8 (chars, vdupq_n_u8 (0x20)),
+			       vdupq_n_u8 ('a'));
+  uint8x16_t is_alpha = vcleq_u8 (alpha, vdupq_n_u8 (5));
+
+  if (vminvq_u8 (vorrq_u8 (is_digit, is_alpha)) != 0xff)
+    return false;
+
+  alpha = vaddq_u8 (alpha, vdupq_n_u8 (10));
+  *nib = vbslq_u8 (is_digit, digit, alpha);
+  return true;
+}
+
+#endif
+
+/* Convert the 16 bytes at BIN to 32 hex digits at HEX.  */
+
+static inline void
+bin2hex_block (const gdb_byte *bin, char *hex)
+{
+#if defined (RSP_LOW_SSE2)
+  __m128i in = _mm_loadu_si128 ((const __m128i *) bin);
+  __m128i low_mask = _mm_set1_epi8 (0x0f);
+  __m128i high = nibbles_to_hex (_mm_and_si128 (_mm_srli_epi16 (in, 4),
+						low_mask));
+  __m128i low = nibbles_to_hex (_mm_and_si128 (in, low_mask));
+
+  _mm_storeu_si128 ((__m128i *) hex, _mm_unpacklo_epi8 (high, low));
+  _mm_storeu_si128 ((__m128i *) (hex + 16), _mm_unpackhi_epi8 (high, low));
+#else
+  uint8x16_t in = vld1q_u8 (bin);
+  uint8x16x2_t out;
+
+  out.val[0] = nibbles_to_hex (vshrq_n_u8 (in, 4));
+  out.val[1] = nibbles_to_hex (vandq_u8 (in, vdupq_n_u8 (0x0f)));
+  vst2q_u8 ((uint8_t *) hex, out);
+#endif
+}
+
+/* Convert the 32 hex digits at HEX to 16 bytes at BIN.  Return false,
+   without writing anything, if one of the characters is not a hex
+   digit.  */
+
+static inline bool
+hex2bin_block (const char *hex, gdb_byte *bin)
+{
+#if defined (RSP_LOW_SSE2)
+  __m128i first, second;
+
+  if (!hex_to_nibbles (_mm_loadu_si128 ((const __m128i *) hex), &first)
+      || !hex_to_nibbles (_mm_loadu_si128 ((const __m128i *) (hex + 16)),
+			  &second))
+    return false;
+
+  /* Each 16-bit lane holds a high nibble in its low byte and the
+     matching low nibble in its high byte (little-endian).  Combine
+     them in the low byte, and pack the lanes.  */
+  __m128i high_mask = _mm_set1_epi16 (0x00f0);
+  first = _mm_or_si128 (_mm_and_si128 (_mm_slli_epi16 (first, 4), high_mask),
+			_mm_srli_epi16 (first, 8));
+  second = _mm_or_si128 (_mm_and_si128 (_mm_slli_epi16 (second, 4),
+					high_mask),
+			 _mm_srli_epi16 (second, 8));
+  _mm_storeu_si128 ((__m128i *) bin, _mm_packus_epi16 (first, second));
+#else
+  /* This de-interleaves the high and low digits.  */
+  uint8x16x2_t in = vld2q_u8 ((const uint8_t *) hex);
+  uint8x16_t high, low;
+
+  if (!hex_to_nibbles (in.val[0], &high)
+      || !hex_to_nibbles (in.val[1], &low))
+    return false;
+
+  vst1q_u8 (bin, vorrq_u8 (vshlq_n_u8 (high, 4), low));
+#endif
+  return true;
+}
+
+/* Return the index of the first of the 16 bytes at P that needs
+   escaping in binary data if ESCAPE_OUTPUT, or that is an escape
+   character ('}') otherwise.  Return 16 if there is none.  */
+
+static inline int
+find_special_byte (const gdb_byte *p, bool escape_output)
+{
+#if defined (RSP_LOW_SSE2)
+  __m128i in = _mm_loadu_si128 ((const __m128i *) p);
+  __m128i found = _mm_cmpeq_epi8 (in, _mm_set1_epi8 ('}'));
+
+  if (escape_output)
+    found = _mm_or_si128 (_mm_or_si128 (found,
+					_mm_cmpeq_epi8 (in,
+							_mm_set1_epi8 ('$'))),
+			  _mm_or_si128 (_mm_cmpeq_epi8 (in,
+							_mm_set1_epi8 ('#')),
+					_mm_cmpeq_epi8 (in,
+							_mm_set1_epi8 ('*'))));
+
+  int mask = _mm_movemask_epi8 (found);
+  return mask == 0 ? 16 : __builtin_ctz (mask);
+#else
+  uint8x16_t in = vld1q_u8 (p);
+  uint8x16_t found = vceqq_u8 (in, vdupq_n_u8 ('}'));
+
+  if (escape_output)
+    found = vorrq_u8 (vorrq_u8 (found, vceqq_u8 (in, vdupq_n_u8 ('$'))),
+		      vorrq_u8 (vceqq_u8 (in, vdupq_n_u8 ('#')),
+				vceqq_u8 (in, vdupq_n_u8 ('*'))));
+
+  /* Narrow each byte of the mask to 4 bits, giving a 64-bit value.  */
+  uint64_t mask
+    = vget_lane_u64 (vreinterpret_u64_u8
+		       (vshrn_n_u16 (vreinterpretq_u16_u8 (found), 4)), 0);
+  return mask == 0 ? 16 : __builtin_ctzll (mask) / 4;
+#endif
+}
+
+#endif /* RSP_LOW_SSE2 || RSP_LOW_NEON */
+
 /* See rsp-low.h.  */
 
 char *
@@ -124,14 +323,72 @@ hex2str (const char *hex, int count)
   return ret;
 }
 
+/* See gdbsupport/common-utils.h.  */
+
+int
+hex2bin (const char *hex, gdb_byte *bin, int count)
+{
+  int i = 0;
+
+#if defined (RSP_LOW_SSE2) || defined (RSP_LOW_NEON)
+  if (count >= rsp_block_size)
+    {
+      /* Don't read past the end of HEX.  */
+      int avail = strnlen (hex, (size_t) count * 2) / 2;
+
+      while (i + rsp_block_size <= avail && hex2bin_block (hex, bin))
+	{
+	  i += rsp_block_size;
+	  hex += rsp_block_size * 2;
+	  bin += rsp_block_size;
+	}
+    }
+#endif
+
+  for (; i < count; i++)
+    {
+      if (hex[0] == 0 || hex[1] == 0)
+	{
+	  /* Hex string is short, or of uneven length.
+	     Return the count that has been converted so far.  */
+	  return i;
+	}
+      *bin++ = fromhex (hex[0]) * 16 + fromhex (hex[1]);
+      hex += 2;
+    }
+  return i;
+}
+
+/* See gdbsupport/common-utils.h.  */
+
+gdb::byte_vector
+hex2bin (const char *hex)
+{
+  size_t bin_len = strlen (hex) / 2;
+  gdb::byte_vector bin (bin_len);
+
+  hex2bin (hex, bin.data (), bin_len);
+
+  return bin;
+}
+
 /* See rsp-low.h.  */
 
 int
 bin2hex (const gdb_byte *bin, char *hex, int count)
 {
-  int i;
+  int i = 0;
 
-  for (i = 0; i < count; i++)
+#if defined (RSP_LOW_SSE2) || defined (RSP_LOW_NEON)
+  for (; i + rsp_block_size <= count; i += rsp_block_size)
+    {
+      bin2hex_block (bin, hex);
+      bin += rsp_block_size;
+      hex += rsp_block_size * 2;
+    }
+#endif
+
+  for (; i < count; i++)
     {
       *hex++ = tohex ((*bin >> 4) & 0xf);
       *hex++ = tohex (*bin++ & 0xf);
@@ -153,15 +410,9 @@ bin2hex (gdb::array_view<gdb_byte> bin, char *hex)
 std::string
 bin2hex (const gdb_byte *bin, int count)
 {
-  std::string ret;
-
-  ret.reserve (count * 2);
-  for (int i = 0; i < count; ++i)
-    {
-      ret += tohex ((*bin >> 4) & 0xf);
-      ret += tohex (*bin++ & 0xf);
-    }
+  std::string ret (count * 2, '\0');
 
+  bin2hex (bin, &ret[0], count);
   return ret;
 }
 
@@ -180,13 +431,40 @@ remote_escape_output (const gdb_byte *buffer, int len_units, int unit_size,
 		      gdb_byte *out_buf, int *out_len_units,
 		      int out_maxlen_bytes)
 {
-  int input_unit_index, output_byte_index = 0, byte_index_in_unit;
+  int input_unit_index = 0, output_byte_index = 0, byte_index_in_unit;
   int number_escape_bytes_needed;
 
+#if defined (RSP_LOW_SSE2) || defined (RSP_LOW_NEON)
+  /* With byte-sized units, copy the runs of bytes that don't need
+     escaping in one go.  Leave the rest to the loop below when we get
+     close to the end of the input or of the output buffer.  */
+  if (unit_size == 1)
+    while (input_unit_index + rsp_block_size <= len_units)
+      {
+	const gdb_byte *in = buffer + input_unit_index;
+	int n = find_special_byte (in, true);
+
+	if (output_byte_index + n + (n < rsp_block_size ? 2 : 0)
+	    > out_maxlen_bytes)
+	  break;
+
+	memcpy (out_buf + output_byte_index, in, n);
+	output_byte_index += n;
+	input_unit_index += n;
+
+	if (n < rsp_block_size)
+	  {
+	    out_buf[output_byte_index++] = '}';
+	    out_buf[output_byte_index++] = in[n] ^ 0x20;
+	    input_unit_index++;
+	  }
+      }
+#endif
+
   /* Try to copy integral addressable memory units until
      (1) we run out of space or
      (2) we copied all of them.  */
-  for (input_unit_index = 0;
+  for (;
        input_unit_index < len_units;
        input_unit_index++)
     {
@@ -237,9 +515,40 @@ remote_unescape_input (const gdb_byte *buffer, int len,
   int input_index, output_index;
   int escaped;
 
+  input_index = 0;
   output_index = 0;
   escaped = 0;
-  for (input_index = 0; input_index < len; input_index++)
+
+#if defined (RSP_LOW_SSE2) || defined (RSP_LOW_NEON)
+  /* Copy the runs of bytes without escape characters in one go.
+     Leave the rest, and the error checking, to the loop below when we
+     get close to the end of the input or of the output buffer.  */
+  while (input_index + rsp_block_size <= len)
+    {
+      const gdb_byte *in = buffer + input_index;
+      int n = find_special_byte (in, false);
+
+      /* An escape character needs the next byte and one more byte of
+	 output.  */
+      if (n < rsp_block_size
+	  && (input_index + n + 1 >= len || output_index + n + 1 > out_maxlen))
+	break;
+      if (output_index + n > out_maxlen)
+	break;
+
+      memcpy (out_buf + output_index, in, n);
+      output_index += n;
+      input_index += n;
+
+      if (n < rsp_block_size)
+	{
+	  out_buf[output_index++] = in[n + 1] ^ 0x20;
+	  input_index += 2;
+	}
+    }
+#endif
+
+  for (; input_index < len; input_index++)
     {
       gdb_byte b = buffer[input_index];
 
@@ -263,3 +572,37 @@ remote_unescape_input (const gdb_byte *buffer, int len,
   return output_index;
 }
 
+
+/* See rsp-low.h.  */
+
+unsigned char
+remote_packet_checksum (const char *buf, size_t len)
+{
+  unsigned char csum = 0;
+  size_t i = 0;
+
+#if defined (RSP_LOW_SSE2)
+  /* Sum each group of 8 bytes into a 64-bit lane.  */
+  __m128i sum = _mm_setzero_si128 ();
+
+  for (; i + rsp_block_size <= len; i += rsp_block_size)
+    sum = _mm_add_epi64 (sum,
+			 _mm_sad_epu8 (_mm_loadu_si128 ((const __m128i *)
+							(buf + i)),
+				       _mm_setzero_si128 ()));
+  csum = _mm_cvtsi128_si32 (sum) + _mm_cvtsi128_si32 (_mm_srli_si128 (sum,
+								       8));
+#elif defined (RSP_LOW_NEON)
+  /* The checksum is modulo 256, so the byte lanes can wrap.  */
+  uint8x16_t sum = vdupq_n_u8 (0);
+
+  for (; i + rsp_block_size <= len; i += rsp_block_size)
+    sum = vaddq_u8 (sum, vld1q_u8 ((const uint8_t *) buf + i));
+  csum = vaddvq_u8 (sum);
+#endif
+
+  for (; i < len; i++)
+    csum += buf[i];
+
+  return csum;
+}
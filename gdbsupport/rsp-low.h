@@ -81,4 +81,9 @@ extern int remote_escape_output (const gdb_byte *buffer, int len_units,
 extern int remote_unescape_input (const gdb_byte *buffer, int len,
 				  gdb_byte *out_buf, int out_maxlen);
 
+/* Return the checksum of the LEN bytes at BUF, as used in remote
+   protocol packets: their sum, modulo 256.  */
+
+extern unsigned char remote_packet_checksum (const char *buf, size_t len);
+
 #endif /* GDBSUPPORT_RSP_LOW_H */
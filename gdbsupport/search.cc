@@ -117,3 +117,122 @@ simple_search_memory
 
   return 0;
 }
+
+/* See search.h.  */
+
+int
+simple_search_memory_multi
+  (gdb::function_view<target_read_memory_ftype> read_memory,
+   CORE_ADDR start_addr, ULONGEST search_space_len,
+   gdb::array_view<const search_pattern> patterns, ULONGEST align,
+   CORE_ADDR *found_addrp, size_t *found_indexp, size_t chunk_size)
+{
+  gdb_assert (!patterns.empty ());
+  gdb_assert (align != 0);
+
+  size_t min_len = patterns[0].size ();
+  size_t max_len = min_len;
+  for (const search_pattern &pattern : patterns)
+    {
+      gdb_assert (!pattern.empty ());
+      min_len = std::min (min_len, pattern.size ());
+      max_len = std::max (max_len, pattern.size ());
+    }
+
+  if (search_space_len < min_len)
+    return 0;
+
+  /* The buffer holds one chunk, plus enough of the following one that
+     a match of the longest pattern starting in the chunk is seen.  */
+  size_t buf_size = chunk_size + max_len - 1;
+  if (search_space_len < buf_size)
+    buf_size = search_space_len;
+
+  gdb::byte_vector buf (buf_size);
+
+  /* BUF holds HAVE bytes of memory starting at BUF_ADDR, and REMAINING
+     bytes are left to search from BUF_ADDR on.  */
+  CORE_ADDR buf_addr = start_addr;
+  ULONGEST remaining = search_space_len;
+  size_t have = buf_size;
+
+  if (!read_memory (buf_addr, buf.data (), have))
+    {
+      warning (_("Unable to access %s bytes of target "
+		 "memory at %s, halting search."),
+	       pulongest (have), hex_string (buf_addr));
+      return -1;
+    }
+
+  while (true)
+    {
+      bool last = have == remaining;
+
+      /* Unless this is the end of the search space, only report
+	 matches starting in the first chunk: a longer pattern could
+	 still match before a shorter one that fits entirely in the
+	 buffer.  */
+      size_t limit = last ? have : chunk_size;
+      size_t best = limit;
+      size_t best_index = 0;
+
+      for (size_t i = 0; i < patterns.size (); i++)
+	{
+	  const search_pattern &pattern = patterns[i];
+	  size_t len = pattern.size ();
+	  size_t pos = 0;
+
+	  /* Only look for matches that start before the best one so
+	     far, so that each pattern narrows the search for the next
+	     ones.  */
+	  while (pos < best)
+	    {
+	      size_t end = std::min (have, best - 1 + len);
+	      if (end < pos + len)
+		break;
+
+	      const gdb_byte *hit
+		= (const gdb_byte *) memmem (buf.data () + pos, end - pos,
+					     pattern.data (), len);
+	      if (hit == nullptr)
+		break;
+
+	      size_t off = hit - buf.data ();
+	      if ((buf_addr + off) % align == 0)
+		{
+		  best = off;
+		  best_index = i;
+		  break;
+		}
+	      pos = off + 1;
+	    }
+	}
+
+      if (best < limit)
+	{
+	  *found_addrp = buf_addr + best;
+	  *found_indexp = best_index;
+	  return 1;
+	}
+
+      if (last)
+	return 0;
+
+      /* Slide to the next chunk, keeping its start, which is already
+	 in the buffer.  */
+      size_t keep = have - chunk_size;
+      memmove (buf.data (), buf.data () + chunk_size, keep);
+      buf_addr += chunk_size;
+      remaining -= chunk_size;
+
+      size_t to_read = std::min (remaining - keep, (ULONGEST) chunk_size);
+      if (!read_memory (buf_addr + keep, buf.data () + keep, to_read))
+	{
+	  warning (_("Unable to access %s bytes of target "
+		     "memory at %s, halting search."),
+		   pulongest (to_read), hex_string (buf_addr + keep));
+	  return -1;
+	}
+      have = keep + to_read;
+    }
+}
@@ -19,6 +19,7 @@
 #define GDBSUPPORT_SEARCH_H
 
 #include "gdbsupport/function-view.h"
+#include "gdbsupport/array-view.h"
 
 /* This is needed by the unit test, so appears here.  */
 #define SEARCH_CHUNK_SIZE 16000
@@ -39,4 +40,30 @@ extern int simple_search_memory
    ULONGEST pattern_len,
    CORE_ADDR *found_addrp);
 
+/* One of the byte sequences searched for by
+   simple_search_memory_multi.  */
+
+using search_pattern = gdb::array_view<const gdb_byte>;
+
+/* Search SEARCH_SPACE_LEN bytes beginning at START_ADDR for the lowest
+   address that is a multiple of ALIGN at which one of PATTERNS starts.
+   All of the patterns are looked for in a single pass over memory,
+   which is read CHUNK_SIZE bytes at a time.
+
+   Return 1 if found, storing the address in *FOUND_ADDRP and the index
+   of the pattern in *FOUND_INDEXP; if several patterns start at that
+   address, the first one in PATTERNS is reported.  Return 0 if not
+   found, and -1 if memory could not be read.  PATTERNS must not be
+   empty, none of them may be empty, and ALIGN must not be zero.  */
+
+extern int simple_search_memory_multi
+  (gdb::function_view<target_read_memory_ftype> read_memory,
+   CORE_ADDR start_addr,
+   ULONGEST search_space_len,
+   gdb::array_view<const search_pattern> patterns,
+   ULONGEST align,
+   CORE_ADDR *found_addrp,
+   size_t *found_indexp,
+   size_t chunk_size = SEARCH_CHUNK_SIZE);
+
 #endif /* GDBSUPPORT_SEARCH_H */
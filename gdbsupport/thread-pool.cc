@@ -18,6 +18,7 @@
    along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
 
 #include "gdbsupport/thread-pool.h"
+#include "gdbsupport/trace-events.h"
 
 #if CXX_STD_THREAD
 
@@ -211,6 +212,7 @@ thread_pool::do_post_task (std::packaged_task<void ()> &&func)
   else
     {
       /* Just execute it now.  */
+      trace_events::scoped_event trace_event ("thread-pool", "task");
       t ();
     }
 }
@@ -221,6 +223,7 @@ thread_pool::thread_function ()
   /* This must be done here, because on macOS one can only set the
      name of the current thread.  */
   set_thread_name ("gdb worker");
+  trace_events::set_current_thread_name ("gdb worker");
 
   /* Ensure that SIGSEGV is delivered to an alternate signal
      stack.  */
@@ -242,6 +245,8 @@ thread_pool::thread_function ()
 
       if (!t.has_value ())
 	break;
+
+      trace_events::scoped_event trace_event ("thread-pool", "task");
       (*t) ();
     }
 }
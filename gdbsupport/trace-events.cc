@@ -0,0 +1,273 @@
+/* Recording of timed events, for timeline views.
+   Copyright (C) 2025 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include "gdbsupport/trace-events.h"
+#include <memory>
+#include <vector>
+#if CXX_STD_THREAD
+#include <mutex>
+#endif
+
+namespace gdb
+{
+
+namespace trace_events
+{
+
+std::atomic<bool> g_enabled;
+
+namespace
+{
+
+/* An event, as recorded.  */
+
+struct event
+{
+  const char *category;
+  const char *name;
+  std::chrono::steady_clock::time_point start;
+  std::chrono::steady_clock::time_point end;
+  std::string detail;
+};
+
+/* The events recorded by one thread.  */
+
+struct thread_buffer
+{
+#if CXX_STD_THREAD
+  /* Only ever contended while the events are being written out.  */
+  std::mutex mutex;
+#endif
+
+  /* The thread's id in the trace, and its name.  */
+  int tid;
+  const char *name = "gdb";
+
+  /* The events, used as a ring buffer once it holds
+     events_per_thread events.  NEXT is then the index of the oldest
+     event, which is the next one to be overwritten.  */
+  std::vector<event> events;
+  size_t next = 0;
+
+  /* The number of events overwritten since tracing started.  */
+  size_t dropped = 0;
+};
+
+} /* anonymous namespace */
+
+/* The buffers of all threads that ever recorded an event or were
+   named.  Buffers are never freed, as the threads that use them,
+   those of the thread pool in particular, normally live as long as
+   GDB does.  */
+
+static std::vector<std::unique_ptr<thread_buffer>> all_buffers;
+#if CXX_STD_THREAD
+static std::mutex all_buffers_mutex;
+#endif
+
+/* The buffer of the current thread, once it has one.  */
+
+static thread_local thread_buffer *current_buffer;
+
+/* When tracing started.  Events that began before are not
+   recorded.  */
+
+static std::chrono::steady_clock::time_point trace_start;
+
+/* Return the buffer of the current thread, creating it if
+   necessary.  */
+
+static thread_buffer *
+get_current_buffer ()
+{
+  if (current_buffer == nullptr)
+    {
+#if CXX_STD_THREAD
+      std::lock_guard<std::mutex> guard (all_buffers_mutex);
+#endif
+      all_buffers.emplace_back (new thread_buffer);
+      current_buffer = all_buffers.back ().get ();
+      current_buffer->tid = all_buffers.size ();
+    }
+
+  return current_buffer;
+}
+
+/* See trace-events.h.  */
+
+void
+record (const char *category, const char *name,
+	std::chrono::steady_clock::time_point start,
+	std::chrono::steady_clock::time_point end,
+	std::string detail)
+{
+  /* The acquire pairs with the release in start, so that TRACE_START
+     is up to date.  */
+  if (!g_enabled.load (std::memory_order_acquire) || start < trace_start)
+    return;
+
+  thread_buffer *buffer = get_current_buffer ();
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (buffer->mutex);
+#endif
+
+  event ev { category, name, start, end, std::move (detail) };
+  if (buffer->events.size () < events_per_thread)
+    buffer->events.push_back (std::move (ev));
+  else
+    {
+      buffer->events[buffer->next] = std::move (ev);
+      buffer->next = (buffer->next + 1) % events_per_thread;
+      buffer->dropped++;
+    }
+}
+
+/* See trace-events.h.  */
+
+void
+set_current_thread_name (const char *name)
+{
+  get_current_buffer ()->name = name;
+}
+
+/* See trace-events.h.  */
+
+void
+start ()
+{
+  g_enabled.store (false);
+
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (all_buffers_mutex);
+#endif
+  for (auto &buffer : all_buffers)
+    {
+#if CXX_STD_THREAD
+      std::lock_guard<std::mutex> buffer_guard (buffer->mutex);
+#endif
+      buffer->events.clear ();
+      buffer->next = 0;
+      buffer->dropped = 0;
+    }
+
+  trace_start = std::chrono::steady_clock::now ();
+  g_enabled.store (true, std::memory_order_release);
+}
+
+/* Append STR to OUT as a JSON string.  */
+
+static void
+append_json_string (std::string &out, const char *str)
+{
+  out += '"';
+  for (; *str != '\0'; ++str)
+    {
+      unsigned char c = *str;
+
+      if (c == '"' || c == '\\')
+	{
+	  out += '\\';
+	  out += c;
+	}
+      else if (c < 0x20)
+	out += string_printf ("\\u%04x", c);
+      else
+	out += c;
+    }
+  out += '"';
+}
+
+/* Return the time between the start of tracing and T, in
+   microseconds, as the trace event format wants it.  */
+
+static std::string
+trace_timestamp (std::chrono::steady_clock::duration t)
+{
+  using namespace std::chrono;
+
+  return string_printf ("%.3f", duration<double, std::micro> (t).count ());
+}
+
+/* See trace-events.h.  */
+
+size_t
+stop (std::string &out, size_t *dropped)
+{
+  g_enabled.store (false);
+
+  size_t count = 0;
+  *dropped = 0;
+
+  out += "{\"traceEvents\":[\n";
+  out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+	 "\"args\":{\"name\":\"gdb\"}}";
+
+#if CXX_STD_THREAD
+  std::lock_guard<std::mutex> guard (all_buffers_mutex);
+#endif
+  for (auto &buffer : all_buffers)
+    {
+#if CXX_STD_THREAD
+      std::lock_guard<std::mutex> buffer_guard (buffer->mutex);
+#endif
+
+      out += string_printf (",\n{\"name\":\"thread_name\",\"ph\":\"M\","
+			    "\"pid\":1,\"tid\":%d,\"args\":{\"name\":",
+			    buffer->tid);
+      append_json_string (out, buffer->name);
+      out += "}}";
+
+      size_t n = buffer->events.size ();
+      for (size_t i = 0; i < n; ++i)
+	{
+	  const event &ev = buffer->events[(buffer->next + i) % n];
+
+	  out += ",\n{\"name\":";
+	  append_json_string (out, ev.name);
+	  out += ",\"cat\":";
+	  append_json_string (out, ev.category);
+	  out += string_printf (",\"ph\":\"X\",\"pid\":1,\"tid\":%d,",
+				buffer->tid);
+	  out += "\"ts\":" + trace_timestamp (ev.start - trace_start);
+	  out += ",\"dur\":" + trace_timestamp (ev.end - ev.start);
+	  if (!ev.detail.empty ())
+	    {
+	      out += ",\"args\":{\"detail\":";
+	      append_json_string (out, ev.detail.c_str ());
+	      out += "}";
+	    }
+	  out += "}";
+	}
+
+      count += n;
+      *dropped += buffer->dropped;
+
+      /* Give the memory back.  */
+      buffer->events = {};
+      buffer->next = 0;
+      buffer->dropped = 0;
+    }
+
+  out += "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+  return count;
+}
+
+} /* namespace trace_events */
+
+} /* namespace gdb */
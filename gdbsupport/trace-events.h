@@ -0,0 +1,132 @@
+/* Recording of timed events, for timeline views.
+   Copyright (C) 2025 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifndef GDBSUPPORT_TRACE_EVENTS_H
+#define GDBSUPPORT_TRACE_EVENTS_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+/* While tracing is on, each thread records the events it goes through
+   -- a named span of time, like a worker task or a remote packet round
+   trip -- in a buffer of its own, so that recording needs no
+   synchronization between threads.  When the buffer of a thread is
+   full, its oldest events are overwritten.  The events of all threads
+   can then be written out in the Chrome trace event format, which
+   tools such as Perfetto show as a timeline.
+
+   When tracing is off, recording an event costs a single relaxed
+   atomic load.  */
+
+namespace gdb
+{
+
+namespace trace_events
+{
+
+/* True while events are being recorded.  Use enabled () instead.  */
+
+extern std::atomic<bool> g_enabled;
+
+/* Return true if events are being recorded.  */
+
+static inline bool
+enabled ()
+{
+  return g_enabled.load (std::memory_order_relaxed);
+}
+
+/* The number of events each thread can hold before overwriting the
+   oldest ones.  */
+
+constexpr size_t events_per_thread = 64 * 1024;
+
+/* Record an event called NAME, in CATEGORY, which lasted from START to
+   END, in the buffer of the current thread.  NAME and CATEGORY must be
+   string literals, or otherwise outlive the recording.  DETAIL, if not
+   empty, is shown as an argument of the event.  Does nothing if
+   tracing is off.  */
+
+extern void record (const char *category, const char *name,
+		    std::chrono::steady_clock::time_point start,
+		    std::chrono::steady_clock::time_point end,
+		    std::string detail = {});
+
+/* Give the current thread the name NAME in the trace.  NAME must be a
+   string literal.  Threads that aren't named are called "gdb".  */
+
+extern void set_current_thread_name (const char *name);
+
+/* Discard the events recorded so far, and start recording.  */
+
+extern void start ();
+
+/* Stop recording, and append the events recorded since start was
+   called to OUT, as a Chrome trace event JSON document.  Return the
+   number of events written, and set *DROPPED to the number of events
+   that were overwritten because a buffer was full.  */
+
+extern size_t stop (std::string &out, size_t *dropped);
+
+/* RAII class recording an event that lasts as long as the object
+   does.  */
+
+class scoped_event
+{
+public:
+  scoped_event (const char *category, const char *name)
+    : m_category (category),
+      m_name (name),
+      m_active (enabled ())
+  {
+    if (m_active)
+      m_start = std::chrono::steady_clock::now ();
+  }
+
+  ~scoped_event ()
+  {
+    if (m_active)
+      record (m_category, m_name, m_start,
+	      std::chrono::steady_clock::now (), std::move (m_detail));
+  }
+
+  DISABLE_COPY_AND_ASSIGN (scoped_event);
+
+  /* Return true if this event is being recorded.  Callers that compute
+     a detail string should only do so in that case.  */
+  bool active () const
+  { return m_active; }
+
+  /* Set the detail shown with this event.  */
+  void set_detail (std::string detail)
+  { m_detail = std::move (detail); }
+
+private:
+  const char *m_category;
+  const char *m_name;
+  bool m_active;
+  std::chrono::steady_clock::time_point m_start;
+  std::string m_detail;
+};
+
+} /* namespace trace_events */
+
+} /* namespace gdb */
+
+#endif /* GDBSUPPORT_TRACE_EVENTS_H */